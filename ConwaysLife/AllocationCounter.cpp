@@ -0,0 +1,88 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+    #include <malloc.h>
+#endif
+
+namespace
+{
+    std::atomic<std::uint64_t> allocationCount(0);
+
+    void* allocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (void* memory = std::malloc(size ? size : 1))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    // Over-aligned types, such as the thread pool's cache-line queues, come
+    // through here rather than through the plain operator new
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        auto bytes = static_cast<std::size_t>(alignment);
+        size = size ? size : 1;
+#if defined(_WIN32)
+        void* memory = _aligned_malloc(size, bytes);
+#else
+        // aligned_alloc takes only whole multiples of the alignment
+        void* memory = std::aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes);
+#endif
+        if (memory)
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void freeAligned(void* memory)
+    {
+#if defined(_WIN32)
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+std::uint64_t getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    freeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(memory);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// Test hook: the program's global operator new, plain and aligned, is replaced
+// by one that counts its calls, so a caller can check that a stretch of code
+// does not allocate.
+// Linked into the unit tests, and into the programs only when built with
+// LIFE_INSTRUMENTATION.
+std::uint64_t getAllocationCount();
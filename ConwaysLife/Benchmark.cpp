@@ -0,0 +1,283 @@
+#include "HashLife.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternAcorn.hpp"
+#include "PatternBlinker.hpp"
+#include "PatternBlock.hpp"
+#include "PatternGlider.hpp"
+#include "PatternGosperGliderGun.hpp"
+#include "PatternSoup.hpp"
+#include "UnboundedLife.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// Steps every pattern on every board size in every engine mode, timing
+// repetitions after a warm-up, and writes the results as JSON so builds can
+// be compared. Usage: LifeBenchmark [--quick] [--filter text] [--json file]
+
+namespace
+{
+    const std::uint64_t SOUP_SEED = 1;
+
+    enum class EngineMode
+    {
+        Dense,
+        Sparse,
+        DenseThreaded,
+        SparseThreaded,
+        HashLife,
+        Unbounded
+    };
+
+    struct Mode
+    {
+        EngineMode mode;
+        const char* name;
+    };
+
+    const Mode MODES[] = {
+        { EngineMode::Dense, "dense" },
+        { EngineMode::Sparse, "sparse" },
+        { EngineMode::DenseThreaded, "dense-threaded" },
+        { EngineMode::SparseThreaded, "sparse-threaded" },
+        { EngineMode::HashLife, "hashlife" },
+        { EngineMode::Unbounded, "unbounded" },
+    };
+
+    struct BoardSize
+    {
+        std::uint32_t size;
+        // Per repetition; smaller boards run more so each one is long enough to time
+        std::uint64_t generations;
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string engine;
+        std::string pattern;
+        std::uint32_t size;
+        std::size_t threadCount;
+        std::uint64_t generations;
+        std::size_t repetitions;
+        double minNs;
+        double medianNs;
+        double maxNs;
+        double cellsPerSecond;
+        std::size_t engineBytes;
+    };
+
+    std::size_t getPeakRss()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+    #if defined(__APPLE__)
+        return static_cast<std::size_t>(usage.ru_maxrss);
+    #else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    #endif
+#endif
+    }
+
+    std::unique_ptr<LifeEngine> makeEngine(EngineMode mode, std::uint32_t size, std::size_t& threadCount)
+    {
+        threadCount = 1;
+        if (mode == EngineMode::HashLife)
+        {
+            return std::make_unique<HashLife>(size, size);
+        }
+        if (mode == EngineMode::Unbounded)
+        {
+            return std::make_unique<UnboundedLife>(size, size);
+        }
+
+        auto sim = std::make_unique<LifeSimulator>(size, size);
+        sim->setSparse(mode == EngineMode::Sparse || mode == EngineMode::SparseThreaded);
+        if (mode == EngineMode::DenseThreaded || mode == EngineMode::SparseThreaded)
+        {
+            sim->setThreadCount(0);
+        }
+        threadCount = sim->getThreadCount();
+        return sim;
+    }
+
+    std::size_t getEngineBytes(const LifeEngine& engine)
+    {
+        if (auto sim = dynamic_cast<const LifeSimulator*>(&engine))
+        {
+            return sim->getMemoryUsage();
+        }
+        if (auto hashLife = dynamic_cast<const HashLife*>(&engine))
+        {
+            return hashLife->getMemoryUsage();
+        }
+        if (auto plane = dynamic_cast<const UnboundedLife*>(&engine))
+        {
+            return plane->getMemoryUsage();
+        }
+        return 0;
+    }
+
+    void writeJson(const std::string& path, const std::vector<Result>& results)
+    {
+        std::ofstream out(path);
+        out << "{\n  \"unit\": \"ns/generation\",\n  \"peakRssBytes\": " << getPeakRss() << ",\n  \"cases\": [";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            out << (i ? "," : "") << "\n    {"
+                << "\"name\": \"" << result.name << "\", "
+                << "\"engine\": \"" << result.engine << "\", "
+                << "\"pattern\": \"" << result.pattern << "\", "
+                << "\"size\": " << result.size << ", "
+                << "\"threads\": " << result.threadCount << ", "
+                << "\"generations\": " << result.generations << ", "
+                << "\"repetitions\": " << result.repetitions << ", "
+                << "\"minNs\": " << result.minNs << ", "
+                << "\"medianNs\": " << result.medianNs << ", "
+                << "\"maxNs\": " << result.maxNs << ", "
+                << "\"cellsPerSecond\": " << result.cellsPerSecond << ", "
+                << "\"engineBytes\": " << result.engineBytes << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    std::string filter;
+    std::string jsonPath = "benchmark.json";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quick")
+        {
+            quick = true;
+        }
+        else if (arg == "--filter" && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (arg == "--json" && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--filter text] [--json benchmark.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<BoardSize> sizes = { { 256, 2000 }, { 1024, 200 }, { 4096, 20 } };
+    std::size_t repetitions = 5;
+    if (quick)
+    {
+        sizes.pop_back();
+        repetitions = 2;
+    }
+
+    std::vector<Result> results;
+    for (const BoardSize& size : sizes)
+    {
+        // Made once per size, so every engine starts from the same soup
+        PatternSoup soup(size.size, size.size, SOUP_SEED);
+        PatternAcorn acorn;
+        PatternGosperGliderGun gun;
+        PatternGlider glider;
+        PatternBlinker blinker;
+        PatternBlock block;
+        const std::pair<const char*, const Pattern*> patterns[] = {
+            { "acorn", &acorn }, { "gun", &gun }, { "glider", &glider }, { "blinker", &blinker }, { "block", &block }, { "soup", &soup },
+        };
+
+        for (const auto& pattern : patterns)
+        {
+            for (const Mode& mode : MODES)
+            {
+                // HashLife has no torus to fill, and a soup only grows a huge unbounded tree
+                if (mode.mode == EngineMode::HashLife && pattern.second == &soup)
+                {
+                    continue;
+                }
+
+                std::string name = std::string(pattern.first) + "/" + std::to_string(size.size) + "/" + mode.name;
+                if (name.find(filter) == std::string::npos)
+                {
+                    continue;
+                }
+
+                std::size_t threadCount = 1;
+                std::unique_ptr<LifeEngine> engine = makeEngine(mode.mode, size.size, threadCount);
+                engine->insertPattern(*pattern.second, (size.size - pattern.second->getSizeX()) / 2, (size.size - pattern.second->getSizeY()) / 2);
+
+                // One untimed repetition warms caches, pools and memoized results
+                engine->advance(size.generations);
+                std::vector<double> nsPerGeneration;
+                for (std::size_t repetition = 0; repetition < repetitions; ++repetition)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    engine->advance(size.generations);
+                    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                    nsPerGeneration.push_back(ns / static_cast<double>(size.generations));
+                }
+                std::sort(nsPerGeneration.begin(), nsPerGeneration.end());
+
+                Result result;
+                result.name = name;
+                result.engine = mode.name;
+                result.pattern = pattern.first;
+                result.size = size.size;
+                result.threadCount = threadCount;
+                result.generations = size.generations;
+                result.repetitions = repetitions;
+                result.minNs = nsPerGeneration.front();
+                // An even count, as --quick runs, has no middle sample, so the two middle ones are averaged
+                std::size_t middle = nsPerGeneration.size() / 2;
+                result.medianNs = nsPerGeneration.size() % 2 ? nsPerGeneration[middle] : (nsPerGeneration[middle - 1] + nsPerGeneration[middle]) / 2;
+                result.maxNs = nsPerGeneration.back();
+                result.cellsPerSecond = static_cast<double>(size.size) * size.size / result.medianNs * 1e9;
+                result.engineBytes = getEngineBytes(*engine);
+                results.push_back(result);
+
+                char line[160];
+                std::snprintf(line, sizeof(line), "%-32s %12.0f ns/gen %10.3g cells/s %8.1f MB engine", name.c_str(), result.medianNs, result.cellsPerSecond,
+                              static_cast<double>(result.engineBytes) / (1024 * 1024));
+                std::cout << line << std::endl;
+            }
+        }
+    }
+
+    // The high-water mark is the whole run's, not any one case's
+    std::cout << "Peak RSS " << getPeakRss() / (1024 * 1024) << " MB" << std::endl;
+    writeJson(jsonPath, results);
+    std::cout << results.size() << " cases written to " << jsonPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "BlockPool.hpp"
+
+#include <algorithm>
+#include <functional>
+
+BlockPool::BlockPool(std::size_t blockWords, std::size_t blocksPerChunk) :
+    blockWords(std::max<std::size_t>(blockWords, 1)),
+    blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1))
+{
+}
+
+std::uint64_t* BlockPool::allocate()
+{
+    if (freeBlocks.empty())
+    {
+        // Handed out from the back, so the chunk's blocks go in from the end
+        chunks.emplace_back(new std::uint64_t[blockWords * blocksPerChunk]);
+        std::uint64_t* chunk = chunks.back().get();
+        for (std::size_t i = blocksPerChunk; i-- > 0;)
+        {
+            freeBlocks.push_back(chunk + i * blockWords);
+        }
+    }
+
+    std::uint64_t* block = freeBlocks.back();
+    freeBlocks.pop_back();
+    return block;
+}
+
+void BlockPool::release(std::uint64_t* block)
+{
+    freeBlocks.push_back(block);
+}
+
+void BlockPool::trim()
+{
+    // Count the free blocks of each chunk, finding their chunks by address
+    const std::less<const std::uint64_t*> before;
+    std::sort(chunks.begin(), chunks.end(), [&before](const std::unique_ptr<std::uint64_t[]>& a, const std::unique_ptr<std::uint64_t[]>& b) {
+        return before(a.get(), b.get());
+    });
+    auto chunkOf = [&](const std::uint64_t* block) {
+        auto after = std::upper_bound(chunks.begin(), chunks.end(), block, [&before](const std::uint64_t* b, const std::unique_ptr<std::uint64_t[]>& chunk) {
+            return before(b, chunk.get());
+        });
+        return static_cast<std::size_t>(after - chunks.begin()) - 1;
+    };
+
+    std::vector<std::size_t> freeCounts(chunks.size(), 0);
+    for (const std::uint64_t* block : freeBlocks)
+    {
+        ++freeCounts[chunkOf(block)];
+    }
+
+    auto unused = [&](const std::uint64_t* block) { return freeCounts[chunkOf(block)] == blocksPerChunk; };
+    freeBlocks.erase(std::remove_if(freeBlocks.begin(), freeBlocks.end(), unused), freeBlocks.end());
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+    {
+        if (freeCounts[i] == blocksPerChunk)
+        {
+            chunks[i].reset();
+        }
+    }
+    chunks.erase(std::remove(chunks.begin(), chunks.end(), nullptr), chunks.end());
+}
+
+std::size_t BlockPool::getUsedCount() const
+{
+    return chunks.size() * blocksPerChunk - freeBlocks.size();
+}
+
+std::size_t BlockPool::getFreeCount() const
+{
+    return freeBlocks.size();
+}
+
+std::size_t BlockPool::getMemoryUsage() const
+{
+    return chunks.size() * blocksPerChunk * blockWords * sizeof(std::uint64_t) + chunks.capacity() * sizeof(chunks[0]) +
+           freeBlocks.capacity() * sizeof(std::uint64_t*);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Hands out blocks of a fixed number of words, carved from chunks of many
+// blocks and recycled through a free list, so blocks that come and go every
+// generation cost no trip to the heap once the pool has grown to fit them
+class BlockPool
+{
+  public:
+    BlockPool(std::size_t blockWords, std::size_t blocksPerChunk);
+
+    // Uninitialized, and valid until released or the pool is destroyed
+    std::uint64_t* allocate();
+    void release(std::uint64_t* block);
+
+    // Returns chunks in which every block is free to the heap
+    void trim();
+
+    std::size_t getUsedCount() const;
+    std::size_t getFreeCount() const;
+    std::size_t getMemoryUsage() const;
+
+  private:
+    std::size_t blockWords;
+    std::size_t blocksPerChunk;
+    std::vector<std::unique_ptr<std::uint64_t[]>> chunks;
+    std::vector<std::uint64_t*> freeBlocks;
+};
@@ -0,0 +1,91 @@
+#include "CheckpointWriter.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+CheckpointWriter::CheckpointWriter(const std::string& path, bool compress) :
+    path(path),
+    compress(compress),
+    writer(&CheckpointWriter::writerLoop, this)
+{
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWriter.notify_one();
+    writer.join();
+}
+
+void CheckpointWriter::submit(LifeSnapshot snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.reset();
+        pending = std::move(snapshot);
+    }
+    wakeWriter.notify_one();
+}
+
+void CheckpointWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    wakeSubmitter.wait(lock, [this]() { return !pending && !writing; });
+    finished.reset();
+}
+
+std::uint64_t CheckpointWriter::getSavedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return savedCount;
+}
+
+std::string CheckpointWriter::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+void CheckpointWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeWriter.wait(lock, [this]() { return stopping || pending; });
+        if (!pending)
+        {
+            return;
+        }
+
+        // Saved without the lock, so the simulation can submit the next one meanwhile
+        LifeSnapshot snapshot = std::move(*pending);
+        pending.reset();
+        writing = true;
+        lock.unlock();
+        std::string error;
+        try
+        {
+            snapshot.save(path, compress);
+        }
+        catch (const std::runtime_error& saveError)
+        {
+            error = saveError.what();
+        }
+        lock.lock();
+
+        if (error.empty())
+        {
+            ++savedCount;
+        }
+        else
+        {
+            lastError = error;
+        }
+        finished = std::move(snapshot);
+        writing = false;
+        wakeSubmitter.notify_all();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "LifeSnapshot.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Saves snapshots to one file on a thread of its own, so the simulation
+// never waits on the disk. A snapshot submitted while another is being
+// written waits its turn, replacing any older one still waiting. Written
+// snapshots are handed back and dropped by the next submit() or flush(), so
+// the board they share is only ever let go of on the simulation's thread.
+class CheckpointWriter
+{
+  public:
+    CheckpointWriter(const std::string& path, bool compress);
+    // Writes the snapshot still waiting, if any, before returning
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    void submit(LifeSnapshot snapshot);
+    // Waits until every snapshot submitted so far has been written or failed
+    void flush();
+
+    // Snapshots written so far, and the error the last failed one gave, if any
+    std::uint64_t getSavedCount() const;
+    std::string getLastError() const;
+
+  private:
+    std::string path;
+    bool compress;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::condition_variable wakeSubmitter;
+    std::optional<LifeSnapshot> pending;
+    // The last snapshot written, until the submitting thread drops it. The
+    // simulator only copies a board some snapshot still holds, and reads
+    // that from the board's reference count, which does not order anything
+    // against a reference dropped on another thread.
+    std::optional<LifeSnapshot> finished;
+    bool writing = false;
+    std::uint64_t savedCount = 0;
+    std::string lastError;
+    bool stopping = false;
+    std::thread writer;
+
+    void writerLoop();
+};
@@ -0,0 +1,96 @@
+#include "CycleDetector.hpp"
+
+#include <algorithm>
+
+CycleDetector::CycleDetector(std::uint64_t window) :
+    window(window)
+{
+    if (!window)
+    {
+        return;
+    }
+
+    // Sized first, so a window too large to hold fails before the table's
+    // capacity can overflow
+    recent.resize(static_cast<std::size_t>(window));
+
+    // The table holds at most two windows of hashes between rebuilds; at
+    // most half full, probes stay short
+    std::size_t capacity = 1;
+    while (capacity < 4 * window)
+    {
+        capacity *= 2;
+    }
+    table.resize(capacity);
+    reset();
+}
+
+std::uint64_t CycleDetector::getWindow() const
+{
+    return window;
+}
+
+std::size_t CycleDetector::getMemoryUsage() const
+{
+    return (recent.capacity() + table.capacity()) * sizeof(Entry);
+}
+
+void CycleDetector::reset()
+{
+    std::fill(recent.begin(), recent.end(), Entry{ 0, UNUSED });
+    std::fill(table.begin(), table.end(), Entry{ 0, UNUSED });
+    recordedSinceRebuild = 0;
+}
+
+std::uint64_t CycleDetector::record(std::uint64_t hash, std::uint64_t generation)
+{
+    if (!window)
+    {
+        return 0;
+    }
+
+    // One entry per hash, holding the last generation it was seen in
+    Entry* entry = find(hash);
+    std::uint64_t period = 0;
+    if (entry->generation != UNUSED && generation - entry->generation <= window)
+    {
+        period = generation - entry->generation;
+    }
+    *entry = { hash, generation };
+    recent[generation % window] = { hash, generation };
+
+    if (++recordedSinceRebuild >= window)
+    {
+        rebuild(generation);
+    }
+    return period;
+}
+
+CycleDetector::Entry* CycleDetector::find(std::uint64_t hash)
+{
+    // Board hashes are well mixed already, so their low bits pick the slot
+    std::size_t mask = table.size() - 1;
+    std::size_t slot = static_cast<std::size_t>(hash) & mask;
+    while (table[slot].generation != UNUSED && table[slot].hash != hash)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return &table[slot];
+}
+
+void CycleDetector::rebuild(std::uint64_t generation)
+{
+    std::fill(table.begin(), table.end(), Entry{ 0, UNUSED });
+    for (const Entry& entry : recent)
+    {
+        if (entry.generation != UNUSED && generation - entry.generation < window)
+        {
+            Entry* slot = find(entry.hash);
+            if (slot->generation == UNUSED || slot->generation < entry.generation)
+            {
+                *slot = entry;
+            }
+        }
+    }
+    recordedSinceRebuild = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Spots a board that repeats one of the last few generations, from the
+// board hashes alone. Hashes live in a ring of the last window generations
+// and in an open-addressed table over it, rebuilt from the ring every
+// window generations so stale entries never pile up. Recording a hash never
+// allocates.
+class CycleDetector
+{
+  public:
+    // Remembers the last window generations; a window of 0 remembers none.
+    // Takes 80 to 144 bytes per generation of window, all up front, and
+    // throws std::bad_alloc or std::length_error when that is too much.
+    explicit CycleDetector(std::uint64_t window = 0);
+
+    std::uint64_t getWindow() const;
+    std::size_t getMemoryUsage() const;
+    // Forgets every hash recorded so far
+    void reset();
+
+    // Records the board hash of a generation. Returns how many generations
+    // back, within the window, the same hash was last seen, or 0 if it was not.
+    std::uint64_t record(std::uint64_t hash, std::uint64_t generation);
+
+  private:
+    // An entry with generation UNUSED holds no hash
+    struct Entry
+    {
+        std::uint64_t hash;
+        std::uint64_t generation;
+    };
+
+    static constexpr std::uint64_t UNUSED = ~std::uint64_t(0);
+
+    std::uint64_t window;
+    // Generation g is at recent[g % window]
+    std::vector<Entry> recent;
+    std::vector<Entry> table;
+    std::uint64_t recordedSinceRebuild = 0;
+
+    Entry* find(std::uint64_t hash);
+    void rebuild(std::uint64_t generation);
+};
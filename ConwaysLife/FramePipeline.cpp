@@ -0,0 +1,110 @@
+#include "FramePipeline.hpp"
+
+#include <algorithm>
+
+FramePipeline::FramePipeline(std::size_t slotCount) :
+    slots(std::max<std::size_t>(slotCount, 3))
+{
+}
+
+LifeFrame& FramePipeline::beginWrite()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // A free slot, or else the oldest frame the consumer has not got to
+    std::size_t chosen = slots.size();
+    for (std::size_t slot = 0; slot < slots.size(); ++slot)
+    {
+        if (slots[slot].state == SlotState::Free)
+        {
+            chosen = slot;
+            break;
+        }
+        if (slots[slot].state == SlotState::Ready && (chosen == slots.size() || slots[slot].sequence < slots[chosen].sequence))
+        {
+            chosen = slot;
+        }
+    }
+    if (slots[chosen].state == SlotState::Ready)
+    {
+        ++dropped;
+    }
+
+    slots[chosen].state = SlotState::Writing;
+    writing = chosen;
+    return slots[chosen].frame;
+}
+
+void FramePipeline::publish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[writing].state = SlotState::Ready;
+        slots[writing].sequence = ++published;
+    }
+    frameReady.notify_one();
+}
+
+void FramePipeline::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    frameReady.notify_one();
+}
+
+const LifeFrame* FramePipeline::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // The frame handed out last time is done with
+    for (Slot& slot : slots)
+    {
+        if (slot.state == SlotState::Reading)
+        {
+            slot.state = SlotState::Free;
+        }
+    }
+
+    auto hasReady = [this]() {
+        return std::any_of(slots.begin(), slots.end(), [](const Slot& slot) { return slot.state == SlotState::Ready; });
+    };
+    frameReady.wait(lock, [&]() { return closed || hasReady(); });
+
+    Slot* newest = nullptr;
+    for (Slot& slot : slots)
+    {
+        if (slot.state == SlotState::Ready && (!newest || slot.sequence > newest->sequence))
+        {
+            newest = &slot;
+        }
+    }
+    if (!newest)
+    {
+        return nullptr;
+    }
+
+    for (Slot& slot : slots)
+    {
+        if (slot.state == SlotState::Ready && &slot != newest)
+        {
+            slot.state = SlotState::Free;
+            ++dropped;
+        }
+    }
+    newest->state = SlotState::Reading;
+    return &newest->frame;
+}
+
+std::uint64_t FramePipeline::getPublishedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return published;
+}
+
+std::uint64_t FramePipeline::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
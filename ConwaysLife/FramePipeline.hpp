@@ -0,0 +1,65 @@
+#pragma once
+
+#include "LifeFrame.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Hands generations from a simulation thread to a render thread through a
+// fixed number of frame slots. Neither side waits for the other: the
+// producer fills a free slot, or else overwrites the oldest frame not yet
+// read, and the consumer always takes the newest frame and drops the older
+// ones. Only slot bookkeeping happens under the lock; frames are copied in
+// and read outside it, and once the slots are sized nothing allocates.
+class FramePipeline
+{
+  public:
+    // At least three slots: one being written, one being read, one ready
+    explicit FramePipeline(std::size_t slotCount = 4);
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Producer: returns a slot to capture the next generation into, then
+    // hands it over with publish()
+    LifeFrame& beginWrite();
+    void publish();
+    // Producer: no more frames will come
+    void close();
+
+    // Consumer: returns the newest published frame, waiting for one if none
+    // came since the last call, or nullptr once the pipeline is closed and
+    // drained. The frame stays valid until the next call.
+    const LifeFrame* acquire();
+
+    // Frames published, and frames overwritten or skipped before being read
+    std::uint64_t getPublishedCount() const;
+    std::uint64_t getDroppedCount() const;
+
+  private:
+    enum class SlotState
+    {
+        Free,
+        Writing,
+        Ready,
+        Reading
+    };
+
+    struct Slot
+    {
+        LifeFrame frame;
+        SlotState state = SlotState::Free;
+        // Order in which ready frames were published
+        std::uint64_t sequence = 0;
+    };
+
+    std::vector<Slot> slots;
+    mutable std::mutex mutex;
+    std::condition_variable frameReady;
+    std::size_t writing = 0;
+    std::uint64_t published = 0;
+    std::uint64_t dropped = 0;
+    bool closed = false;
+};
@@ -0,0 +1,561 @@
+#include "HashLife.hpp"
+
+#include "LifeKernel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    std::size_t hashChildren(std::uint32_t nw, std::uint32_t ne, std::uint32_t sw, std::uint32_t se)
+    {
+        std::uint64_t h = (static_cast<std::uint64_t>(nw) << 32 | ne) * 0x9E3779B97F4A7C15ull;
+        h ^= (static_cast<std::uint64_t>(sw) << 32 | se) * 0xC2B2AE3D27D4EB4Full;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+}
+
+HashLife::HashLife(std::uint32_t sizeX, std::uint32_t sizeY) :
+    sizeX(sizeX),
+    sizeY(sizeY),
+    birthMask(rule.getBirthMask()),
+    survivalMask(rule.getSurvivalMask())
+{
+    nodes.push_back({ NO_NODE, NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, 0, 0 });
+    nodes.push_back({ NO_NODE, NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, 0, 1 });
+    emptyNodes.push_back(DEAD);
+    rebuildTable(1024);
+
+    root = getEmpty(3);
+}
+
+void HashLife::insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY)
+{
+    if (!sizeX || !sizeY)
+    {
+        return;
+    }
+
+    startX = std::min(startX, sizeX - 1);
+    startY = std::min(startY, sizeY - 1);
+    std::uint32_t endX = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(startX) + pattern.getSizeX(), sizeX));
+    std::uint32_t endY = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(startY) + pattern.getSizeY(), sizeY));
+
+    std::vector<std::uint64_t> row(wordsForCells(pattern.getSizeX()));
+    for (auto y = startY; y < endY; ++y)
+    {
+        pattern.getRow(y - startY, row.data());
+        for (auto x = startX; x < endX; ++x)
+        {
+            std::uint32_t bit = x - startX;
+            setCell(x, y, (row[bit / CELLS_PER_WORD] >> (bit % CELLS_PER_WORD)) & 1);
+        }
+    }
+}
+
+void HashLife::update()
+{
+    advance(1);
+}
+
+void HashLife::advance(std::uint64_t generations)
+{
+    for (std::uint8_t step = 0; step < 64; ++step)
+    {
+        if ((generations >> step) & 1)
+        {
+            stepPowerOfTwo(step);
+        }
+    }
+}
+
+std::uint64_t HashLife::step(std::uint64_t generations, const StepControl& control)
+{
+    std::uint64_t done = 0;
+    while (done < generations && !control.isCancelled())
+    {
+        std::uint64_t chunk = control.getChunk(done, generations);
+        for (std::uint8_t jump = 0; jump < 64 && !control.isCancelled(); ++jump)
+        {
+            if ((chunk >> jump) & 1)
+            {
+                stepPowerOfTwo(jump);
+                done += std::uint64_t(1) << jump;
+            }
+        }
+        control.report(done);
+    }
+    return done;
+}
+
+std::uint64_t HashLife::getGeneration() const
+{
+    return generation;
+}
+
+std::uint32_t HashLife::getSizeX() const
+{
+    return sizeX;
+}
+
+std::uint32_t HashLife::getSizeY() const
+{
+    return sizeY;
+}
+
+bool HashLife::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    std::int64_t offsetX = x - originX;
+    std::int64_t offsetY = y - originY;
+    std::uint8_t level = nodes[root].level;
+    if (offsetX < 0 || offsetY < 0 || offsetX >> level || offsetY >> level)
+    {
+        return false;
+    }
+
+    // Descend to the cell, stopping early in empty space
+    std::uint32_t node = root;
+    while (level > 0 && nodes[node].population)
+    {
+        --level;
+        bool east = (offsetX >> level) & 1;
+        bool south = (offsetY >> level) & 1;
+        const Node& n = nodes[node];
+        node = south ? (east ? n.se : n.sw) : (east ? n.ne : n.nw);
+    }
+
+    return node == ALIVE;
+}
+
+std::uint64_t HashLife::getPopulation() const
+{
+    return nodes[root].population;
+}
+
+void HashLife::setMemoryLimit(std::size_t bytes)
+{
+    memoryLimit = bytes;
+    collectionThreshold = bytes;
+}
+
+void HashLife::setRule(const LifeRule& rule)
+{
+    if (rule.getRadius() != 1 || rule.getStateCount() != 2 || rule.isBorn(0))
+    {
+        throw std::invalid_argument("HashLife cannot run rule " + rule.toString());
+    }
+
+    this->rule = rule;
+    birthMask = rule.getBirthMask();
+    survivalMask = rule.getSurvivalMask();
+
+    // Every memoized future was worked out under the old rule
+    for (auto& node : nodes)
+    {
+        node.result = NO_NODE;
+    }
+}
+
+const LifeRule& HashLife::getRule() const
+{
+    return rule;
+}
+
+std::size_t HashLife::getMemoryUsage() const
+{
+    return nodes.capacity() * sizeof(Node) + table.capacity() * sizeof(std::uint32_t) + emptyNodes.capacity() * sizeof(std::uint32_t);
+}
+
+std::uint64_t HashLife::getCollectionCount() const
+{
+    return collectionCount;
+}
+
+std::uint32_t HashLife::join(std::uint32_t nw, std::uint32_t ne, std::uint32_t sw, std::uint32_t se)
+{
+    std::size_t mask = table.size() - 1;
+    std::size_t slot = hashChildren(nw, ne, sw, se) & mask;
+    while (table[slot] != NO_NODE)
+    {
+        const Node& n = nodes[table[slot]];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se)
+        {
+            return table[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // Growing the node array past the limit abandons the jump. Until it is
+    // unwound, joins hand back an empty node of the right level instead, and
+    // successor() memoizes nothing built from them.
+    std::uint8_t level = nodes[nw].level + 1;
+    if (budgeted && !overBudget && nodes.size() == nodes.capacity() && getMemoryUsage() + nodes.capacity() * sizeof(Node) > collectionThreshold)
+    {
+        overBudget = true;
+    }
+    if (overBudget && level < emptyNodes.size())
+    {
+        return emptyNodes[level];
+    }
+
+    auto index = static_cast<std::uint32_t>(nodes.size());
+    std::uint64_t population = nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population;
+    nodes.push_back({ nw, ne, sw, se, NO_NODE, level, 0, population });
+    table[slot] = index;
+
+    // Keep the table at most half full
+    if (++tableCount * 2 > table.size())
+    {
+        rebuildTable(table.size() * 2);
+    }
+
+    return index;
+}
+
+std::uint32_t HashLife::getEmpty(std::uint8_t level)
+{
+    while (emptyNodes.size() <= level)
+    {
+        std::uint32_t smaller = emptyNodes.back();
+        emptyNodes.push_back(join(smaller, smaller, smaller, smaller));
+    }
+
+    return emptyNodes[level];
+}
+
+void HashLife::expandRoot()
+{
+    // Same content, one level up, centered in the new square
+    Node n = nodes[root];
+    std::uint32_t empty = getEmpty(n.level - 1);
+    std::uint32_t nw = join(empty, empty, empty, n.nw);
+    std::uint32_t ne = join(empty, empty, n.ne, empty);
+    std::uint32_t sw = join(empty, n.sw, empty, empty);
+    std::uint32_t se = join(n.se, empty, empty, empty);
+
+    root = join(nw, ne, sw, se);
+    originX -= std::int64_t(1) << (n.level - 1);
+    originY -= std::int64_t(1) << (n.level - 1);
+}
+
+std::uint32_t HashLife::successor(std::uint32_t node, std::uint8_t step)
+{
+    Node n = nodes[node];
+    step = std::min<std::uint8_t>(step, n.level - 2);
+
+    if (!n.population || overBudget)
+    {
+        return getEmpty(n.level - 1);
+    }
+    if (n.result != NO_NODE && n.resultStep == step)
+    {
+        return n.result;
+    }
+
+    std::uint32_t result;
+    if (n.level == 2)
+    {
+        result = stepLeaf(node);
+    }
+    else
+    {
+        Node nw = nodes[n.nw];
+        Node ne = nodes[n.ne];
+        Node sw = nodes[n.sw];
+        Node se = nodes[n.se];
+
+        // The nine overlapping squares of half the size, each advanced
+        std::uint32_t r00 = successor(n.nw, step);
+        std::uint32_t r01 = successor(join(nw.ne, ne.nw, nw.se, ne.sw), step);
+        std::uint32_t r02 = successor(n.ne, step);
+        std::uint32_t r10 = successor(join(nw.sw, nw.se, sw.nw, sw.ne), step);
+        std::uint32_t r11 = successor(join(nw.se, ne.sw, sw.ne, se.nw), step);
+        std::uint32_t r12 = successor(join(ne.sw, ne.se, se.nw, se.ne), step);
+        std::uint32_t r20 = successor(n.sw, step);
+        std::uint32_t r21 = successor(join(sw.ne, se.nw, sw.se, se.sw), step);
+        std::uint32_t r22 = successor(n.se, step);
+
+        if (step == n.level - 2)
+        {
+            // Advance the four quadrants they form by the same again
+            result = join(successor(join(r00, r01, r10, r11), step),
+                          successor(join(r01, r02, r11, r12), step),
+                          successor(join(r10, r11, r20, r21), step),
+                          successor(join(r11, r12, r21, r22), step));
+        }
+        else
+        {
+            // Already far enough: just take the centers of those quadrants
+            auto center = [this](std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) {
+                return join(nodes[a].se, nodes[b].sw, nodes[c].ne, nodes[d].nw);
+            };
+            result = join(center(r00, r01, r10, r11),
+                          center(r01, r02, r11, r12),
+                          center(r10, r11, r20, r21),
+                          center(r11, r12, r21, r22));
+        }
+    }
+
+    if (!overBudget)
+    {
+        nodes[node].result = result;
+        nodes[node].resultStep = step;
+    }
+    return result;
+}
+
+std::uint32_t HashLife::stepLeaf(std::uint32_t node)
+{
+    // Unpack the 4x4 square, then apply the rule to its center 2x2
+    bool cells[4][4];
+    const Node& n = nodes[node];
+    std::uint32_t quadrants[4] = { n.nw, n.ne, n.sw, n.se };
+    for (std::size_t q = 0; q < 4; ++q)
+    {
+        const Node& quadrant = nodes[quadrants[q]];
+        std::size_t x = (q % 2) * 2;
+        std::size_t y = (q / 2) * 2;
+        cells[y][x] = quadrant.nw == ALIVE;
+        cells[y][x + 1] = quadrant.ne == ALIVE;
+        cells[y + 1][x] = quadrant.sw == ALIVE;
+        cells[y + 1][x + 1] = quadrant.se == ALIVE;
+    }
+
+    std::uint32_t next[2][2];
+    for (std::size_t y = 1; y < 3; ++y)
+    {
+        for (std::size_t x = 1; x < 3; ++x)
+        {
+            int count = 0;
+            for (std::size_t ny = y - 1; ny <= y + 1; ++ny)
+            {
+                for (std::size_t nx = x - 1; nx <= x + 1; ++nx)
+                {
+                    count += cells[ny][nx];
+                }
+            }
+            count -= cells[y][x];
+            std::uint16_t mask = cells[y][x] ? survivalMask : birthMask;
+            next[y - 1][x - 1] = ((mask >> count) & 1) ? ALIVE : DEAD;
+        }
+    }
+
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+std::uint32_t HashLife::setCell(std::uint32_t node, std::uint64_t x, std::uint64_t y, bool alive)
+{
+    Node n = nodes[node];
+    if (n.level == 0)
+    {
+        return alive ? ALIVE : DEAD;
+    }
+
+    std::uint8_t half = n.level - 1;
+    bool east = (x >> half) & 1;
+    bool south = (y >> half) & 1;
+    std::uint64_t mask = (std::uint64_t(1) << half) - 1;
+    std::uint32_t& child = south ? (east ? n.se : n.sw) : (east ? n.ne : n.nw);
+    child = setCell(child, x & mask, y & mask, alive);
+
+    return join(n.nw, n.ne, n.sw, n.se);
+}
+
+void HashLife::setCell(std::int64_t x, std::int64_t y, bool alive)
+{
+    // Grow the universe until it holds the cell
+    while (x < originX || y < originY || (x - originX) >> nodes[root].level || (y - originY) >> nodes[root].level)
+    {
+        expandRoot();
+    }
+
+    root = setCell(root, x - originX, y - originY, alive);
+}
+
+bool HashLife::isPadded(std::uint32_t node) const
+{
+    // True when every live cell lies in the center quarter of the node
+    const Node& n = nodes[node];
+    const Node& nw = nodes[n.nw];
+    const Node& ne = nodes[n.ne];
+    const Node& sw = nodes[n.sw];
+    const Node& se = nodes[n.se];
+    std::uint64_t center = nodes[nw.se].population + nodes[ne.sw].population + nodes[sw.ne].population + nodes[se.nw].population;
+
+    return center == n.population;
+}
+
+void HashLife::stepPowerOfTwo(std::uint8_t step)
+{
+    if (memoryLimit && getMemoryUsage() > collectionThreshold)
+    {
+        collectGarbage();
+    }
+
+    // A successor only covers the center half of a node, and cells move at
+    // most 2^step, so pad until the pattern sits in the center quarter and
+    // once more for the distance travelled
+    std::uint32_t unpadded = root;
+    std::int64_t unpaddedX = originX;
+    std::int64_t unpaddedY = originY;
+    while (nodes[root].level < step + 2 || !isPadded(root))
+    {
+        if (nodes[root].level >= MAX_LEVEL)
+        {
+            break;
+        }
+        expandRoot();
+    }
+    if (nodes[root].level >= MAX_LEVEL)
+    {
+        root = unpadded;
+        originX = unpaddedX;
+        originY = unpaddedY;
+        throw std::overflow_error("HashLife cannot jump 2^" + std::to_string(step) + " generations from here");
+    }
+    expandRoot();
+
+    std::uint8_t level = nodes[root].level;
+    budgeted = memoryLimit != 0;
+    std::uint32_t next = successor(root, step);
+    budgeted = false;
+    if (overBudget)
+    {
+        overBudget = false;
+        if (step > 0)
+        {
+            // Each half pads for itself, so the padding is dropped rather than
+            // piling up a level with every split
+            root = unpadded;
+            originX = unpaddedX;
+            originY = unpaddedY;
+            collectGarbage();
+            stepPowerOfTwo(step - 1);
+            stepPowerOfTwo(step - 1);
+            return;
+        }
+
+        // A single generation cannot be split, so it runs over if it must
+        collectGarbage();
+        next = successor(root, step);
+    }
+
+    root = next;
+    originX += std::int64_t(1) << (level - 2);
+    originY += std::int64_t(1) << (level - 2);
+
+    generation += std::uint64_t(1) << step;
+}
+
+void HashLife::collectGarbage()
+{
+    // Mark the nodes the universe still uses
+    std::vector<bool> reachable(nodes.size(), false);
+    std::vector<std::uint32_t> stack(emptyNodes.begin(), emptyNodes.end());
+    stack.push_back(root);
+    stack.push_back(ALIVE);
+    while (!stack.empty())
+    {
+        std::uint32_t node = stack.back();
+        stack.pop_back();
+        if (reachable[node])
+        {
+            continue;
+        }
+
+        reachable[node] = true;
+        if (nodes[node].level > 0)
+        {
+            stack.push_back(nodes[node].nw);
+            stack.push_back(nodes[node].ne);
+            stack.push_back(nodes[node].sw);
+            stack.push_back(nodes[node].se);
+        }
+    }
+
+    // Children are always created before their parents, so compacting in
+    // index order remaps every child before it is needed. The node array is
+    // reserved up to the limit, so it next grows when the limit is reached.
+    std::vector<std::uint32_t> remap(nodes.size(), NO_NODE);
+    std::vector<Node> kept;
+    kept.reserve(std::max<std::size_t>(std::count(reachable.begin(), reachable.end(), true), getNodeBudget()));
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (!reachable[i])
+        {
+            continue;
+        }
+
+        Node n = nodes[i];
+        if (n.level > 0)
+        {
+            n.nw = remap[n.nw];
+            n.ne = remap[n.ne];
+            n.sw = remap[n.sw];
+            n.se = remap[n.se];
+        }
+        remap[i] = static_cast<std::uint32_t>(kept.size());
+        kept.push_back(n);
+    }
+
+    // A result may be newer than its node, so results are remapped once every
+    // node has its new index. Those whose target was evicted are dropped.
+    for (auto& n : kept)
+    {
+        if (n.result != NO_NODE)
+        {
+            n.result = remap[n.result];
+        }
+    }
+
+    nodes.swap(kept);
+    root = remap[root];
+    for (auto& empty : emptyNodes)
+    {
+        empty = remap[empty];
+    }
+
+    std::size_t capacity = 1024;
+    while (capacity < nodes.size() * 2)
+    {
+        capacity *= 2;
+    }
+    rebuildTable(capacity);
+
+    ++collectionCount;
+    collectionThreshold = std::max(memoryLimit, 2 * getMemoryUsage());
+}
+
+std::size_t HashLife::getNodeBudget() const
+{
+    // Each node takes up to four hash table slots, as the table is kept at
+    // most half full and grows by doubling
+    return memoryLimit / (sizeof(Node) + 4 * sizeof(std::uint32_t));
+}
+
+void HashLife::rebuildTable(std::size_t capacity)
+{
+    std::vector<std::uint32_t>(capacity, NO_NODE).swap(table);
+    tableCount = 0;
+
+    std::size_t mask = capacity - 1;
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        const Node& n = nodes[i];
+        if (n.level == 0)
+        {
+            continue;
+        }
+
+        std::size_t slot = hashChildren(n.nw, n.ne, n.sw, n.se) & mask;
+        while (table[slot] != NO_NODE)
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = static_cast<std::uint32_t>(i);
+        ++tableCount;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "LifeEngine.hpp"
+#include "LifeRule.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// HashLife engine. The plane is a quadtree in which identical subtrees are
+// stored once (hash-consed), and each node memoizes the future of its center,
+// so regular patterns advance 2^k generations in time roughly linear in k.
+// Unlike LifeSimulator the plane is unbounded: the sizeX by sizeY window only
+// addresses cells for insertPattern() and getCell(), and nothing wraps.
+// insertPattern() clamps the start to the window and clips the pattern at it.
+class HashLife : public LifeEngine
+{
+  public:
+    HashLife(std::uint32_t sizeX, std::uint32_t sizeY);
+
+    void insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY) override;
+    void update() override;
+    // Goes as the power-of-two jumps that sum to the count, smallest first.
+    // The plane spans at most 2^62 cells a side, so a jump that would need a
+    // larger one throws std::overflow_error, leaving the jumps before it done;
+    // jumps of 2^60 or more always do.
+    void advance(std::uint64_t generations) override;
+    // Each stretch between progress reports goes as the jumps that sum to it,
+    // with cancellation looked at between jumps. Throws std::overflow_error
+    // as advance() does.
+    std::uint64_t step(std::uint64_t generations, const StepControl& control) override;
+    std::uint64_t getGeneration() const override;
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+
+    std::uint64_t getPopulation() const;
+
+    // Two-state radius 1 rules only, and none with B0, which would fill the
+    // unbounded plane; throws std::invalid_argument for any other
+    void setRule(const LifeRule& rule);
+    const LifeRule& getRule() const;
+
+    // Caps the bytes held by nodes and memoized results, 0 meaning no cap.
+    // When a jump would grow past the cap, the nodes the universe no longer
+    // uses are evicted, along with the memoized results that pointed at them,
+    // and the rest of the jump goes as two of half the length. A universe
+    // that alone outgrows the cap may use up to twice what it holds.
+    void setMemoryLimit(std::size_t bytes);
+    std::size_t getMemoryUsage() const;
+    // How many times nodes have been evicted to stay under the cap
+    std::uint64_t getCollectionCount() const;
+
+  private:
+    // A square of 2^level cells on a side. Level 0 nodes are single cells.
+    struct Node
+    {
+        std::uint32_t nw;
+        std::uint32_t ne;
+        std::uint32_t sw;
+        std::uint32_t se;
+        // Center square (level - 1) advanced 2^resultStep generations
+        std::uint32_t result;
+        std::uint8_t level;
+        std::uint8_t resultStep;
+        std::uint64_t population;
+    };
+
+    static constexpr std::uint32_t NO_NODE = 0xFFFFFFFF;
+    static constexpr std::uint32_t DEAD = 0;
+    static constexpr std::uint32_t ALIVE = 1;
+    // Deepest root, so that plane coordinates and offsets within it fit in
+    // std::int64_t
+    static constexpr std::uint8_t MAX_LEVEL = 62;
+
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    std::uint64_t generation = 0;
+    std::size_t memoryLimit = 0;
+    // Usage at which the next collection is due: the limit, or twice the
+    // universe when that alone is over it
+    std::size_t collectionThreshold = 0;
+    std::uint64_t collectionCount = 0;
+    // Set while a jump is held to the limit, and once it has run over
+    bool budgeted = false;
+    bool overBudget = false;
+    LifeRule rule;
+    std::uint16_t birthMask;
+    std::uint16_t survivalMask;
+
+    std::vector<Node> nodes;
+    // Open-addressing hash table of node indices, keyed by their children
+    std::vector<std::uint32_t> table;
+    std::size_t tableCount = 0;
+    // The empty node of each level
+    std::vector<std::uint32_t> emptyNodes;
+
+    std::uint32_t root;
+    // Plane coordinates of the root's north-west cell
+    std::int64_t originX = 0;
+    std::int64_t originY = 0;
+
+    std::uint32_t join(std::uint32_t nw, std::uint32_t ne, std::uint32_t sw, std::uint32_t se);
+    std::uint32_t getEmpty(std::uint8_t level);
+    void expandRoot();
+    std::uint32_t successor(std::uint32_t node, std::uint8_t step);
+    std::uint32_t stepLeaf(std::uint32_t node);
+    std::uint32_t setCell(std::uint32_t node, std::uint64_t x, std::uint64_t y, bool alive);
+    void setCell(std::int64_t x, std::int64_t y, bool alive);
+    bool isPadded(std::uint32_t node) const;
+    void stepPowerOfTwo(std::uint8_t step);
+    std::size_t getNodeBudget() const;
+    void collectGarbage();
+    void rebuildTable(std::size_t capacity);
+};
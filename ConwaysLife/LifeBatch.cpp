@@ -0,0 +1,197 @@
+#include "LifeBatch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    const std::uint32_t ALL_LANES = (std::uint32_t(1) << BATCH_LANES) - 1;
+}
+
+LifeBatch::LifeBatch(std::size_t boardCount, std::uint32_t sizeX, std::uint32_t sizeY, const LifeRule& rule) :
+    boardCount(boardCount),
+    sizeX(sizeX),
+    sizeY(sizeY),
+    rule(rule),
+    bitRule({ rule.getBirthMask(), rule.getSurvivalMask() }),
+    batchKernel(selectBatchKernel(bitRule))
+{
+    if (!sizeX || sizeX > CELLS_PER_WORD || !sizeY)
+    {
+        throw std::invalid_argument("Batch boards must be 1 to 64 cells wide and at least 1 high");
+    }
+    if (rule.getRadius() != 1 || rule.getStateCount() != 2)
+    {
+        throw std::invalid_argument("LifeBatch cannot run rule " + rule.toString());
+    }
+
+    // Sized only once the arguments are known to be good
+    groups.resize((boardCount + BATCH_LANES - 1) / BATCH_LANES);
+    cells.resize(groups.size() * getGroupWords(), 0);
+    nextCells.resize(cells.size(), 0);
+    savedCells.resize(cells.size(), 0);
+}
+
+std::size_t LifeBatch::getBoardCount() const
+{
+    return boardCount;
+}
+
+std::uint32_t LifeBatch::getSizeX() const
+{
+    return sizeX;
+}
+
+std::uint32_t LifeBatch::getSizeY() const
+{
+    return sizeY;
+}
+
+const LifeRule& LifeBatch::getRule() const
+{
+    return rule;
+}
+
+void LifeBatch::setThreadCount(std::size_t threadCount)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    pool.reset();
+    if (threadCount > 1)
+    {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+}
+
+std::size_t LifeBatch::getThreadCount() const
+{
+    return pool ? pool->getThreadCount() : 1;
+}
+
+bool LifeBatch::getCell(std::size_t board, std::uint32_t x, std::uint32_t y) const
+{
+    std::size_t word = board / BATCH_LANES * getGroupWords() + y * BATCH_LANES + board % BATCH_LANES;
+    return (cells[word] >> x) & 1;
+}
+
+void LifeBatch::insertPattern(std::size_t board, const Pattern& pattern, std::uint32_t startX, std::uint32_t startY)
+{
+    startX %= sizeX;
+    startY %= sizeY;
+    std::uint32_t width = std::min(pattern.getSizeX(), sizeX);
+    std::uint32_t height = std::min(pattern.getSizeY(), sizeY);
+    // Columns up to the right edge, then the rest from x = 0
+    std::uint32_t firstWidth = std::min(width, sizeX - startX);
+
+    std::size_t group = board / BATCH_LANES;
+    std::vector<std::uint64_t> patternRow(wordsForCells(pattern.getSizeX()));
+    for (std::uint32_t y = 0; y < height; ++y)
+    {
+        pattern.getRow(y, patternRow.data());
+        std::uint32_t boardY = startY + y < sizeY ? startY + y : startY + y - sizeY;
+        std::uint64_t& row = cells[group * getGroupWords() + boardY * BATCH_LANES + board % BATCH_LANES];
+        copyBits(&row, startX, patternRow.data(), 0, firstWidth);
+        copyBits(&row, 0, patternRow.data(), firstWidth, width - firstWidth);
+    }
+
+    restartGroup(group);
+}
+
+void LifeBatch::advance(std::uint64_t generations)
+{
+    if (pool)
+    {
+        pool->parallelFor(groups.size(), [this, generations](std::size_t group, std::size_t) { advanceGroup(group, generations); });
+        return;
+    }
+
+    for (std::size_t group = 0; group < groups.size(); ++group)
+    {
+        advanceGroup(group, generations);
+    }
+}
+
+LifeBatch::Result LifeBatch::getResult(std::size_t board) const
+{
+    const Group& group = groups[board / BATCH_LANES];
+    const std::uint64_t* row = cells.data() + board / BATCH_LANES * getGroupWords() + board % BATCH_LANES;
+
+    Result result = { group.generation, 0, group.periods[board % BATCH_LANES] };
+    for (std::uint32_t y = 0; y < sizeY; ++y)
+    {
+        result.population += countSetBits(row[y * BATCH_LANES]);
+    }
+    return result;
+}
+
+std::vector<LifeBatch::Result> LifeBatch::getResults() const
+{
+    std::vector<Result> results(boardCount);
+    for (std::size_t board = 0; board < boardCount; ++board)
+    {
+        results[board] = getResult(board);
+    }
+    return results;
+}
+
+std::size_t LifeBatch::getMemoryUsage() const
+{
+    return groups.capacity() * sizeof(Group) + (cells.capacity() + nextCells.capacity() + savedCells.capacity()) * sizeof(std::uint64_t);
+}
+
+std::size_t LifeBatch::getGroupWords() const
+{
+    return static_cast<std::size_t>(sizeY) * BATCH_LANES;
+}
+
+void LifeBatch::advanceGroup(std::size_t group, std::uint64_t generations)
+{
+    Group& state = groups[group];
+    std::size_t groupWords = getGroupWords();
+    std::uint64_t* current = cells.data() + group * groupWords;
+    std::uint64_t* next = nextCells.data() + group * groupWords;
+    std::uint64_t* saved = savedCells.data() + group * groupWords;
+
+    // Lanes past the last board hold empty boards, which settle at once
+    for (std::uint64_t i = 0; i < generations && state.settled != ALL_LANES; ++i)
+    {
+        std::uint32_t matches = batchKernel(bitRule, current, next, saved, sizeX, sizeY);
+        std::swap(current, next);
+        ++state.generation;
+
+        for (std::uint32_t found = matches & ~state.settled; found; found &= found - 1)
+        {
+            state.periods[countSetBits((found & (0 - found)) - 1)] = state.generation - state.savedGeneration;
+        }
+        state.settled |= matches;
+
+        if (state.generation - state.savedGeneration == state.power)
+        {
+            std::copy(current, current + groupWords, saved);
+            state.savedGeneration = state.generation;
+            state.power *= 2;
+        }
+    }
+
+    // Each group's words live in cells between calls
+    if (current != cells.data() + group * groupWords)
+    {
+        std::copy(current, current + groupWords, cells.data() + group * groupWords);
+    }
+}
+
+void LifeBatch::restartGroup(std::size_t group)
+{
+    Group& state = groups[group];
+    state.savedGeneration = state.generation;
+    state.power = 1;
+    state.settled = 0;
+    std::fill(std::begin(state.periods), std::end(state.periods), 0);
+
+    std::size_t groupWords = getGroupWords();
+    std::copy(cells.begin() + group * groupWords, cells.begin() + (group + 1) * groupWords, savedCells.begin() + group * groupWords);
+}
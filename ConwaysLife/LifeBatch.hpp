@@ -0,0 +1,92 @@
+#pragma once
+
+#include "LifeKernel.hpp"
+#include "LifeRule.hpp"
+#include "Pattern.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Many small boards, each a torus of its own, stepped side by side, for
+// searches that run thousands of soups. Boards are stored as a structure of
+// arrays: a group of BATCH_LANES boards keeps row y of each board in
+// consecutive words, so the kernel steps the group's boards in the lanes of
+// one vector, and a thread steps a group through every generation while it
+// sits in cache. Each board watches for its own cycle with Brent's method:
+// every generation is compared with a copy saved at a power of two, so the
+// period is found with one saved copy rather than a history. A group stops
+// being stepped once all of its boards have settled.
+class LifeBatch
+{
+  public:
+    struct Result
+    {
+        // Generations the board has been stepped
+        std::uint64_t generation;
+        std::uint64_t population;
+        // Period of the cycle the board settled into, 0 if it has not yet
+        std::uint64_t period;
+    };
+
+    // boardCount empty boards of sizeX by sizeY cells. Throws
+    // std::invalid_argument unless sizeX is 1 to 64 and sizeY at least 1,
+    // or for any rule but a two-state radius 1 rule.
+    LifeBatch(std::size_t boardCount, std::uint32_t sizeX, std::uint32_t sizeY, const LifeRule& rule = LifeRule());
+
+    std::size_t getBoardCount() const;
+    std::uint32_t getSizeX() const;
+    std::uint32_t getSizeY() const;
+    const LifeRule& getRule() const;
+
+    // 0 uses one thread per hardware thread
+    void setThreadCount(std::size_t threadCount);
+    std::size_t getThreadCount() const;
+
+    bool getCell(std::size_t board, std::uint32_t x, std::uint32_t y) const;
+    // Copies the pattern onto the board as LifeSimulator does, wrapping
+    // around the edges. The board's group starts looking for cycles afresh.
+    void insertPattern(std::size_t board, const Pattern& pattern, std::uint32_t startX, std::uint32_t startY);
+
+    // Steps every board up to the given number of generations, stopping
+    // early for groups whose boards have all settled
+    void advance(std::uint64_t generations);
+
+    Result getResult(std::size_t board) const;
+    std::vector<Result> getResults() const;
+
+    std::size_t getMemoryUsage() const;
+
+  private:
+    // Cycle detection and progress of one group of boards
+    struct Group
+    {
+        std::uint64_t generation = 0;
+        // Brent's method: the copy in saved is of this generation, and is
+        // replaced once power more generations have gone by without a match
+        std::uint64_t savedGeneration = 0;
+        std::uint64_t power = 1;
+        // Bit i set once board i has come back to the saved copy
+        std::uint32_t settled = 0;
+        std::uint64_t periods[BATCH_LANES] = {};
+    };
+
+    std::size_t boardCount;
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    LifeRule rule;
+    BitRule bitRule;
+    BatchKernel batchKernel;
+    std::unique_ptr<ThreadPool> pool;
+
+    std::vector<Group> groups;
+    // Words of each group's boards, group g's at g * sizeY * BATCH_LANES
+    std::vector<std::uint64_t> cells;
+    std::vector<std::uint64_t> nextCells;
+    std::vector<std::uint64_t> savedCells;
+
+    std::size_t getGroupWords() const;
+    void advanceGroup(std::size_t group, std::uint64_t generations);
+    void restartGroup(std::size_t group);
+};
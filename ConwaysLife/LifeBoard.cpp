@@ -0,0 +1,91 @@
+#include "LifeBoard.hpp"
+
+#include <algorithm>
+
+LifeBoard::LifeBoard(std::uint32_t sizeX, std::uint32_t sizeY) :
+    sizeX(sizeX),
+    sizeY(sizeY),
+    wordsPerRow(wordsForCells(sizeX)),
+    stride(wordsPerRow + 2)
+{
+    cells.resize(stride * (static_cast<std::size_t>(sizeY) + 2), 0);
+}
+
+void LifeBoard::setCell(std::uint32_t x, std::uint32_t y, bool alive)
+{
+    std::uint64_t& word = getRow(y)[x / CELLS_PER_WORD];
+    std::uint64_t bit = std::uint64_t(1) << (x % CELLS_PER_WORD);
+    word = alive ? (word | bit) : (word & ~bit);
+}
+
+void LifeBoard::setSpan(std::uint32_t x, std::uint32_t y, std::uint32_t length, bool alive)
+{
+    std::uint64_t* row = getRow(y);
+
+    // Most runs fit in one word
+    if (length && length < CELLS_PER_WORD && x / CELLS_PER_WORD == (x + length - 1) / CELLS_PER_WORD)
+    {
+        std::uint64_t mask = ((std::uint64_t(1) << length) - 1) << (x % CELLS_PER_WORD);
+        std::uint64_t& word = row[x / CELLS_PER_WORD];
+        word = alive ? (word | mask) : (word & ~mask);
+        return;
+    }
+
+    fillBits(row, x, length, alive);
+}
+
+void LifeBoard::copySpan(std::uint32_t x, std::uint32_t y, const std::uint64_t* bits, std::size_t firstBit, std::uint32_t length)
+{
+    copyBits(getRow(y), x, bits, firstBit, length);
+}
+
+void LifeBoard::clear()
+{
+    std::fill(cells.begin(), cells.end(), 0);
+}
+
+void LifeBoard::refreshHalo()
+{
+    refreshHalo(0, sizeY);
+}
+
+void LifeBoard::refreshHalo(std::uint32_t beginY, std::uint32_t endY)
+{
+    if (!sizeX || beginY >= endY)
+    {
+        return;
+    }
+
+    // The cell past x = sizeX lands either in the last word or in the right padding
+    std::size_t eastWord = sizeX / CELLS_PER_WORD;
+    std::uint64_t eastBit = std::uint64_t(1) << (sizeX % CELLS_PER_WORD);
+
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        std::uint64_t* row = getRow(y);
+        row[-1] = static_cast<std::uint64_t>(getCell(sizeX - 1, y)) << 63;
+        row[wordsPerRow] = 0;
+        row[eastWord] = (row[eastWord] & ~eastBit) | ((row[0] & 1) ? eastBit : 0);
+    }
+
+    // Whole padded rows, so the corners come along
+    if (endY == sizeY)
+    {
+        std::copy(getRow(sizeY - 1) - 1, getRow(sizeY - 1) - 1 + stride, getRow(-1) - 1);
+    }
+    if (beginY == 0)
+    {
+        std::copy(getRow(0) - 1, getRow(0) - 1 + stride, getRow(sizeY) - 1);
+    }
+}
+
+std::size_t LifeBoard::getMemoryUsage() const
+{
+    return sizeof(*this) + cells.capacity() * sizeof(std::uint64_t);
+}
+
+double LifeBoard::getBitsPerCell() const
+{
+    std::size_t cellCount = static_cast<std::size_t>(sizeX) * sizeY;
+    return cellCount ? 8.0 * getMemoryUsage() / cellCount : 0.0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "LifeKernel.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// A torus of bit-packed cells stored in one flat buffer. Every row is padded
+// by a word on each side and the board by a row above and below; the padding
+// (the halo) holds copies of the cells across the wrap-around edges, so the
+// kernel can read past any edge without branching.
+class LifeBoard
+{
+  public:
+    LifeBoard(std::uint32_t sizeX, std::uint32_t sizeY);
+
+    std::uint32_t getSizeX() const { return sizeX; }
+    std::uint32_t getSizeY() const { return sizeY; }
+
+    bool getCell(std::uint32_t x, std::uint32_t y) const
+    {
+        return (getRow(y)[x / CELLS_PER_WORD] >> (x % CELLS_PER_WORD)) & 1;
+    }
+    void setCell(std::uint32_t x, std::uint32_t y, bool alive);
+    // Sets cells [x, x + length) of row y, a word at a time. The span must fit in the row.
+    void setSpan(std::uint32_t x, std::uint32_t y, std::uint32_t length, bool alive);
+    // Overwrites cells [x, x + length) of row y with bits [firstBit, firstBit + length) of a packed row
+    void copySpan(std::uint32_t x, std::uint32_t y, const std::uint64_t* bits, std::size_t firstBit, std::uint32_t length);
+    void clear();
+
+    // Number of words holding cells in each row
+    std::size_t getWordsPerRow() const { return wordsPerRow; }
+    // Distance in words between consecutive rows, padding included
+    std::size_t getStride() const { return stride; }
+
+    // Word 0 of row y. y may be -1 or sizeY to reach the halo rows, and each
+    // row may be indexed from -1 to getWordsPerRow() to reach its padding.
+    std::uint64_t* getRow(std::int64_t y) { return cells.data() + (y + 1) * stride + 1; }
+    const std::uint64_t* getRow(std::int64_t y) const { return cells.data() + (y + 1) * stride + 1; }
+
+    // Copies the cells across each edge into the halo. Must be called after
+    // the cells change and before the kernel next reads the board.
+    void refreshHalo();
+    // Same, for the halo of rows [beginY, endY) only
+    void refreshHalo(std::uint32_t beginY, std::uint32_t endY);
+
+    std::size_t getMemoryUsage() const;
+    double getBitsPerCell() const;
+
+  private:
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    std::size_t wordsPerRow;
+    std::size_t stride;
+    std::vector<std::uint64_t> cells;
+};
@@ -0,0 +1,14 @@
+#include "LifeEngine.hpp"
+
+std::uint64_t LifeEngine::step(std::uint64_t generations, const StepControl& control)
+{
+    std::uint64_t done = 0;
+    while (done < generations && !control.isCancelled())
+    {
+        std::uint64_t chunk = control.getChunk(done, generations);
+        advance(chunk);
+        done += chunk;
+        control.report(done);
+    }
+    return done;
+}
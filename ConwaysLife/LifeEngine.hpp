@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Pattern.hpp"
+#include "StepControl.hpp"
+
+#include <cstdint>
+
+// Common interface of the simulation engines. Cells are addressed within a
+// sizeX by sizeY window; what lies past its edges depends on the engine.
+// The window's current generation is itself a pattern, so it can be
+// rendered, captured into a LifeFrame, or inserted into another engine.
+class LifeEngine : public Pattern
+{
+  public:
+    virtual void insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY) = 0;
+    // Advances one generation
+    virtual void update() = 0;
+    // Advances the given number of generations
+    virtual void advance(std::uint64_t generations) = 0;
+    // Advances up to the given number of generations with the loop kept
+    // inside the engine, reporting progress and stopping early when
+    // cancelled, as control says. Returns the generations advanced. The
+    // default advances from one progress report to the next in one call.
+    virtual std::uint64_t step(std::uint64_t generations, const StepControl& control);
+    // Generations advanced since construction
+    virtual std::uint64_t getGeneration() const = 0;
+};
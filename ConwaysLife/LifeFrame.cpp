@@ -0,0 +1,49 @@
+#include "LifeFrame.hpp"
+
+#include <algorithm>
+
+LifeFrame::LifeFrame() :
+    cells(0, 0)
+{
+}
+
+void LifeFrame::capture(const LifeEngine& engine)
+{
+    if (engine.getSizeX() != cells.getSizeX() || engine.getSizeY() != cells.getSizeY())
+    {
+        cells = LifeBoard(engine.getSizeX(), engine.getSizeY());
+    }
+
+    for (std::uint32_t y = 0; y < cells.getSizeY(); ++y)
+    {
+        engine.getRow(y, cells.getRow(y));
+    }
+    generation = engine.getGeneration();
+}
+
+std::uint32_t LifeFrame::getSizeX() const
+{
+    return cells.getSizeX();
+}
+
+std::uint32_t LifeFrame::getSizeY() const
+{
+    return cells.getSizeY();
+}
+
+bool LifeFrame::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    return cells.getCell(x, y);
+}
+
+void LifeFrame::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    // Rows come in with the bits past the last cell clear, and stay that way
+    const std::uint64_t* row = cells.getRow(y);
+    std::copy(row, row + cells.getWordsPerRow(), words);
+}
+
+std::uint64_t LifeFrame::getGeneration() const
+{
+    return generation;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "LifeBoard.hpp"
+#include "LifeEngine.hpp"
+#include "Pattern.hpp"
+
+#include <cstdint>
+
+// The cells of one generation, copied out of an engine as packed rows, so
+// another thread can read them while the engine moves on. Capturing into a
+// frame of the same size reuses its storage and never allocates.
+class LifeFrame : public Pattern
+{
+  public:
+    LifeFrame();
+
+    void capture(const LifeEngine& engine);
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+
+    // Generation of the engine when it was captured
+    std::uint64_t getGeneration() const;
+
+  private:
+    LifeBoard cells;
+    std::uint64_t generation = 0;
+};
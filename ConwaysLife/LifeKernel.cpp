@@ -0,0 +1,746 @@
+#include "LifeKernel.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__) && defined(__GNUC__) && !defined(__clang__)
+    // GCC's AVX-512 intrinsics trip false uninitialized-variable warnings
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+namespace
+{
+    // Lane types the kernel runs on. Each wraps a register of WIDTH words and
+    // provides the handful of operations the generation logic needs, so that
+    // logic is written once for every instruction set.
+    struct ScalarLanes
+    {
+        static const std::size_t WIDTH = 1;
+        std::uint64_t v;
+    };
+
+    inline ScalarLanes load(const std::uint64_t* p, ScalarLanes) { return { *p }; }
+    inline void store(std::uint64_t* p, ScalarLanes x) { *p = x.v; }
+    inline ScalarLanes operator&(ScalarLanes a, ScalarLanes b) { return { a.v & b.v }; }
+    inline ScalarLanes operator|(ScalarLanes a, ScalarLanes b) { return { a.v | b.v }; }
+    inline ScalarLanes operator^(ScalarLanes a, ScalarLanes b) { return { a.v ^ b.v }; }
+    inline ScalarLanes andNot(ScalarLanes a, ScalarLanes b) { return { ~a.v & b.v }; }
+    inline ScalarLanes shiftWest(ScalarLanes prev, ScalarLanes cur) { return { (cur.v << 1) | (prev.v >> 63) }; }
+    inline ScalarLanes shiftEast(ScalarLanes cur, ScalarLanes next) { return { (cur.v >> 1) | (next.v << 63) }; }
+    inline bool anySet(ScalarLanes x) { return x.v != 0; }
+    inline ScalarLanes fill(std::uint64_t word, ScalarLanes) { return { word }; }
+    inline ScalarLanes shiftLeft(ScalarLanes x, unsigned count) { return { x.v << count }; }
+    inline ScalarLanes shiftRight(ScalarLanes x, unsigned count) { return { x.v >> count }; }
+    inline std::uint32_t zeroLanes(ScalarLanes x) { return x.v == 0; }
+    inline void addFlips(FlipSums& sums, std::size_t word, ScalarLanes flips, std::uint64_t rowKey) { addWordFlips(sums, word, flips.v, rowKey); }
+
+#if defined(__AVX2__)
+    struct Avx2Lanes
+    {
+        static const std::size_t WIDTH = 4;
+        __m256i v;
+    };
+
+    inline Avx2Lanes load(const std::uint64_t* p, Avx2Lanes) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+    inline void store(std::uint64_t* p, Avx2Lanes x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x.v); }
+    inline Avx2Lanes operator&(Avx2Lanes a, Avx2Lanes b) { return { _mm256_and_si256(a.v, b.v) }; }
+    inline Avx2Lanes operator|(Avx2Lanes a, Avx2Lanes b) { return { _mm256_or_si256(a.v, b.v) }; }
+    inline Avx2Lanes operator^(Avx2Lanes a, Avx2Lanes b) { return { _mm256_xor_si256(a.v, b.v) }; }
+    inline Avx2Lanes andNot(Avx2Lanes a, Avx2Lanes b) { return { _mm256_andnot_si256(a.v, b.v) }; }
+    inline Avx2Lanes shiftWest(Avx2Lanes prev, Avx2Lanes cur) { return { _mm256_or_si256(_mm256_slli_epi64(cur.v, 1), _mm256_srli_epi64(prev.v, 63)) }; }
+    inline Avx2Lanes shiftEast(Avx2Lanes cur, Avx2Lanes next) { return { _mm256_or_si256(_mm256_srli_epi64(cur.v, 1), _mm256_slli_epi64(next.v, 63)) }; }
+    inline bool anySet(Avx2Lanes x) { return !_mm256_testz_si256(x.v, x.v); }
+    inline Avx2Lanes fill(std::uint64_t word, Avx2Lanes) { return { _mm256_set1_epi64x(static_cast<long long>(word)) }; }
+    inline Avx2Lanes shiftLeft(Avx2Lanes x, unsigned count) { return { _mm256_sll_epi64(x.v, _mm_cvtsi32_si128(static_cast<int>(count))) }; }
+    inline Avx2Lanes shiftRight(Avx2Lanes x, unsigned count) { return { _mm256_srl_epi64(x.v, _mm_cvtsi32_si128(static_cast<int>(count))) }; }
+    inline std::uint32_t zeroLanes(Avx2Lanes x) { return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x.v, _mm256_setzero_si256())))); }
+
+    // word is a multiple of 4, so the sums of its even words lie side by
+    // side, and so do those of its odd ones
+    inline void addFlips(FlipSums& sums, std::size_t word, Avx2Lanes flips, std::uint64_t rowKey)
+    {
+#if defined(__VPCLMULQDQ__)
+        __m256i key = _mm256_set1_epi64x(static_cast<long long>(rowKey));
+        auto* even = reinterpret_cast<__m256i*>(sums.words + flipSlot(word));
+        auto* odd = reinterpret_cast<__m256i*>(sums.words + flipSlot(word + 1));
+        _mm256_storeu_si256(even, _mm256_xor_si256(_mm256_loadu_si256(even), _mm256_clmulepi64_epi128(flips.v, key, 0x00)));
+        _mm256_storeu_si256(odd, _mm256_xor_si256(_mm256_loadu_si256(odd), _mm256_clmulepi64_epi128(flips.v, key, 0x01)));
+#else
+        alignas(32) std::uint64_t words[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words), flips.v);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            addWordFlips(sums, word + i, words[i], rowKey);
+        }
+#endif
+    }
+#endif
+
+#if defined(__AVX512F__)
+    struct Avx512Lanes
+    {
+        static const std::size_t WIDTH = 8;
+        __m512i v;
+    };
+
+    inline Avx512Lanes load(const std::uint64_t* p, Avx512Lanes) { return { _mm512_loadu_si512(p) }; }
+    inline void store(std::uint64_t* p, Avx512Lanes x) { _mm512_storeu_si512(p, x.v); }
+    inline Avx512Lanes operator&(Avx512Lanes a, Avx512Lanes b) { return { _mm512_and_si512(a.v, b.v) }; }
+    inline Avx512Lanes operator|(Avx512Lanes a, Avx512Lanes b) { return { _mm512_or_si512(a.v, b.v) }; }
+    inline Avx512Lanes operator^(Avx512Lanes a, Avx512Lanes b) { return { _mm512_xor_si512(a.v, b.v) }; }
+    inline Avx512Lanes andNot(Avx512Lanes a, Avx512Lanes b) { return { _mm512_andnot_si512(a.v, b.v) }; }
+    inline Avx512Lanes shiftWest(Avx512Lanes prev, Avx512Lanes cur) { return { _mm512_or_si512(_mm512_slli_epi64(cur.v, 1), _mm512_srli_epi64(prev.v, 63)) }; }
+    inline Avx512Lanes shiftEast(Avx512Lanes cur, Avx512Lanes next) { return { _mm512_or_si512(_mm512_srli_epi64(cur.v, 1), _mm512_slli_epi64(next.v, 63)) }; }
+    inline bool anySet(Avx512Lanes x) { return _mm512_test_epi64_mask(x.v, x.v) != 0; }
+    inline Avx512Lanes fill(std::uint64_t word, Avx512Lanes) { return { _mm512_set1_epi64(static_cast<long long>(word)) }; }
+    inline Avx512Lanes shiftLeft(Avx512Lanes x, unsigned count) { return { _mm512_sll_epi64(x.v, _mm_cvtsi32_si128(static_cast<int>(count))) }; }
+    inline Avx512Lanes shiftRight(Avx512Lanes x, unsigned count) { return { _mm512_srl_epi64(x.v, _mm_cvtsi32_si128(static_cast<int>(count))) }; }
+    inline std::uint32_t zeroLanes(Avx512Lanes x) { return _mm512_testn_epi64_mask(x.v, x.v); }
+
+    // A FlipSums holds one register of words, so they are its words 0 to 7:
+    // the even words' sums fill the first half and the odd ones' the second
+    inline void addFlips(FlipSums& sums, std::size_t, Avx512Lanes flips, std::uint64_t rowKey)
+    {
+#if defined(__VPCLMULQDQ__)
+        __m512i key = _mm512_set1_epi64(static_cast<long long>(rowKey));
+        CarrylessSum* even = sums.words + flipSlot(0);
+        CarrylessSum* odd = sums.words + flipSlot(1);
+        _mm512_store_si512(even, _mm512_xor_si512(_mm512_load_si512(even), _mm512_clmulepi64_epi128(flips.v, key, 0x00)));
+        _mm512_store_si512(odd, _mm512_xor_si512(_mm512_load_si512(odd), _mm512_clmulepi64_epi128(flips.v, key, 0x01)));
+#else
+        alignas(64) std::uint64_t words[8];
+        _mm512_store_si512(words, flips.v);
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            addWordFlips(sums, i, words[i], rowKey);
+        }
+#endif
+    }
+#endif
+
+    // Rules the kernel can run. Each one maps a cell and its eight neighbors,
+    // for 64 * WIDTH cells at once, to the cells' next state.
+
+    // Conway's rule, reduced by hand. The neighbor count is summed with full
+    // adders into bit planes, stopping once it reaches four.
+    struct ConwayRule
+    {
+        explicit ConwayRule(const BitRule&) {}
+
+        template <typename Lanes>
+        Lanes apply(Lanes aboveWest, Lanes above, Lanes aboveEast, Lanes west, Lanes cell, Lanes east, Lanes belowWest, Lanes below, Lanes belowEast) const
+        {
+            // Two-bit counts of the three cells above and the three cells below
+            Lanes aboveBit0 = aboveWest ^ above ^ aboveEast;
+            Lanes aboveBit1 = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+            Lanes belowBit0 = belowWest ^ below ^ belowEast;
+            Lanes belowBit1 = (belowWest & below) | (belowEast & (belowWest ^ below));
+
+            // Two-bit count of the left and right neighbors
+            Lanes sideBit0 = west ^ east;
+            Lanes sideBit1 = west & east;
+
+            // Add the three partial counts
+            Lanes bit0 = aboveBit0 ^ belowBit0 ^ sideBit0;
+            Lanes carry = (aboveBit0 & belowBit0) | (sideBit0 & (aboveBit0 ^ belowBit0));
+            Lanes bit1 = aboveBit1 ^ belowBit1 ^ sideBit1 ^ carry;
+            Lanes atLeastFour = ((aboveBit1 | belowBit1) & (sideBit1 | carry)) | (aboveBit1 & belowBit1) | (sideBit1 & carry);
+
+            // Live with exactly 3 neighbors, or with 2 if already alive
+            return andNot(atLeastFour, bit1 & (bit0 | cell));
+        }
+    };
+
+    // Sets exactly[k] to the cells with k neighbors, k = 0 to 8
+    template <typename Lanes>
+    void countNeighbors(Lanes aboveWest, Lanes above, Lanes aboveEast, Lanes west, Lanes east, Lanes belowWest, Lanes below, Lanes belowEast, Lanes (&exactly)[9])
+    {
+        // The same adders as ConwayRule, carried on to the full four-bit count
+        Lanes aboveBit0 = aboveWest ^ above ^ aboveEast;
+        Lanes aboveBit1 = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+        Lanes belowBit0 = belowWest ^ below ^ belowEast;
+        Lanes belowBit1 = (belowWest & below) | (belowEast & (belowWest ^ below));
+        Lanes sideBit0 = west ^ east;
+        Lanes sideBit1 = west & east;
+
+        Lanes bit0 = aboveBit0 ^ belowBit0 ^ sideBit0;
+        Lanes carry = (aboveBit0 & belowBit0) | (sideBit0 & (aboveBit0 ^ belowBit0));
+
+        // Then add up the four twos
+        Lanes pair0 = aboveBit1 ^ belowBit1;
+        Lanes pair1 = sideBit1 ^ carry;
+        Lanes bit1 = pair0 ^ pair1;
+        Lanes bit2 = (aboveBit1 & belowBit1) ^ (sideBit1 & carry) ^ (pair0 & pair1);
+        Lanes bit3 = aboveBit1 & belowBit1 & sideBit1 & carry;
+
+        // A count of 8 has its low three bits clear
+        Lanes ones = fill(~std::uint64_t(0), Lanes());
+        Lanes low[4] = { andNot(bit0 | bit1, ones), andNot(bit1, bit0), andNot(bit0, bit1), bit0 & bit1 };
+        Lanes high[2] = { andNot(bit2 | bit3, ones), bit2 };
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            exactly[k] = low[k % 4] & high[k / 4];
+        }
+        exactly[8] = bit3;
+    }
+
+    // A rule known at compile time, so the counts it never uses fold away
+    template <std::uint16_t BIRTH, std::uint16_t SURVIVAL>
+    struct StaticRule
+    {
+        explicit StaticRule(const BitRule&) {}
+
+        template <typename Lanes>
+        Lanes apply(Lanes aboveWest, Lanes above, Lanes aboveEast, Lanes west, Lanes cell, Lanes east, Lanes belowWest, Lanes below, Lanes belowEast) const
+        {
+            Lanes exactly[9];
+            countNeighbors(aboveWest, above, aboveEast, west, east, belowWest, below, belowEast, exactly);
+
+            Lanes born = {};
+            Lanes survives = {};
+            for (std::size_t k = 0; k < 9; ++k)
+            {
+                if ((BIRTH >> k) & 1)
+                {
+                    born = born | exactly[k];
+                }
+                if ((SURVIVAL >> k) & 1)
+                {
+                    survives = survives | exactly[k];
+                }
+            }
+            return (cell & survives) | andNot(cell, born);
+        }
+    };
+
+    // Any other rule, compiled into a table of masks indexed by neighbor count
+    struct TableRule
+    {
+        std::uint64_t birth[9];
+        std::uint64_t survival[9];
+
+        explicit TableRule(const BitRule& rule)
+        {
+            for (std::size_t k = 0; k < 9; ++k)
+            {
+                birth[k] = ((rule.birth >> k) & 1) ? ~std::uint64_t(0) : 0;
+                survival[k] = ((rule.survival >> k) & 1) ? ~std::uint64_t(0) : 0;
+            }
+        }
+
+        template <typename Lanes>
+        Lanes apply(Lanes aboveWest, Lanes above, Lanes aboveEast, Lanes west, Lanes cell, Lanes east, Lanes belowWest, Lanes below, Lanes belowEast) const
+        {
+            Lanes exactly[9];
+            countNeighbors(aboveWest, above, aboveEast, west, east, belowWest, below, belowEast, exactly);
+
+            Lanes born = {};
+            Lanes survives = {};
+            for (std::size_t k = 0; k < 9; ++k)
+            {
+                born = born | (exactly[k] & fill(birth[k], Lanes()));
+                survives = survives | (exactly[k] & fill(survival[k], Lanes()));
+            }
+            return (cell & survives) | andNot(cell, born);
+        }
+    };
+
+    // Computes words [begin, end) of a row and sets changed if any cell
+    // differs from the input, adding the cells that do to flipSums if given,
+    // word first at its word 0. Returns the first word not computed.
+    template <typename Lanes, typename Rule>
+    std::size_t computeInnerWords(const Rule& rule, const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t begin, std::size_t end, bool& changed,
+                                  FlipSums* flipSums, std::uint64_t rowKey, std::size_t first)
+    {
+        const Lanes tag = {};
+        Lanes difference = {};
+        std::size_t i = begin;
+        for (; i + Lanes::WIDTH <= end; i += Lanes::WIDTH)
+        {
+            Lanes a = load(above + i, tag);
+            Lanes r = load(row + i, tag);
+            Lanes b = load(below + i, tag);
+            Lanes next = rule.apply(
+                shiftWest(load(above + i - 1, tag), a), a, shiftEast(a, load(above + i + 1, tag)),
+                shiftWest(load(row + i - 1, tag), r), r, shiftEast(r, load(row + i + 1, tag)),
+                shiftWest(load(below + i - 1, tag), b), b, shiftEast(b, load(below + i + 1, tag)));
+            store(out + i, next);
+            difference = difference | (next ^ r);
+            if (flipSums)
+            {
+                addFlips(*flipSums, i - first, next ^ r, rowKey);
+            }
+        }
+
+        changed = changed || anySet(difference);
+        return i;
+    }
+
+    template <typename Rule>
+    bool computeSpan(const BitRule& bitRule, const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX, std::size_t beginWord, std::size_t endWord,
+                     FlipSums* flipSums, std::uint64_t rowKey)
+    {
+        const Rule rule(bitRule);
+
+        // The last word of a row is masked, so it is computed on its own below
+        bool endsRow = endWord == wordsForCells(sizeX);
+        std::size_t innerEnd = endsRow ? endWord - 1 : endWord;
+
+        // The padding words either side of each row make every word an inner word
+        bool changed = false;
+        std::size_t i = beginWord;
+#if defined(__AVX512F__)
+        i = computeInnerWords<Avx512Lanes>(rule, above, row, below, out, i, innerEnd, changed, flipSums, rowKey, beginWord);
+#endif
+#if defined(__AVX2__)
+        i = computeInnerWords<Avx2Lanes>(rule, above, row, below, out, i, innerEnd, changed, flipSums, rowKey, beginWord);
+#endif
+        computeInnerWords<ScalarLanes>(rule, above, row, below, out, i, innerEnd, changed, flipSums, rowKey, beginWord);
+
+        // Keep the bits past the end of the row clear
+        if (endsRow)
+        {
+            bool ignored = false;
+            computeInnerWords<ScalarLanes>(rule, above, row, below, out, innerEnd, endWord, ignored, nullptr, 0, beginWord);
+            std::uint64_t mask = lastWordMask(sizeX);
+            out[innerEnd] &= mask;
+            changed = changed || (out[innerEnd] != (row[innerEnd] & mask));
+        }
+
+        return changed;
+    }
+
+    // A row of one board of a batch, with its neighbors either side wrapped around the board's width
+    template <typename Lanes>
+    struct WrappedRow
+    {
+        Lanes west;
+        Lanes cells;
+        Lanes east;
+    };
+
+    template <typename Lanes>
+    WrappedRow<Lanes> wrapRow(Lanes cells, unsigned lastBit)
+    {
+        return { shiftLeft(cells, 1) | shiftRight(cells, lastBit), cells, shiftRight(cells, 1) | shiftLeft(cells, lastBit) };
+    }
+
+    // Steps the lanes of a batch group from lane on, Lanes::WIDTH boards at
+    // once, and returns the mask of those whose next generation matches saved
+    template <typename Lanes, typename Rule>
+    std::uint32_t computeBatchLanes(const Rule& rule, const std::uint64_t* cells, std::uint64_t* next, const std::uint64_t* saved, std::size_t sizeX, std::size_t sizeY, std::size_t lane)
+    {
+        const Lanes tag = {};
+        const Lanes mask = fill(lastWordMask(sizeX), tag);
+        const auto lastBit = static_cast<unsigned>(sizeX - 1);
+        auto rowAt = [&](std::size_t y) { return wrapRow(load(cells + y * BATCH_LANES + lane, tag), lastBit); };
+
+        // Each row is wrapped once, then passed down as the next row's above
+        WrappedRow<Lanes> above = rowAt(sizeY - 1);
+        WrappedRow<Lanes> row = rowAt(0);
+        Lanes difference = {};
+        for (std::size_t y = 0; y < sizeY; ++y)
+        {
+            WrappedRow<Lanes> below = rowAt(y + 1 == sizeY ? 0 : y + 1);
+            Lanes out = rule.apply(above.west, above.cells, above.east, row.west, row.cells, row.east, below.west, below.cells, below.east) & mask;
+            store(next + y * BATCH_LANES + lane, out);
+            difference = difference | (out ^ load(saved + y * BATCH_LANES + lane, tag));
+            above = row;
+            row = below;
+        }
+        return zeroLanes(difference) << lane;
+    }
+
+    template <typename Rule>
+    std::uint32_t computeBatch(const BitRule& bitRule, const std::uint64_t* cells, std::uint64_t* next, const std::uint64_t* saved, std::size_t sizeX, std::size_t sizeY)
+    {
+        const Rule rule(bitRule);
+        std::uint32_t matches = 0;
+        std::size_t lane = 0;
+#if defined(__AVX512F__)
+        for (; lane + Avx512Lanes::WIDTH <= BATCH_LANES; lane += Avx512Lanes::WIDTH)
+        {
+            matches |= computeBatchLanes<Avx512Lanes>(rule, cells, next, saved, sizeX, sizeY, lane);
+        }
+#endif
+#if defined(__AVX2__)
+        for (; lane + Avx2Lanes::WIDTH <= BATCH_LANES; lane += Avx2Lanes::WIDTH)
+        {
+            matches |= computeBatchLanes<Avx2Lanes>(rule, cells, next, saved, sizeX, sizeY, lane);
+        }
+#endif
+        for (; lane < BATCH_LANES; ++lane)
+        {
+            matches |= computeBatchLanes<ScalarLanes>(rule, cells, next, saved, sizeX, sizeY, lane);
+        }
+        return matches;
+    }
+
+    // The span and batch kernels of a rule type
+    struct SpanKernels
+    {
+        using Kernel = SpanKernel;
+
+        template <typename Rule>
+        static Kernel get()
+        {
+            return &computeSpan<Rule>;
+        }
+    };
+
+    struct BatchKernels
+    {
+        using Kernel = BatchKernel;
+
+        template <typename Rule>
+        static Kernel get()
+        {
+            return &computeBatch<Rule>;
+        }
+    };
+
+    // Mask of the neighbor counts written in digits, as in "23"
+    constexpr std::uint16_t counts(const char* digits)
+    {
+        std::uint16_t mask = 0;
+        for (; *digits; ++digits)
+        {
+            mask = static_cast<std::uint16_t>(mask | (1 << (*digits - '0')));
+        }
+        return mask;
+    }
+
+    // Well-known rules get kernels of their own
+    template <typename Kernels>
+    typename Kernels::Kernel selectKernel(const BitRule& rule)
+    {
+        struct Compiled
+        {
+            BitRule rule;
+            typename Kernels::Kernel kernel;
+        };
+        static const Compiled compiled[] = {
+            { CONWAY_RULE, Kernels::template get<ConwayRule>() },
+            { { counts("36"), counts("23") }, Kernels::template get<StaticRule<counts("36"), counts("23")>>() },             // HighLife
+            { { counts("3678"), counts("34678") }, Kernels::template get<StaticRule<counts("3678"), counts("34678")>>() },   // Day & Night
+            { { counts("2"), counts("") }, Kernels::template get<StaticRule<counts("2"), counts("")>>() },                   // Seeds
+            { { counts("3"), counts("012345678") }, Kernels::template get<StaticRule<counts("3"), counts("012345678")>>() }, // Life without Death
+            { { counts("3"), counts("12345") }, Kernels::template get<StaticRule<counts("3"), counts("12345")>>() },         // Maze
+            { { counts("1357"), counts("1357") }, Kernels::template get<StaticRule<counts("1357"), counts("1357")>>() },     // Replicator
+            { { counts("36"), counts("125") }, Kernels::template get<StaticRule<counts("36"), counts("125")>>() },           // 2x2
+            { { counts("368"), counts("245") }, Kernels::template get<StaticRule<counts("368"), counts("245")>>() },         // Move
+            { { counts("2"), counts("345") }, Kernels::template get<StaticRule<counts("2"), counts("345")>>() },             // Star Wars
+        };
+
+        for (const auto& entry : compiled)
+        {
+            if (entry.rule.birth == rule.birth && entry.rule.survival == rule.survival)
+            {
+                return entry.kernel;
+            }
+        }
+        return Kernels::template get<TableRule>();
+    }
+}
+
+std::size_t wordsForCells(std::size_t cellCount)
+{
+    return (cellCount + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+}
+
+std::uint64_t lastWordMask(std::size_t sizeX)
+{
+    std::size_t usedBits = sizeX % CELLS_PER_WORD;
+    return usedBits ? (std::uint64_t(1) << usedBits) - 1 : ~std::uint64_t(0);
+}
+
+void fillBits(std::uint64_t* row, std::size_t firstBit, std::size_t count, bool value)
+{
+    std::size_t end = firstBit + count;
+    while (firstBit < end)
+    {
+        std::size_t bit = firstBit % CELLS_PER_WORD;
+        std::size_t length = std::min(CELLS_PER_WORD - bit, end - firstBit);
+        std::uint64_t mask = (length == CELLS_PER_WORD ? ~std::uint64_t(0) : (std::uint64_t(1) << length) - 1) << bit;
+        std::uint64_t& word = row[firstBit / CELLS_PER_WORD];
+        word = value ? (word | mask) : (word & ~mask);
+        firstBit += length;
+    }
+}
+
+void copyBits(std::uint64_t* dst, std::size_t dstBit, const std::uint64_t* src, std::size_t srcBit, std::size_t count)
+{
+    // One destination word per pass, gathered from at most two source words
+    std::size_t end = dstBit + count;
+    while (dstBit < end)
+    {
+        std::size_t bit = dstBit % CELLS_PER_WORD;
+        std::size_t length = std::min(CELLS_PER_WORD - bit, end - dstBit);
+        std::uint64_t mask = length == CELLS_PER_WORD ? ~std::uint64_t(0) : (std::uint64_t(1) << length) - 1;
+
+        std::size_t srcShift = srcBit % CELLS_PER_WORD;
+        const std::uint64_t* source = src + srcBit / CELLS_PER_WORD;
+        std::uint64_t bits = source[0] >> srcShift;
+        if (srcShift && srcShift + length > CELLS_PER_WORD)
+        {
+            bits |= source[1] << (CELLS_PER_WORD - srcShift);
+        }
+
+        std::uint64_t& word = dst[dstBit / CELLS_PER_WORD];
+        word = (word & ~(mask << bit)) | ((bits & mask) << bit);
+        dstBit += length;
+        srcBit += length;
+    }
+}
+
+bool computeNextRow(const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX)
+{
+    return computeNextSpan(above, row, below, out, sizeX, 0, wordsForCells(sizeX));
+}
+
+bool computeNextSpan(const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX, std::size_t beginWord, std::size_t endWord)
+{
+    return computeSpan<ConwayRule>(CONWAY_RULE, above, row, below, out, sizeX, beginWord, endWord, nullptr, 0);
+}
+
+SpanKernel selectSpanKernel(const BitRule& rule)
+{
+    return selectKernel<SpanKernels>(rule);
+}
+
+BatchKernel selectBatchKernel(const BitRule& rule)
+{
+    return selectKernel<BatchKernels>(rule);
+}
+
+std::uint64_t reduceCarryless(const CarrylessSum& sum)
+{
+    // x^64 is x^4 + x^3 + x + 1, and so are the few bits that shifting
+    // the high word by up to 4 pushes past bit 63
+    std::uint64_t high = sum.high ^ (sum.high >> 63) ^ (sum.high >> 61) ^ (sum.high >> 60);
+    return sum.low ^ high ^ (high << 1) ^ (high << 3) ^ (high << 4);
+}
+
+std::uint64_t multiplyInField(std::uint64_t a, std::uint64_t b)
+{
+    CarrylessSum product;
+    addCarrylessProduct(product, a, b);
+    return reduceCarryless(product);
+}
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+namespace
+{
+    // reduceCarryless() on the four 128-bit lanes at once; the reduced word
+    // is left in the low half of each lane
+    __m512i reduceCarrylessLanes(__m512i sums)
+    {
+        __m512i carried = _mm512_bsrli_epi128(sums, 8);
+        __m512i high = _mm512_ternarylogic_epi64(carried, _mm512_srli_epi64(carried, 63), _mm512_srli_epi64(carried, 61), 0x96);
+        high = _mm512_xor_si512(high, _mm512_srli_epi64(carried, 60));
+        __m512i low = _mm512_ternarylogic_epi64(sums, high, _mm512_slli_epi64(high, 1), 0x96);
+        return _mm512_ternarylogic_epi64(low, _mm512_slli_epi64(high, 3), _mm512_slli_epi64(high, 4), 0x96);
+    }
+}
+#endif
+
+std::uint64_t hashFlipSums(const FlipSums& sums, const std::uint64_t* wordKeys, std::size_t wordCount)
+{
+    // Each word's sum is reduced and multiplied by its word key only now, so
+    // a row costs a multiply per word and no more
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    // The even words' keys sit in the low half of each lane, the odd ones' in the high half
+    __m512i keys = _mm512_maskz_loadu_epi64(static_cast<__mmask8>((1u << wordCount) - 1), wordKeys);
+    __m512i even = reduceCarrylessLanes(_mm512_load_si512(sums.words + flipSlot(0)));
+    __m512i odd = reduceCarrylessLanes(_mm512_load_si512(sums.words + flipSlot(1)));
+    __m512i products = _mm512_xor_si512(_mm512_clmulepi64_epi128(even, keys, 0x00), _mm512_clmulepi64_epi128(odd, keys, 0x10));
+    __m256i halves = _mm256_xor_si256(_mm512_castsi512_si256(products), _mm512_extracti64x4_epi64(products, 1));
+    CarrylessSum sum;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&sum), _mm_xor_si128(_mm256_castsi256_si128(halves), _mm256_extracti128_si256(halves, 1)));
+    return reduceCarryless(sum);
+#else
+    std::uint64_t hash = 0;
+    for (std::size_t word = 0; word < wordCount; ++word)
+    {
+        hash ^= multiplyInField(reduceCarryless(sums.words[flipSlot(word)]), wordKeys[word]);
+    }
+    return hash;
+#endif
+}
+
+std::uint64_t hashFlips(const std::uint64_t* before, const std::uint64_t* after, std::size_t stride, const std::uint64_t* rowKeys, std::size_t rowCount,
+                        const std::uint64_t* wordKeys, std::size_t wordCount, std::uint64_t lastMask)
+{
+    // Up to eight columns of words at a time, each summing its flips times
+    // the row keys down the rows; only then is each column's sum reduced and
+    // multiplied by its word key, so a row costs a multiply per word and no more
+    const std::size_t COLUMNS = 8;
+    std::uint64_t hash = 0;
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    // Products of the column sums and their word keys, reduced once at the end
+    __m512i products = _mm512_setzero_si512();
+#endif
+    for (std::size_t first = 0; first < wordCount; first += COLUMNS)
+    {
+        std::size_t columnCount = std::min(COLUMNS, wordCount - first);
+        bool endsRow = first + columnCount == wordCount;
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+        // Each 128-bit lane multiplies its even word, then its odd one. The
+        // multiplies are what bound the loop, so nothing else is done per
+        // row that can be avoided: two rows' products are summed in one go,
+        // only a partial group masks its loads, and only the group that ends
+        // the row masks its last word.
+        auto columns = static_cast<__mmask8>((1u << columnCount) - 1);
+        bool fullGroup = columnCount == COLUMNS;
+        __m512i masks = _mm512_set1_epi64(-1);
+        if (endsRow)
+        {
+            masks = _mm512_mask_set1_epi64(masks, static_cast<__mmask8>(1u << (columnCount - 1)), static_cast<long long>(lastMask));
+        }
+        auto loadWords = [&](const std::uint64_t* words) { return fullGroup ? _mm512_loadu_si512(words) : _mm512_maskz_loadu_epi64(columns, words); };
+        auto loadFlips = [&](std::size_t row) {
+            __m512i flips = _mm512_xor_si512(loadWords(before + row * stride + first), loadWords(after + row * stride + first));
+            return endsRow ? _mm512_and_si512(flips, masks) : flips;
+        };
+        __m512i even = _mm512_setzero_si512();
+        __m512i odd = _mm512_setzero_si512();
+        std::size_t row = 0;
+        for (; row + 2 <= rowCount; row += 2)
+        {
+            __m512i flips = loadFlips(row);
+            __m512i nextFlips = loadFlips(row + 1);
+            __m512i key = _mm512_set1_epi64(static_cast<long long>(rowKeys[row]));
+            __m512i nextKey = _mm512_set1_epi64(static_cast<long long>(rowKeys[row + 1]));
+            even = _mm512_ternarylogic_epi64(even, _mm512_clmulepi64_epi128(flips, key, 0x00), _mm512_clmulepi64_epi128(nextFlips, nextKey, 0x00), 0x96);
+            odd = _mm512_ternarylogic_epi64(odd, _mm512_clmulepi64_epi128(flips, key, 0x01), _mm512_clmulepi64_epi128(nextFlips, nextKey, 0x01), 0x96);
+        }
+        if (row < rowCount)
+        {
+            __m512i flips = loadFlips(row);
+            __m512i key = _mm512_set1_epi64(static_cast<long long>(rowKeys[row]));
+            even = _mm512_xor_si512(even, _mm512_clmulepi64_epi128(flips, key, 0x00));
+            odd = _mm512_xor_si512(odd, _mm512_clmulepi64_epi128(flips, key, 0x01));
+        }
+
+        // The even words' keys sit in the low half of each lane, the odd ones' in the high half
+        __m512i keys = _mm512_maskz_loadu_epi64(columns, wordKeys + first);
+        products = _mm512_ternarylogic_epi64(products, _mm512_clmulepi64_epi128(reduceCarrylessLanes(even), keys, 0x00),
+                                             _mm512_clmulepi64_epi128(reduceCarrylessLanes(odd), keys, 0x10), 0x96);
+#else
+        CarrylessSum sums[COLUMNS];
+        for (std::size_t row = 0; row < rowCount; ++row)
+        {
+            const std::uint64_t* at = before + row * stride + first;
+            const std::uint64_t* to = after + row * stride + first;
+            for (std::size_t column = 0; column < columnCount; ++column)
+            {
+                std::uint64_t flips = at[column] ^ to[column];
+                addCarrylessProduct(sums[column], endsRow && column + 1 == columnCount ? flips & lastMask : flips, rowKeys[row]);
+            }
+        }
+
+        for (std::size_t column = 0; column < columnCount; ++column)
+        {
+            hash ^= multiplyInField(reduceCarryless(sums[column]), wordKeys[first + column]);
+        }
+#endif
+    }
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    __m256i halves = _mm256_xor_si256(_mm512_castsi512_si256(products), _mm512_extracti64x4_epi64(products, 1));
+    CarrylessSum sum;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&sum), _mm_xor_si128(_mm256_castsi256_si128(halves), _mm256_extracti128_si256(halves, 1)));
+    hash = reduceCarryless(sum);
+#endif
+    return hash;
+}
+
+BlockCensus takeCensus(const std::uint64_t* rows, std::size_t stride, std::size_t rowCount, std::size_t wordCount, std::uint64_t lastMask)
+{
+    // Up to eight columns of words at a time: counting their cells, and ORing
+    // the rows together to find the leftmost and rightmost live cell
+    const std::size_t COLUMNS = 8;
+
+    BlockCensus census;
+    for (std::size_t first = 0; first < wordCount; first += COLUMNS)
+    {
+        std::size_t columnCount = std::min(COLUMNS, wordCount - first);
+        bool endsRow = first + columnCount == wordCount;
+        std::uint64_t columns[COLUMNS] = {};
+
+#if defined(__AVX512VPOPCNTDQ__)
+        auto lanes = static_cast<__mmask8>((1u << columnCount) - 1);
+        __m512i masks = _mm512_set1_epi64(-1);
+        if (endsRow)
+        {
+            masks = _mm512_mask_set1_epi64(masks, static_cast<__mmask8>(1u << (columnCount - 1)), static_cast<long long>(lastMask));
+        }
+        // Kept in registers rather than in the census across the row loop
+        std::uint32_t firstRow = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t lastRow = 0;
+        __m512i counts = _mm512_setzero_si512();
+        __m512i columnCells = _mm512_setzero_si512();
+        for (std::size_t row = 0; row < rowCount; ++row)
+        {
+            __m512i cells = _mm512_and_si512(_mm512_maskz_loadu_epi64(lanes, rows + row * stride + first), masks);
+            counts = _mm512_add_epi64(counts, _mm512_popcnt_epi64(cells));
+            columnCells = _mm512_or_si512(columnCells, cells);
+            if (_mm512_test_epi64_mask(cells, cells))
+            {
+                firstRow = std::min(firstRow, static_cast<std::uint32_t>(row));
+                lastRow = static_cast<std::uint32_t>(row);
+            }
+        }
+        if (firstRow <= lastRow)
+        {
+            census.box.minY = std::min(census.box.minY, firstRow);
+            census.box.maxY = std::max(census.box.maxY, lastRow);
+        }
+        census.population += static_cast<std::uint32_t>(_mm512_reduce_add_epi64(counts));
+        _mm512_storeu_si512(columns, columnCells);
+#else
+        for (std::size_t row = 0; row < rowCount; ++row)
+        {
+            const std::uint64_t* words = rows + row * stride + first;
+            std::uint64_t rowCells = 0;
+            for (std::size_t column = 0; column < columnCount; ++column)
+            {
+                std::uint64_t cells = endsRow && column + 1 == columnCount ? words[column] & lastMask : words[column];
+                census.population += countSetBits(cells);
+                columns[column] |= cells;
+                rowCells |= cells;
+            }
+            if (rowCells)
+            {
+                census.box.minY = std::min(census.box.minY, static_cast<std::uint32_t>(row));
+                census.box.maxY = std::max(census.box.maxY, static_cast<std::uint32_t>(row));
+            }
+        }
+#endif
+
+        for (std::size_t column = 0; column < columnCount; ++column)
+        {
+            std::uint64_t cells = columns[column];
+            if (!cells)
+            {
+                continue;
+            }
+
+            // The lowest set bit is the count of zeros below it; smearing the
+            // highest one down makes it the count of bits set, less one
+            auto x = static_cast<std::uint32_t>((first + column) * CELLS_PER_WORD);
+            census.box.minX = std::min(census.box.minX, x + countSetBits((cells & (0 - cells)) - 1));
+            for (unsigned shift = 1; shift < 64; shift *= 2)
+            {
+                cells |= cells >> shift;
+            }
+            census.box.maxX = std::max(census.box.maxX, x + countSetBits(cells) - 1);
+        }
+    }
+    return census;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+#if defined(__PCLMUL__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #include <immintrin.h>
+#endif
+
+// Rows are bit-packed 64 cells to a word: cell x lives in bit x % 64 of word x / 64.
+// Bits past sizeX in the last word are kept clear, apart from the halo copy of
+// x = 0 that LifeBoard keeps at bit sizeX.
+const std::size_t CELLS_PER_WORD = 64;
+
+std::size_t wordsForCells(std::size_t cellCount);
+// Mask of the bits of the last word in a row that hold cells
+std::uint64_t lastWordMask(std::size_t sizeX);
+
+// Sets bits [firstBit, firstBit + count) of a packed row, a word at a time
+void fillBits(std::uint64_t* row, std::size_t firstBit, std::size_t count, bool value);
+// Overwrites bits [dstBit, dstBit + count) of dst with bits [srcBit, srcBit + count) of src
+void copyBits(std::uint64_t* dst, std::size_t dstBit, const std::uint64_t* src, std::size_t srcBit, std::size_t count);
+inline std::uint32_t countSetBits(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    return static_cast<std::uint32_t>(__popcnt64(word));
+#else
+    return static_cast<std::uint32_t>(__builtin_popcountll(word));
+#endif
+}
+
+// Smallest rectangle holding a set of live cells, corners included. It is
+// empty, with minX > maxX, if none live.
+struct BoundingBox
+{
+    std::uint32_t minX = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t minY = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t maxX = 0;
+    std::uint32_t maxY = 0;
+
+    bool isEmpty() const { return minX > maxX; }
+};
+
+// Live cells of a block of words: how many there are, and where, in cells
+// from the block's corner
+struct BlockCensus
+{
+    std::uint32_t population = 0;
+    BoundingBox box;
+};
+
+// Census of a block of wordCount words by rowCount rows, rows stride words
+// apart. The last word of each row is masked with lastMask first.
+BlockCensus takeCensus(const std::uint64_t* rows, std::size_t stride, std::size_t rowCount, std::size_t wordCount, std::uint64_t lastMask);
+
+// XOR of carry-less products of words, 127 bits wide, not yet reduced to an
+// element of GF(2^64). Board hashes are sums of such products.
+struct CarrylessSum
+{
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+};
+
+inline void addCarrylessProduct(CarrylessSum& sum, std::uint64_t a, std::uint64_t b)
+{
+#if defined(__PCLMUL__) || (defined(_MSC_VER) && defined(__AVX2__))
+    __m128i product = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(a)), _mm_cvtsi64_si128(static_cast<long long>(b)), 0);
+    sum.low ^= static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+    sum.high ^= static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(product, product)));
+#else
+    // Without a carry-less multiply instruction, four bits of a at a time
+    // from a table of the products of b and every four bits
+    CarrylessSum multiples[16];
+    for (unsigned i = 1; i < 16; ++i)
+    {
+        const CarrylessSum& half = multiples[i / 2];
+        multiples[i].low = (half.low << 1) ^ (i & 1 ? b : 0);
+        multiples[i].high = (half.high << 1) | (half.low >> 63);
+    }
+    sum.low ^= multiples[a & 15].low;
+    sum.high ^= multiples[a & 15].high;
+    for (unsigned shift = 4; shift < 64; shift += 4)
+    {
+        const CarrylessSum& multiple = multiples[(a >> shift) & 15];
+        sum.low ^= multiple.low << shift;
+        sum.high ^= (multiple.high << shift) | (multiple.low >> (64 - shift));
+    }
+#endif
+}
+
+// Reduces modulo x^64 + x^4 + x^3 + x + 1, to an element of GF(2^64)
+std::uint64_t reduceCarryless(const CarrylessSum& sum);
+// Product of a and b in GF(2^64)
+std::uint64_t multiplyInField(std::uint64_t a, std::uint64_t b);
+
+// Words a FlipSums holds
+const std::size_t FLIP_SUM_WORDS = 8;
+
+// For each of up to FLIP_SUM_WORDS words across a block of rows, the sum
+// down the rows of the word's flips times its row's key, not yet reduced.
+// Word w's sum is at flipSlot(w): the even words come first, then the odd
+// ones, the order a 512-bit carry-less multiply leaves them in.
+struct alignas(64) FlipSums
+{
+    CarrylessSum words[FLIP_SUM_WORDS];
+};
+static_assert(sizeof(CarrylessSum) == 16, "CarrylessSum must be laid out as a 128-bit lane");
+
+inline std::size_t flipSlot(std::size_t word)
+{
+    return word % 2 * (FLIP_SUM_WORDS / 2) + word / 2;
+}
+
+inline void addWordFlips(FlipSums& sums, std::size_t word, std::uint64_t flips, std::uint64_t rowKey)
+{
+    addCarrylessProduct(sums.words[flipSlot(word)], flips, rowKey);
+}
+
+// The sum over the first wordCount words of sums of each one's sum times
+// wordKeys[word] in GF(2^64)
+std::uint64_t hashFlipSums(const FlipSums& sums, const std::uint64_t* wordKeys, std::size_t wordCount);
+
+// Hash of the cells that differ between two blocks of wordCount words by
+// rowCount rows, rows stride words apart: the sum over the words of
+// (before ^ after) * rowKeys[row] * wordKeys[word] in GF(2^64). The last
+// word of each row is masked with lastMask first.
+std::uint64_t hashFlips(const std::uint64_t* before, const std::uint64_t* after, std::size_t stride, const std::uint64_t* rowKeys, std::size_t rowCount,
+                        const std::uint64_t* wordKeys, std::size_t wordCount, std::uint64_t lastMask);
+
+// A two-state rule on the eight-cell neighborhood: bit k of birth (survival)
+// is set if a dead (live) cell with k live neighbors is alive next generation
+struct BitRule
+{
+    std::uint16_t birth;
+    std::uint16_t survival;
+};
+
+const BitRule CONWAY_RULE = { 1 << 3, (1 << 2) | (1 << 3) };
+
+// Computes the next generation of one row of a torus under Conway's rule.
+// above and below are the (already wrapped) neighboring rows, and every input
+// row must have its halo in place, see LifeBoard. out must not alias any input
+// row. Returns true if any cell changed.
+bool computeNextRow(const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX);
+// Same as computeNextRow, for words [beginWord, endWord) of the row only
+bool computeNextSpan(const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX, std::size_t beginWord, std::size_t endWord);
+
+// Same as computeNextSpan, under any two-state rule. Given flipSums, it
+// also adds the cells that change times rowKey to them, word beginWord
+// being their word 0, so the span is hashed while its words are still in
+// registers. The span must then be at most FLIP_SUM_WORDS words, and must
+// not end the row, whose last word is masked on its own.
+using SpanKernel = bool (*)(const BitRule& rule, const std::uint64_t* above, const std::uint64_t* row, const std::uint64_t* below, std::uint64_t* out, std::size_t sizeX, std::size_t beginWord, std::size_t endWord,
+                            FlipSums* flipSums, std::uint64_t rowKey);
+
+// The kernel to step a rule with. Conway's rule and a few other well-known
+// ones have the rule compiled in; any other reads it from a table.
+SpanKernel selectSpanKernel(const BitRule& rule);
+
+// Boards a batch kernel steps at once, one per lane
+const std::size_t BATCH_LANES = 8;
+
+// Steps a group of BATCH_LANES boards of sizeX (at most 64) by sizeY cells,
+// each a torus of its own, from cells into next. Row y of board i is word
+// y * BATCH_LANES + i, with the bits past sizeX clear. Returns the mask of
+// the boards whose next generation is the same as in saved, laid out alike.
+using BatchKernel = std::uint32_t (*)(const BitRule& rule, const std::uint64_t* cells, std::uint64_t* next, const std::uint64_t* saved, std::size_t sizeX, std::size_t sizeY);
+
+// Same as selectSpanKernel, for batches
+BatchKernel selectBatchKernel(const BitRule& rule);
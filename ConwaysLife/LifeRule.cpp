@@ -0,0 +1,285 @@
+#include "LifeRule.hpp"
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const std::uint32_t MAX_RADIUS = 100;
+    const std::uint32_t MAX_STATES = 256;
+
+    std::vector<std::string> split(const std::string& text, char separator)
+    {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator))
+        {
+            parts.push_back(part);
+        }
+        if (!text.empty() && text.back() == separator)
+        {
+            parts.emplace_back();
+        }
+        return parts;
+    }
+
+    std::uint32_t parseNumber(const std::string& text, const std::string& notation)
+    {
+        if (text.empty() || text.size() > 9)
+        {
+            throw std::invalid_argument("Bad number in rule " + notation);
+        }
+        std::uint32_t value = 0;
+        for (char c : text)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(c)))
+            {
+                throw std::invalid_argument("Bad number in rule " + notation);
+            }
+            value = value * 10 + static_cast<std::uint32_t>(c - '0');
+        }
+        return value;
+    }
+
+    // Sets the counts listed digit by digit, as in "23"
+    void parseDigits(const std::string& digits, std::vector<bool>& counts, const std::string& notation)
+    {
+        for (char c : digits)
+        {
+            if (c < '0' || c > '8')
+            {
+                throw std::invalid_argument("Bad neighbor count in rule " + notation);
+            }
+            counts[static_cast<std::size_t>(c - '0')] = true;
+        }
+    }
+
+    // Appends the counts set in counts as "lo..hi"; they are always one run
+    void appendRange(std::ostringstream& out, const std::vector<bool>& counts, std::uint32_t offset)
+    {
+        std::size_t first = 0;
+        while (first < counts.size() && !counts[first])
+        {
+            ++first;
+        }
+        if (first == counts.size())
+        {
+            return;
+        }
+        std::size_t last = counts.size() - 1;
+        while (!counts[last])
+        {
+            --last;
+        }
+        out << first + offset << ".." << last + offset;
+    }
+}
+
+LifeRule::LifeRule() :
+    birth(9, false),
+    survival(9, false)
+{
+    birth[3] = true;
+    survival[2] = true;
+    survival[3] = true;
+}
+
+LifeRule LifeRule::parse(const std::string& notation)
+{
+    if (!notation.empty() && (notation[0] == 'R' || notation[0] == 'r'))
+    {
+        return parseLargerThanLife(notation);
+    }
+    return parseOuterTotalistic(notation);
+}
+
+LifeRule LifeRule::parseOuterTotalistic(const std::string& notation)
+{
+    LifeRule rule;
+    rule.birth.assign(9, false);
+    rule.survival.assign(9, false);
+
+    std::vector<std::string> parts = split(notation, '/');
+    if (parts.size() < 2 || parts.size() > 3)
+    {
+        throw std::invalid_argument("Expected B/S or S/B/C notation, got " + notation);
+    }
+
+    bool lettered = !parts[0].empty() && std::isalpha(static_cast<unsigned char>(parts[0][0]));
+    bool sawBirth = false;
+    bool sawSurvival = false;
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        const std::string& part = parts[i];
+        char kind = lettered ? static_cast<char>(std::toupper(static_cast<unsigned char>(part.empty() ? ' ' : part[0]))) : "SBC"[i];
+        std::string value = lettered ? part.substr(part.empty() ? 0 : 1) : part;
+
+        if (kind == 'B' && !sawBirth)
+        {
+            parseDigits(value, rule.birth, notation);
+            sawBirth = true;
+        }
+        else if (kind == 'S' && !sawSurvival)
+        {
+            parseDigits(value, rule.survival, notation);
+            sawSurvival = true;
+        }
+        else if ((kind == 'C' || kind == 'G') && i == 2)
+        {
+            rule.stateCount = parseNumber(value, notation);
+            if (rule.stateCount < 2 || rule.stateCount > MAX_STATES)
+            {
+                throw std::invalid_argument("State count out of range in rule " + notation);
+            }
+        }
+        else
+        {
+            throw std::invalid_argument("Bad part \"" + part + "\" in rule " + notation);
+        }
+    }
+
+    if (!sawBirth || !sawSurvival)
+    {
+        throw std::invalid_argument("Rule needs both B and S parts: " + notation);
+    }
+    return rule;
+}
+
+LifeRule LifeRule::parseLargerThanLife(const std::string& notation)
+{
+    std::uint32_t radius = 0;
+    bool middle = false;
+    bool sawBirth = false;
+    bool sawSurvival = false;
+    std::uint32_t ranges[2][2] = {};
+
+    for (const std::string& part : split(notation, ','))
+    {
+        char kind = static_cast<char>(std::toupper(static_cast<unsigned char>(part.empty() ? ' ' : part[0])));
+        std::string value = part.empty() ? part : part.substr(1);
+        if (kind == 'R')
+        {
+            radius = parseNumber(value, notation);
+        }
+        else if (kind == 'C')
+        {
+            std::uint32_t states = parseNumber(value, notation);
+            if (states > 2)
+            {
+                throw std::invalid_argument("Larger than Life rules with more than two states are not supported: " + notation);
+            }
+        }
+        else if (kind == 'M')
+        {
+            middle = parseNumber(value, notation) != 0;
+        }
+        else if (kind == 'N')
+        {
+            if (value != "M" && value != "m")
+            {
+                throw std::invalid_argument("Only the Moore (NM) neighborhood is supported: " + notation);
+            }
+        }
+        else if (kind == 'S' || kind == 'B')
+        {
+            // An empty range, as toString() writes for no counts at all
+            std::uint32_t* range = ranges[kind == 'B'];
+            range[0] = 1;
+            range[1] = 0;
+            if (!value.empty())
+            {
+                std::size_t dots = value.find("..");
+                range[0] = parseNumber(value.substr(0, dots), notation);
+                range[1] = dots == std::string::npos ? range[0] : parseNumber(value.substr(dots + 2), notation);
+            }
+            (kind == 'B' ? sawBirth : sawSurvival) = true;
+        }
+        else
+        {
+            throw std::invalid_argument("Bad part \"" + part + "\" in rule " + notation);
+        }
+    }
+
+    if (radius < 1 || radius > MAX_RADIUS || !sawBirth || !sawSurvival)
+    {
+        throw std::invalid_argument("Larger than Life rule needs R1 to R100, S and B: " + notation);
+    }
+
+    // Counts are stored without the cell itself, so with M1 a live cell's
+    // count is one less than the one written
+    LifeRule rule;
+    rule.radius = radius;
+    std::uint32_t maxCount = (2 * radius + 1) * (2 * radius + 1) - 1;
+    rule.birth.assign(maxCount + 1, false);
+    rule.survival.assign(maxCount + 1, false);
+    for (std::uint32_t count = 0; count <= maxCount; ++count)
+    {
+        std::uint32_t written = count + (middle ? 1 : 0);
+        rule.survival[count] = written >= ranges[0][0] && written <= ranges[0][1];
+        rule.birth[count] = count >= ranges[1][0] && count <= ranges[1][1];
+    }
+    return rule;
+}
+
+std::uint16_t LifeRule::getBirthMask() const
+{
+    std::uint16_t mask = 0;
+    for (std::uint32_t count = 0; count < 9 && count < birth.size(); ++count)
+    {
+        mask |= static_cast<std::uint16_t>(birth[count] << count);
+    }
+    return mask;
+}
+
+std::uint16_t LifeRule::getSurvivalMask() const
+{
+    std::uint16_t mask = 0;
+    for (std::uint32_t count = 0; count < 9 && count < survival.size(); ++count)
+    {
+        mask |= static_cast<std::uint16_t>(survival[count] << count);
+    }
+    return mask;
+}
+
+std::string LifeRule::toString() const
+{
+    std::ostringstream out;
+    if (radius > 1)
+    {
+        out << "R" << radius << ",C0,M0,S";
+        appendRange(out, survival, 0);
+        out << ",B";
+        appendRange(out, birth, 0);
+        out << ",NM";
+        return out.str();
+    }
+
+    out << "B";
+    for (std::uint32_t count = 0; count <= 8; ++count)
+    {
+        if (birth[count])
+        {
+            out << count;
+        }
+    }
+    out << "/S";
+    for (std::uint32_t count = 0; count <= 8; ++count)
+    {
+        if (survival[count])
+        {
+            out << count;
+        }
+    }
+    if (stateCount > 2)
+    {
+        out << "/C" << stateCount;
+    }
+    return out.str();
+}
+
+bool LifeRule::operator==(const LifeRule& other) const
+{
+    return radius == other.radius && stateCount == other.stateCount && birth == other.birth && survival == other.survival;
+}
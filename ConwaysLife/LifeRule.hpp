@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A totalistic cellular automaton rule: whether a cell is born or survives
+// depends only on how many live cells surround it. Three families are read:
+//  - "B3/S23" (or "23/3"): two states, the 8 cell neighborhood
+//  - "B2/S345/C4" (or "345/2/4"): Generations, in which a cell that stops
+//    surviving spends C - 2 generations dying before it is dead. Dying cells
+//    are not counted as neighbors and cannot be born.
+//  - "R5,C0,M1,S34..58,B34..45,NM": Larger than Life, in which the
+//    neighborhood is the (2R + 1)^2 square, M1 counting the cell itself
+class LifeRule
+{
+  public:
+    // Conway's rule, B3/S23
+    LifeRule();
+
+    // Throws std::invalid_argument if the notation is not one of the above
+    static LifeRule parse(const std::string& notation);
+
+    std::uint32_t getRadius() const { return radius; }
+    // 2 for two-state rules, more for Generations
+    std::uint32_t getStateCount() const { return stateCount; }
+    // Largest neighbor count, not counting the cell itself
+    std::uint32_t getMaxCount() const { return static_cast<std::uint32_t>(birth.size() - 1); }
+
+    bool isBorn(std::uint32_t count) const { return count < birth.size() && birth[count]; }
+    bool survives(std::uint32_t count) const { return count < survival.size() && survival[count]; }
+
+    // For radius 1 rules: bit k is set if a cell with k neighbors is born, or survives
+    std::uint16_t getBirthMask() const;
+    std::uint16_t getSurvivalMask() const;
+
+    std::string toString() const;
+
+    bool operator==(const LifeRule& other) const;
+    bool operator!=(const LifeRule& other) const { return !(*this == other); }
+
+  private:
+    std::uint32_t radius = 1;
+    std::uint32_t stateCount = 2;
+    // Indexed by neighbor count
+    std::vector<bool> birth;
+    std::vector<bool> survival;
+
+    static LifeRule parseLargerThanLife(const std::string& notation);
+    static LifeRule parseOuterTotalistic(const std::string& notation);
+};
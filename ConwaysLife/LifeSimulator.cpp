@@ -1,162 +1,962 @@
 #include "LifeSimulator.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
-LifeSimulator::LifeSimulator(std::uint8_t sizeX, std::uint8_t sizeY)
+namespace
 {
-    field.resize(sizeX, std::vector<bool>(sizeY, false));
+    // Keys are the same for every run, so hashes of equal boards compare equal across runs
+    const std::uint64_t HASH_KEY_SEED = 0x5DEECE66D;
+    // 256 states leave ages up to 254, which take 8 bit planes
+    const std::uint32_t MAX_AGE_PLANES = 8;
+
+    // The MurmurHash3 finalizer: every bit of the input flips about half the output
+    std::uint64_t mixBits(std::uint64_t bits)
+    {
+        bits ^= bits >> 33;
+        bits *= 0xFF51AFD7ED558CCD;
+        bits ^= bits >> 33;
+        bits *= 0xC4CEB9FE1A85EC53;
+        bits ^= bits >> 33;
+        return bits;
+    }
+}
+
+LifeSimulator::LifeSimulator(std::uint32_t sizeX, std::uint32_t sizeY, const LifeRule& rule) :
+    board(std::make_shared<LifeBoard>(sizeX, sizeY)),
+    nextBoard(std::make_shared<LifeBoard>(sizeX, sizeY)),
+    tilesX((board->getWordsPerRow() + TILE_WORDS - 1) / TILE_WORDS),
+    tilesY((static_cast<std::size_t>(sizeY) + TILE_ROWS - 1) / TILE_ROWS)
+{
+    // Sized up front so stepping never grows them
+    std::size_t tileCount = getTileCount();
+    activeTiles.reserve(tileCount);
+    nextActiveTiles.reserve(tileCount);
+    tileChanged.resize(tileCount, 0);
+    tileQueued.resize(tileCount, 0);
+    tileHashes.resize(tileCount, 0);
+    tileCensus.resize(tileCount);
+    populationChanges.resize(tileCount, 0);
+#if defined(LIFE_INSTRUMENTATION)
+    tileProfiles.resize(tileCount, TileProfile());
+#endif
+    bandQueued.resize(tilesY, 0);
+    activeBands.reserve(tilesY);
+
+    setRule(rule);
 }
 
-void LifeSimulator::insertPattern(const Pattern& pattern, std::uint8_t startX, std::uint8_t startY)
+void LifeSimulator::insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY)
 {
-    // Sensible defaults
-    std::uint8_t sizeX = getSizeX();
-    if (startX >= sizeX)
+    Placement placement;
+    if (!placePattern(pattern.getSizeX(), pattern.getSizeY(), startX, startY, placement))
+    {
+        return;
+    }
+
+    patternRow.resize(wordsForCells(pattern.getSizeX()));
+    for (std::uint32_t y = 0; y < placement.height; ++y)
     {
-        startX = sizeX - 1;
+        pattern.getRow(y, patternRow.data());
+        stampRow(placement, y, patternRow.data());
     }
+    finishPattern(placement);
+}
 
-    std::uint8_t sizeY = getSizeY();
-    if (startY >= sizeY)
+void LifeSimulator::update()
+{
+    if (getSizeX() && getSizeY())
     {
-        startY = sizeY - 1;
+        stepGeneration();
     }
+}
 
-    // Calculate end coordinates given pattern size and starting coordinates
-    std::uint8_t patternSizeX = pattern.getSizeX();
-    std::uint8_t patternSizeY = pattern.getSizeY();
+void LifeSimulator::advance(std::uint64_t generations)
+{
+    step(generations, StepControl());
+}
 
-    decltype(startX) endX = ((startX + patternSizeX - 1) < sizeX) ? (startX + patternSizeX - 1) : sizeX - 1;
-    decltype(startX) endY = ((startY + patternSizeY - 1) < sizeY) ? (startY + patternSizeY - 1) : sizeY - 1;
+std::uint64_t LifeSimulator::step(std::uint64_t generations, const StepControl& control)
+{
+    if (!getSizeX() || !getSizeY())
+    {
+        return 0;
+    }
 
-    // Add pattern
-    for (auto x = startX; x <= endX; ++x)
+    std::uint64_t done = 0;
+    while (done < generations && !control.isCancelled())
     {
-        for (auto y = startY; y <= endY; ++y)
+        std::uint64_t chunkEnd = done + control.getChunk(done, generations);
+        while (done < chunkEnd && !control.isCancelled())
         {
-            field[x][y] = pattern.getCell(x - startX, y - startY);
+            stepGeneration();
+            ++done;
         }
+        control.report(done);
     }
+    return done;
 }
 
-void LifeSimulator::update()
+void LifeSimulator::stepGeneration()
+{
+    LIFE_INSTRUMENT(profile.startGeneration());
+    detachBoard(nextBoard);
+
+    if (cycleWindow && !hashValid)
+    {
+        boardHash = computeHash();
+        cycles.reset();
+        cycles.record(boardHash, generation);
+        hashValid = true;
+    }
+
+    if (rule.getRadius() > 1)
+    {
+        LIFE_LAP_PHASE(profile, UpdatePhase::Prepare);
+        updateLargerThanLife();
+        LIFE_LAP_PHASE(profile, UpdatePhase::LargerThanLife);
+        ++generation;
+        recordHash(std::accumulate(tileHashes.begin(), tileHashes.end(), std::uint64_t(0), std::bit_xor<std::uint64_t>()));
+#if defined(LIFE_INSTRUMENTATION)
+        LIFE_LAP_PHASE(profile, UpdatePhase::Cycles);
+        for (std::uint32_t tile = 0; tile < getTileCount(); ++tile)
+        {
+            addTileProfile(tile);
+        }
+        profile.endGeneration();
+#endif
+        return;
+    }
+
+    // After an outside change the two boards are out of step, so evaluate
+    // everything once. Outside sparse mode the list stays that way. The halo
+    // is written here, so a board a snapshot still reads is copied first.
+    if (allTilesActive)
+    {
+        detachBoard(board);
+        board->refreshHalo();
+        activeTiles.resize(getTileCount());
+        std::iota(activeTiles.begin(), activeTiles.end(), 0);
+        allTilesActive = false;
+    }
+    LIFE_LAP_PHASE(profile, UpdatePhase::Prepare);
+
+    runTasks(activeTiles.size(), [this](std::size_t task) { updateTile(activeTiles[task]); });
+
+    std::uint64_t hashChange = 0;
+    for (auto tile : activeTiles)
+    {
+        hashChange ^= tileHashes[tile];
+        population += static_cast<std::uint64_t>(populationChanges[tile]);
+        LIFE_INSTRUMENT(addTileProfile(tile));
+    }
+    LIFE_LAP_PHASE(profile, UpdatePhase::Tiles);
+
+    refreshActiveHalo();
+    std::swap(board, nextBoard);
+    LIFE_LAP_PHASE(profile, UpdatePhase::Halo);
+
+    activeTileCount = activeTiles.size();
+    if (sparse)
+    {
+        queueChangedNeighborhoods();
+    }
+    LIFE_LAP_PHASE(profile, UpdatePhase::Activity);
+
+    ++generation;
+    recordHash(hashChange);
+    LIFE_LAP_PHASE(profile, UpdatePhase::Cycles);
+    LIFE_INSTRUMENT(profile.endGeneration());
+}
+
+std::uint64_t LifeSimulator::getGeneration() const
+{
+    return generation;
+}
+
+void LifeSimulator::updateTile(std::uint32_t tile)
+{
+    std::uint32_t sizeX = getSizeX();
+    std::size_t beginWord;
+    std::size_t endWord;
+    std::uint32_t beginY;
+    std::uint32_t endY;
+    getTileSpan(tile, beginWord, endWord, beginY, endY);
+    LIFE_INSTRUMENT(std::uint64_t kernelStart = UpdateProfile::now());
+
+    // The rows and words just outside the tile are its halo; they are read
+    // straight from the board, which is not written until every tile is done
+    bool changed = false;
+    // Cells and ages that change, summed down the tile for each word (and
+    // plane) as the rows are computed. Generations rules change cells after
+    // the kernel, so their cells are summed by ageRow() instead. The kernel
+    // does not sum the tiles that end the row; surveyTile() hashes their
+    // flips from the board.
+    static_assert(TILE_WORDS <= FLIP_SUM_WORDS, "A tile's span must fit in FlipSums");
+    FlipSums cellFlips;
+    FlipSums ageFlips[MAX_AGE_PLANES];
+    bool kernelSums = cycleWindow && !agePlaneCount && endWord != board->getWordsPerRow();
+    FlipSums* kernelFlips = kernelSums ? &cellFlips : nullptr;
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        bool rowChanged = spanKernel(bitRule, board->getRow(std::int64_t(y) - 1), board->getRow(y), board->getRow(y + 1), nextBoard->getRow(y), sizeX, beginWord, endWord,
+                                     kernelFlips, kernelFlips ? rowKeys[y] : 0);
+        changed |= agePlaneCount ? ageRow(y, beginWord, endWord, cellFlips, ageFlips) : rowChanged;
+    }
+
+    tileChanged[tile] = changed;
+    LIFE_INSTRUMENT(tileProfiles[tile].kernelTime = UpdateProfile::now() - kernelStart);
+    if (changed)
+    {
+        surveyTile(tile, kernelSums || agePlaneCount ? &cellFlips : nullptr, ageFlips);
+    }
+    else
+    {
+        populationChanges[tile] = 0;
+        tileHashes[tile] = 0;
+        LIFE_INSTRUMENT(tileProfiles[tile].surveyTime = 0);
+        LIFE_INSTRUMENT(tileProfiles[tile].cellsChanged = 0);
+    }
+}
+
+void LifeSimulator::surveyTile(std::uint32_t tile, const FlipSums* cellFlips, const FlipSums* ageFlips)
 {
-    const std::uint8_t UNDERPOP_THRESH = 2;
-    const std::uint8_t OVERPOP_THRESH = 3;
+    // The tile's census and hash change by the cells it now holds on nextBoard
+    std::size_t beginWord;
+    std::size_t endWord;
+    std::uint32_t beginY;
+    std::uint32_t endY;
+    getTileSpan(tile, beginWord, endWord, beginY, endY);
+    LIFE_INSTRUMENT(std::uint64_t surveyStart = UpdateProfile::now());
 
-    // Find Coordinate to update
-    std::vector<Coordinate> liveCoordinate;
-    std::vector<Coordinate> deadCoordinate;
+    BlockCensus census = takeTileCensus(*nextBoard, tile);
+    populationChanges[tile] = std::int64_t(census.population) - std::int64_t(tileCensus[tile].population);
+    tileCensus[tile] = census;
 
-    std::uint8_t sizeX = getSizeX();
-    std::uint8_t sizeY = getSizeY();
-    for (std::uint8_t x = 0; x < sizeX; ++x)
+    std::uint64_t hashChange = 0;
+    if (cycleWindow)
     {
-        for (std::uint8_t y = 0; y < sizeY; ++y)
+        const std::uint64_t* keys = wordKeys.data() + beginWord;
+        hashChange = cellFlips ? hashFlipSums(*cellFlips, keys, endWord - beginWord) : hashCellFlips(beginY, endY, beginWord, endWord);
+        for (std::uint32_t plane = 0; ageFlips && plane < agePlaneCount; ++plane)
         {
-            std::uint8_t liveNeighborCount = getLiveNeighborCount(x, y);
+            hashChange ^= hashFlipSums(ageFlips[plane], keys, endWord - beginWord);
+        }
+    }
+    tileHashes[tile] = hashChange;
+    LIFE_INSTRUMENT(tileProfiles[tile].cellsChanged = countCellFlips(tile));
+    LIFE_INSTRUMENT(tileProfiles[tile].surveyTime = UpdateProfile::now() - surveyStart);
+}
+
+BlockCensus LifeSimulator::takeTileCensus(const LifeBoard& cells, std::uint32_t tile) const
+{
+    std::size_t beginWord;
+    std::size_t endWord;
+    std::uint32_t beginY;
+    std::uint32_t endY;
+    getTileSpan(tile, beginWord, endWord, beginY, endY);
+
+    std::uint64_t lastMask = endWord == cells.getWordsPerRow() ? lastWordMask(getSizeX()) : ~std::uint64_t(0);
+    return takeCensus(cells.getRow(beginY) + beginWord, cells.getStride(), endY - beginY, endWord - beginWord, lastMask);
+}
+
+void LifeSimulator::recountTiles(std::uint32_t beginY, std::uint32_t endY)
+{
+    // Every tile in the bands of rows [beginY, endY), after an outside change to them
+    for (std::size_t band = beginY / TILE_ROWS; band * TILE_ROWS < endY; ++band)
+    {
+        for (std::size_t tileX = 0; tileX < tilesX; ++tileX)
+        {
+            auto tile = static_cast<std::uint32_t>(band * tilesX + tileX);
+            population -= tileCensus[tile].population;
+            tileCensus[tile] = takeTileCensus(*board, tile);
+            population += tileCensus[tile].population;
+        }
+    }
+}
+
+void LifeSimulator::getTileSpan(std::uint32_t tile, std::size_t& beginWord, std::size_t& endWord, std::uint32_t& beginY, std::uint32_t& endY) const
+{
+    beginWord = (tile % tilesX) * TILE_WORDS;
+    endWord = std::min(beginWord + TILE_WORDS, board->getWordsPerRow());
+    beginY = static_cast<std::uint32_t>(tile / tilesX) * TILE_ROWS;
+    endY = std::min(beginY + TILE_ROWS, getSizeY());
+}
+
+bool LifeSimulator::ageRow(std::uint32_t y, std::size_t beginWord, std::size_t endWord, FlipSums& cellFlips, FlipSums* ageFlips)
+{
+    // Dying cells cannot be born, and step through the ages 1 to lastAge
+    // before they are dead; live cells that do not survive start at age 1.
+    // All of it is done on the bit planes of the ages, a word at a time.
+    std::size_t wordsPerRow = board->getWordsPerRow();
+    std::uint64_t lastMask = lastWordMask(getSizeX());
+    std::uint32_t lastAge = rule.getStateCount() - 2;
+    const std::uint64_t* row = board->getRow(y);
+    std::uint64_t* out = nextBoard->getRow(y);
+    std::uint64_t* age = ages.data() + static_cast<std::size_t>(y) * agePlaneCount * wordsPerRow;
+    const std::uint64_t* ageKeys = rowKeys.data() + getSizeY() + static_cast<std::size_t>(y) * agePlaneCount;
 
-            // Cell is live
-            if (getCell(x, y))
+    // Cells whose state changes, or will change next generation
+    std::uint64_t changing = 0;
+    for (std::size_t i = beginWord; i < endWord; ++i)
+    {
+        std::uint64_t alive = row[i] & (i + 1 == wordsPerRow ? lastMask : ~std::uint64_t(0));
+        std::uint64_t dying = 0;
+        std::uint64_t atLastAge = ~std::uint64_t(0);
+        for (std::uint32_t plane = 0; plane < agePlaneCount; ++plane)
+        {
+            std::uint64_t bits = age[plane * wordsPerRow + i];
+            dying |= bits;
+            atLastAge &= ((lastAge >> plane) & 1) ? bits : ~bits;
+        }
+
+        std::uint64_t next = out[i] & ~dying;
+        std::uint64_t died = alive & ~next;
+
+        // Add one to every age but the last, which wraps to dead
+        std::uint64_t carry = dying & ~atLastAge;
+        for (std::uint32_t plane = 0; plane < agePlaneCount; ++plane)
+        {
+            std::uint64_t& bits = age[plane * wordsPerRow + i];
+            std::uint64_t aged = ((bits ^ carry) & ~atLastAge) | (plane == 0 ? died : 0);
+            if (cycleWindow)
             {
-                // Cell dies
-                if (liveNeighborCount < UNDERPOP_THRESH || liveNeighborCount > OVERPOP_THRESH)
-                {
-                    deadCoordinate.emplace_back(x, y);
-                }
+                addWordFlips(ageFlips[plane], i - beginWord, aged ^ bits, ageKeys[plane]);
             }
-            // Cell is dead
-            else
+            carry &= bits;
+            bits = aged;
+            changing |= bits;
+        }
+
+        // Every dying cell changes state, even the ones turning dead
+        out[i] = next;
+        changing |= (next ^ alive) | dying;
+        if (cycleWindow)
+        {
+            addWordFlips(cellFlips, i - beginWord, next ^ alive, rowKeys[y]);
+        }
+    }
+
+    return changing != 0;
+}
+
+void LifeSimulator::updateLargerThanLife()
+{
+    // Box sums are separable: sum each row across the radius, then add those
+    // sums up down the columns. Every row has to be summed before any band
+    // can start on its columns.
+    std::uint32_t sizeY = getSizeY();
+    runTasks(tilesY, [this, sizeY](std::size_t band) {
+        auto beginY = static_cast<std::uint32_t>(band) * TILE_ROWS;
+        sumRows(beginY, std::min(beginY + TILE_ROWS, sizeY));
+    });
+    runTasks(tilesY, [this, sizeY](std::size_t band) {
+        auto beginY = static_cast<std::uint32_t>(band) * TILE_ROWS;
+        sumColumns(beginY, std::min(beginY + TILE_ROWS, sizeY), columnSums.data() + band * getSizeX());
+        for (std::size_t tileX = 0; tileX < tilesX; ++tileX)
+        {
+            surveyTile(static_cast<std::uint32_t>(band * tilesX + tileX), nullptr, nullptr);
+        }
+    });
+    population += static_cast<std::uint64_t>(std::accumulate(populationChanges.begin(), populationChanges.end(), std::int64_t(0)));
+
+    nextBoard->refreshHalo();
+    std::swap(board, nextBoard);
+    activeTileCount = getTileCount();
+}
+
+void LifeSimulator::sumRows(std::uint32_t beginY, std::uint32_t endY)
+{
+    std::uint32_t sizeX = getSizeX();
+    std::uint32_t width = 2 * rule.getRadius() + 1;
+
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        std::uint16_t* sums = rowSums.data() + static_cast<std::size_t>(y) * sizeX;
+
+        // Slide a window over x - radius to x + radius along the wrapped row
+        std::uint32_t leaving = (sizeX - rule.getRadius() % sizeX) % sizeX;
+        std::uint32_t entering = leaving;
+        std::uint32_t sum = 0;
+        for (std::uint32_t i = 0; i < width; ++i)
+        {
+            sum += board->getCell(entering, y);
+            entering = entering + 1 == sizeX ? 0 : entering + 1;
+        }
+
+        for (std::uint32_t x = 0; x < sizeX; ++x)
+        {
+            sums[x] = static_cast<std::uint16_t>(sum);
+            sum = sum + board->getCell(entering, y) - board->getCell(leaving, y);
+            entering = entering + 1 == sizeX ? 0 : entering + 1;
+            leaving = leaving + 1 == sizeX ? 0 : leaving + 1;
+        }
+    }
+}
+
+void LifeSimulator::sumColumns(std::uint32_t beginY, std::uint32_t endY, std::uint16_t* running)
+{
+    std::uint32_t sizeX = getSizeX();
+    std::uint32_t sizeY = getSizeY();
+    std::uint32_t width = 2 * rule.getRadius() + 1;
+
+    // Slide a window over the row sums of y - radius to y + radius
+    std::uint32_t leaving = (beginY + sizeY - rule.getRadius() % sizeY) % sizeY;
+    std::uint32_t entering = leaving;
+    std::fill(running, running + sizeX, 0);
+    for (std::uint32_t i = 0; i < width; ++i)
+    {
+        const std::uint16_t* sums = rowSums.data() + static_cast<std::size_t>(entering) * sizeX;
+        for (std::uint32_t x = 0; x < sizeX; ++x)
+        {
+            running[x] = static_cast<std::uint16_t>(running[x] + sums[x]);
+        }
+        entering = entering + 1 == sizeY ? 0 : entering + 1;
+    }
+
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        // The box includes the cell itself, which the rule does not count
+        const std::uint64_t* row = board->getRow(y);
+        std::uint64_t* out = nextBoard->getRow(y);
+        for (std::uint32_t x = 0; x < sizeX; x += CELLS_PER_WORD)
+        {
+            std::uint64_t cells = row[x / CELLS_PER_WORD];
+            std::uint64_t next = 0;
+            std::uint32_t bitCount = std::min<std::uint32_t>(CELLS_PER_WORD, sizeX - x);
+            for (std::uint32_t bit = 0; bit < bitCount; ++bit)
+            {
+                std::uint32_t alive = (cells >> bit) & 1;
+                std::uint32_t count = running[x + bit] - alive;
+                next |= std::uint64_t(nextState[count * 2 + alive]) << bit;
+            }
+            out[x / CELLS_PER_WORD] = next;
+        }
+
+        const std::uint16_t* added = rowSums.data() + static_cast<std::size_t>(entering) * sizeX;
+        const std::uint16_t* removed = rowSums.data() + static_cast<std::size_t>(leaving) * sizeX;
+        for (std::uint32_t x = 0; x < sizeX; ++x)
+        {
+            running[x] = static_cast<std::uint16_t>(running[x] + added[x] - removed[x]);
+        }
+        entering = entering + 1 == sizeY ? 0 : entering + 1;
+        leaving = leaving + 1 == sizeY ? 0 : leaving + 1;
+    }
+}
+
+void LifeSimulator::refreshActiveHalo()
+{
+    // Rows without an evaluated tile kept both their cells and their halo
+    for (auto tile : activeTiles)
+    {
+        std::uint32_t band = static_cast<std::uint32_t>(tile / tilesX);
+        if (bandQueued[band] != generation + 1)
+        {
+            bandQueued[band] = generation + 1;
+            activeBands.push_back(band);
+        }
+    }
+
+    for (auto band : activeBands)
+    {
+        std::uint32_t beginY = band * TILE_ROWS;
+        nextBoard->refreshHalo(beginY, std::min(beginY + TILE_ROWS, getSizeY()));
+    }
+    activeBands.clear();
+}
+
+void LifeSimulator::queueChangedNeighborhoods()
+{
+    // A tile can only change next generation if it or a neighbor changed in
+    // this one. Tiles left out hold the same cells on both boards.
+    nextActiveTiles.clear();
+    for (auto tile : activeTiles)
+    {
+        if (!tileChanged[tile])
+        {
+            continue;
+        }
+
+        std::size_t tileX = tile % tilesX;
+        std::size_t tileY = tile / tilesX;
+        for (std::size_t dy = tilesY - 1; dy <= tilesY + 1; ++dy)
+        {
+            for (std::size_t dx = tilesX - 1; dx <= tilesX + 1; ++dx)
             {
-                // Cell revives
-                if (liveNeighborCount == 3)
+                auto neighbor = static_cast<std::uint32_t>(((tileY + dy) % tilesY) * tilesX + (tileX + dx) % tilesX);
+                if (tileQueued[neighbor] != generation + 1)
                 {
-                    liveCoordinate.emplace_back(x, y);
+                    tileQueued[neighbor] = generation + 1;
+                    nextActiveTiles.push_back(neighbor);
                 }
             }
         }
     }
 
-    // Kill cells
-    for (auto coord : deadCoordinate)
+    std::swap(activeTiles, nextActiveTiles);
+}
+
+void LifeSimulator::restartCycleDetection()
+{
+    hashValid = false;
+    cyclePeriod = 0;
+    repeatGeneration = 0;
+}
+
+void LifeSimulator::makeHashKeys()
+{
+    // SplitMix64, one key per row of cells or of ages and one per word of a row
+    std::uint64_t state = HASH_KEY_SEED;
+    auto nextKey = [&state]() { return mixBits(state += 0x9E3779B97F4A7C15); };
+    rowKeys.resize(static_cast<std::size_t>(getSizeY()) * (agePlaneCount + 1));
+    std::generate(rowKeys.begin(), rowKeys.end(), nextKey);
+    wordKeys.resize(board->getWordsPerRow());
+    std::generate(wordKeys.begin(), wordKeys.end(), nextKey);
+}
+
+#if defined(LIFE_INSTRUMENTATION)
+std::uint64_t LifeSimulator::countTileCells(std::uint32_t tile) const
+{
+    std::size_t beginWord;
+    std::size_t endWord;
+    std::uint32_t beginY;
+    std::uint32_t endY;
+    getTileSpan(tile, beginWord, endWord, beginY, endY);
+    std::uint64_t width = std::min<std::uint64_t>(endWord * CELLS_PER_WORD, getSizeX()) - beginWord * CELLS_PER_WORD;
+    return width * (endY - beginY);
+}
+
+std::uint64_t LifeSimulator::countCellFlips(std::uint32_t tile) const
+{
+    // Live cells only: ages that change under a Generations rule are not counted
+    std::size_t beginWord;
+    std::size_t endWord;
+    std::uint32_t beginY;
+    std::uint32_t endY;
+    getTileSpan(tile, beginWord, endWord, beginY, endY);
+    std::uint64_t lastMask = endWord == board->getWordsPerRow() ? lastWordMask(getSizeX()) : ~std::uint64_t(0);
+
+    std::uint64_t flips = 0;
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        const std::uint64_t* before = board->getRow(y);
+        const std::uint64_t* after = nextBoard->getRow(y);
+        for (std::size_t i = beginWord; i < endWord; ++i)
+        {
+            flips += countSetBits((before[i] ^ after[i]) & (i + 1 == endWord ? lastMask : ~std::uint64_t(0)));
+        }
+    }
+    return flips;
+}
+
+void LifeSimulator::addTileProfile(std::uint32_t tile)
+{
+    const TileProfile& tileProfile = tileProfiles[tile];
+    profile.addTime(UpdatePhase::Kernel, tileProfile.kernelTime);
+    profile.addTime(UpdatePhase::Survey, tileProfile.surveyTime);
+    profile.addCells(countTileCells(tile), tileProfile.cellsChanged);
+}
+#endif
+
+std::uint64_t LifeSimulator::hashCellFlips(std::uint32_t beginY, std::uint32_t endY, std::size_t beginWord, std::size_t endWord) const
+{
+    // The hash is linear, so the cells that flipped hash to the change in it
+    std::uint64_t lastMask = endWord == board->getWordsPerRow() ? lastWordMask(getSizeX()) : ~std::uint64_t(0);
+    return hashFlips(board->getRow(beginY) + beginWord, nextBoard->getRow(beginY) + beginWord, board->getStride(), rowKeys.data() + beginY, endY - beginY,
+                     wordKeys.data() + beginWord, endWord - beginWord, lastMask);
+}
+
+std::uint64_t LifeSimulator::computeHash() const
+{
+    // Rows of ages follow the rows of cells, in the order ages keeps them
+    std::uint32_t sizeY = getSizeY();
+    std::size_t wordsPerRow = board->getWordsPerRow();
+    std::uint64_t lastMask = lastWordMask(getSizeX());
+    std::uint64_t hash = 0;
+    for (std::size_t y = 0; y < rowKeys.size(); ++y)
+    {
+        const std::uint64_t* row = y < sizeY ? board->getRow(static_cast<std::int64_t>(y)) : ages.data() + (y - sizeY) * wordsPerRow;
+        CarrylessSum words;
+        for (std::size_t i = 0; i < wordsPerRow; ++i)
+        {
+            addCarrylessProduct(words, i + 1 == wordsPerRow ? row[i] & lastMask : row[i], wordKeys[i]);
+        }
+        hash ^= multiplyInField(reduceCarryless(words), rowKeys[y]);
+    }
+    return hash;
+}
+
+void LifeSimulator::recordHash(std::uint64_t hashChange)
+{
+    if (!cycleWindow)
+    {
+        return;
+    }
+
+    // Once the board has repeated, it keeps cycling until changed from outside
+    boardHash ^= hashChange;
+    if (!cyclePeriod)
+    {
+        std::uint64_t period = cycles.record(boardHash, generation);
+        if (period)
+        {
+            cyclePeriod = period;
+            repeatGeneration = generation;
+        }
+    }
+}
+
+std::uint32_t LifeSimulator::countAgePlanes(const LifeRule& rule)
+{
+    std::uint32_t planes = 0;
+    while ((std::uint32_t(1) << planes) < rule.getStateCount() - 1)
+    {
+        ++planes;
+    }
+    return planes;
+}
+
+std::uint32_t LifeSimulator::getSizeX() const
+{
+    return board->getSizeX();
+}
+
+std::uint32_t LifeSimulator::getSizeY() const
+{
+    return board->getSizeY();
+}
+
+bool LifeSimulator::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    return board->getCell(x, y);
+}
+
+void LifeSimulator::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    // The last word may hold the halo copy of the row's first cell
+    const std::uint64_t* row = board->getRow(y);
+    std::size_t wordCount = board->getWordsPerRow();
+    std::copy(row, row + wordCount, words);
+    if (wordCount)
+    {
+        words[wordCount - 1] &= lastWordMask(board->getSizeX());
+    }
+}
+
+std::uint32_t LifeSimulator::getState(std::uint32_t x, std::uint32_t y) const
+{
+    if (board->getCell(x, y))
     {
-        field[coord.first][coord.second] = false;
+        return 1;
     }
 
-    // Revive cells
-    for (auto coord : liveCoordinate)
+    std::size_t wordsPerRow = board->getWordsPerRow();
+    std::uint32_t age = 0;
+    for (std::uint32_t plane = 0; plane < agePlaneCount; ++plane)
     {
-        field[coord.first][coord.second] = true;
+        std::uint64_t bits = ages[(static_cast<std::size_t>(y) * agePlaneCount + plane) * wordsPerRow + x / CELLS_PER_WORD];
+        age |= static_cast<std::uint32_t>((bits >> (x % CELLS_PER_WORD)) & 1) << plane;
     }
+    return age ? age + 1 : 0;
 }
 
-std::uint8_t LifeSimulator::getLiveNeighborCount(std::uint8_t x, std::uint8_t y)
+void LifeSimulator::setRule(const LifeRule& rule)
 {
-    std::uint8_t count = 0;
+    // A box wider than the torus would wrap onto itself and count cells twice
+    std::uint32_t width = 2 * rule.getRadius() + 1;
+    if (rule.getRadius() > 1 && (getSizeX() < width || getSizeY() < width))
+    {
+        throw std::invalid_argument("A " + std::to_string(getSizeX()) + " by " + std::to_string(getSizeY()) + " board is too small for rule " + rule.toString());
+    }
+
+    this->rule = rule;
+    bitRule = { rule.getBirthMask(), rule.getSurvivalMask() };
+    spanKernel = selectSpanKernel(bitRule);
 
-    // Define neighbor cells
-    std::vector<Coordinate> coords;
-    coords.emplace_back(decWrap(x, true), decWrap(y, false));
-    coords.emplace_back(decWrap(x, true), y);
-    coords.emplace_back(decWrap(x, true), incWrap(y, false));
-    coords.emplace_back(x, decWrap(y, false));
-    coords.emplace_back(x, incWrap(y, false));
-    coords.emplace_back(incWrap(x, true), decWrap(y, false));
-    coords.emplace_back(incWrap(x, true), y);
-    coords.emplace_back(incWrap(x, true), incWrap(y, false));
+    // Scratch the rule steps with, sized here so update() never allocates
+    agePlaneCount = countAgePlanes(rule);
+    std::vector<std::uint64_t>(agePlaneCount * board->getWordsPerRow() * getSizeY(), 0).swap(ages);
 
-    // Count
-    for (auto coord : coords)
+    if (rule.getRadius() > 1)
     {
-        if (getCell(coord.first, coord.second))
+        rowSums.assign(static_cast<std::size_t>(getSizeX()) * getSizeY(), 0);
+        columnSums.assign(tilesY * getSizeX(), 0);
+        nextState.resize((static_cast<std::size_t>(rule.getMaxCount()) + 1) * 2);
+        for (std::uint32_t count = 0; count <= rule.getMaxCount(); ++count)
         {
-            count++;
+            nextState[count * 2] = rule.isBorn(count);
+            nextState[count * 2 + 1] = rule.survives(count);
         }
     }
+    else
+    {
+        std::vector<std::uint16_t>().swap(rowSums);
+        std::vector<std::uint16_t>().swap(columnSums);
+        std::vector<std::uint8_t>().swap(nextState);
+    }
 
-    return count;
+    makeHashKeys();
+    allTilesActive = true;
+    restartCycleDetection();
 }
 
-std::uint8_t LifeSimulator::decWrap(std::uint8_t index, bool isX)
+const LifeRule& LifeSimulator::getRule() const
 {
-    std::uint8_t maxIndex = isX ? getSizeX() - 1 : getSizeY() - 1;
+    return rule;
+}
 
-    if (index == 0)
+void LifeSimulator::setThreadCount(std::size_t threadCount)
+{
+    if (!threadCount)
     {
-        return maxIndex;
+        threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
     }
-    else
+
+    pool.reset();
+    if (threadCount > 1)
     {
-        return index - 1;
+        pool = std::make_unique<ThreadPool>(threadCount);
     }
 }
 
-std::uint8_t LifeSimulator::incWrap(std::uint8_t index, bool isX)
+std::size_t LifeSimulator::getThreadCount() const
+{
+    return pool ? pool->getThreadCount() : 1;
+}
+
+void LifeSimulator::setSparse(bool sparse)
 {
-    std::uint8_t maxIndex = isX ? getSizeX() - 1 : getSizeY() - 1;
+    this->sparse = sparse;
+    allTilesActive = true;
+}
 
-    if (index == maxIndex)
+bool LifeSimulator::isSparse() const
+{
+    return sparse;
+}
+
+void LifeSimulator::setCycleWindow(std::uint64_t generations)
+{
+    // Built first, so a window too large to hold leaves detection as it was
+    cycles = CycleDetector(generations);
+    cycleWindow = generations;
+    restartCycleDetection();
+}
+
+std::uint64_t LifeSimulator::getPopulation() const
+{
+    return population;
+}
+
+BoundingBox LifeSimulator::getBoundingBox() const
+{
+    // The tiles' boxes, moved to their corners
+    BoundingBox box;
+    for (std::size_t tile = 0; tile < tileCensus.size(); ++tile)
     {
-        return 0;
+        const BoundingBox& tileBox = tileCensus[tile].box;
+        if (tileBox.isEmpty())
+        {
+            continue;
+        }
+        auto x = static_cast<std::uint32_t>((tile % tilesX) * TILE_WORDS * CELLS_PER_WORD);
+        auto y = static_cast<std::uint32_t>((tile / tilesX) * TILE_ROWS);
+        box.minX = std::min(box.minX, x + tileBox.minX);
+        box.minY = std::min(box.minY, y + tileBox.minY);
+        box.maxX = std::max(box.maxX, x + tileBox.maxX);
+        box.maxY = std::max(box.maxY, y + tileBox.maxY);
     }
-    else
+    return box;
+}
+
+const std::vector<BlockCensus>& LifeSimulator::getTileCensus() const
+{
+    return tileCensus;
+}
+
+std::size_t LifeSimulator::getTilesX() const
+{
+    return tilesX;
+}
+
+std::size_t LifeSimulator::getTilesY() const
+{
+    return tilesY;
+}
+
+std::uint64_t LifeSimulator::getCycleWindow() const
+{
+    return cycleWindow;
+}
+
+std::uint64_t LifeSimulator::getHash() const
+{
+    return cycleWindow && hashValid ? boardHash : computeHash();
+}
+
+std::uint64_t LifeSimulator::getCyclePeriod() const
+{
+    return cyclePeriod;
+}
+
+std::uint64_t LifeSimulator::getRepeatGeneration() const
+{
+    return repeatGeneration;
+}
+
+std::size_t LifeSimulator::getActiveTileCount() const
+{
+    return activeTileCount;
+}
+
+std::size_t LifeSimulator::getTileCount() const
+{
+    return tilesX * tilesY;
+}
+
+const LifeBoard& LifeSimulator::getBoard() const
+{
+    return *board;
+}
+
+std::shared_ptr<const LifeBoard> LifeSimulator::shareBoard() const
+{
+    return board;
+}
+
+void LifeSimulator::fillSoup(const SoupGenerator& soup)
+{
+    if (!getSizeX() || !getSizeY())
     {
-        return index + 1;
+        return;
+    }
+
+    detachBoard(board);
+    std::fill(ages.begin(), ages.end(), 0);
+
+    // Each tile takes its census while its words are still in cache
+    std::size_t wordsPerRow = board->getWordsPerRow();
+    std::uint64_t lastMask = lastWordMask(getSizeX());
+    runTasks(getTileCount(), [this, &soup, wordsPerRow, lastMask](std::size_t task) {
+        auto tile = static_cast<std::uint32_t>(task);
+        std::size_t beginWord;
+        std::size_t endWord;
+        std::uint32_t beginY;
+        std::uint32_t endY;
+        getTileSpan(tile, beginWord, endWord, beginY, endY);
+        for (std::uint32_t y = beginY; y < endY; ++y)
+        {
+            std::uint64_t* row = board->getRow(y);
+            soup.fill(row + beginWord, static_cast<std::uint64_t>(y) * wordsPerRow + beginWord, endWord - beginWord);
+            if (endWord == wordsPerRow)
+            {
+                row[wordsPerRow - 1] &= lastMask;
+            }
+        }
+        tileCensus[tile] = takeTileCensus(*board, tile);
+    });
+
+    population = 0;
+    for (const BlockCensus& census : tileCensus)
+    {
+        population += census.population;
+    }
+    allTilesActive = true;
+    restartCycleDetection();
+}
+
+bool LifeSimulator::placePattern(std::uint32_t patternSizeX, std::uint32_t patternSizeY, std::uint32_t startX, std::uint32_t startY, Placement& placement)
+{
+    std::uint32_t sizeX = getSizeX();
+    std::uint32_t sizeY = getSizeY();
+    if (!sizeX || !sizeY)
+    {
+        return false;
+    }
+
+    placement.startX = startX % sizeX;
+    placement.startY = startY % sizeY;
+    placement.width = std::min(patternSizeX, sizeX);
+    placement.height = std::min(patternSizeY, sizeY);
+    placement.firstWidth = std::min(placement.width, sizeX - placement.startX);
+    detachBoard(board);
+    return true;
+}
+
+void LifeSimulator::stampRow(const Placement& placement, std::uint32_t y, const std::uint64_t* row)
+{
+    std::uint32_t sizeY = getSizeY();
+    std::uint32_t boardY = placement.startY + y < sizeY ? placement.startY + y : placement.startY + y - sizeY;
+    board->copySpan(placement.startX, boardY, row, 0, placement.firstWidth);
+    board->copySpan(0, boardY, row, placement.firstWidth, placement.width - placement.firstWidth);
+
+    // Cells the pattern covers are no longer dying
+    std::size_t wordsPerRow = board->getWordsPerRow();
+    for (std::uint32_t plane = 0; plane < agePlaneCount; ++plane)
+    {
+        std::uint64_t* age = ages.data() + (static_cast<std::size_t>(boardY) * agePlaneCount + plane) * wordsPerRow;
+        fillBits(age, placement.startX, placement.firstWidth, false);
+        fillBits(age, 0, placement.width - placement.firstWidth, false);
     }
 }
 
-std::uint8_t LifeSimulator::getSizeX() const
+void LifeSimulator::finishPattern(const Placement& placement)
 {
-    return static_cast<std::uint8_t>(field.size());
+    std::uint32_t sizeY = getSizeY();
+    recountTiles(placement.startY, std::min(placement.startY + placement.height, sizeY));
+    if (placement.startY + placement.height > sizeY)
+    {
+        recountTiles(0, placement.startY + placement.height - sizeY);
+    }
+    allTilesActive = true;
+    restartCycleDetection();
 }
 
-std::uint8_t LifeSimulator::getSizeY() const
+void LifeSimulator::detachBoard(std::shared_ptr<LifeBoard>& target)
 {
-    // Assumes the field is square
-    return static_cast<std::uint8_t>(field[0].size());
+    // Someone still reads this board, so write to a copy of it instead.
+    // Only this thread hands out references, so a count of one stays one.
+    // The count is read without ordering, though, so a reader on another
+    // thread must hand its reference back to this one to drop it, as
+    // CheckpointWriter does, or its last reads may race with the writes.
+    if (target.use_count() > 1)
+    {
+        target = std::make_shared<LifeBoard>(*target);
+    }
 }
 
-bool LifeSimulator::getCell(std::uint8_t x, std::uint8_t y) const
+std::size_t LifeSimulator::getMemoryUsage() const
 {
-    return field[x][y];
-}
\ No newline at end of file
+    std::size_t tileState = (activeTiles.capacity() + nextActiveTiles.capacity() + activeBands.capacity()) * sizeof(std::uint32_t)
+                          + tileChanged.capacity() + (tileQueued.capacity() + bandQueued.capacity()) * sizeof(std::uint64_t);
+
+    std::size_t ruleState = ages.capacity() * sizeof(std::uint64_t) + (rowSums.capacity() + columnSums.capacity()) * sizeof(std::uint16_t)
+                          + nextState.capacity();
+
+    std::size_t hashState = (rowKeys.capacity() + wordKeys.capacity() + tileHashes.capacity()) * sizeof(std::uint64_t) + cycles.getMemoryUsage();
+    std::size_t censusState = tileCensus.capacity() * sizeof(BlockCensus) + populationChanges.capacity() * sizeof(std::int64_t);
+
+    return board->getMemoryUsage() + nextBoard->getMemoryUsage() + tileState + ruleState + hashState + censusState;
+}
+
+double LifeSimulator::getBitsPerCell() const
+{
+    std::size_t cellCount = static_cast<std::size_t>(getSizeX()) * getSizeY();
+    return cellCount ? 8.0 * getMemoryUsage() / cellCount : 0.0;
+}
+
+#if defined(LIFE_INSTRUMENTATION)
+const UpdateProfile& LifeSimulator::getProfile() const
+{
+    return profile;
+}
+
+void LifeSimulator::resetProfile()
+{
+    profile.reset();
+}
+#endif
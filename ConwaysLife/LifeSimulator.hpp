@@ -1,26 +1,278 @@
 #pragma once
 
+#include "CycleDetector.hpp"
+#include "LifeBoard.hpp"
+#include "LifeEngine.hpp"
+#include "LifeKernel.hpp"
+#include "LifeRule.hpp"
 #include "Pattern.hpp"
+#include "PatternCells.hpp"
+#include "SoupGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "UpdateProfile.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-using Coordinate = std::pair<std::uint8_t, std::uint8_t>;
+using Coordinate = std::pair<std::uint32_t, std::uint32_t>;
 
-class LifeSimulator
+// Stepping splits the board into tiles of TILE_ROWS rows by TILE_WORDS words
+// (512 cells), about 4 KB, so a tile and its halo stay in L1
+const std::uint32_t TILE_ROWS = 64;
+const std::size_t TILE_WORDS = 8;
+
+// Brute-force engine: steps every cell of a sizeX by sizeY torus each
+// generation. It is double-buffered: tiles read the current board and write
+// the next one, then the two swap, and stepping never allocates.
+//
+// Two-state and Generations rules run on the bit-sliced kernel, Generations
+// keeping the age of dying cells in bit planes of their own. Larger than
+// Life rules count neighborhoods with running box sums instead, and always
+// step the whole board.
+class LifeSimulator : public LifeEngine
 {
   public:
-    LifeSimulator(std::uint8_t sizeX, std::uint8_t sizeY);
+    LifeSimulator(std::uint32_t sizeX, std::uint32_t sizeY, const LifeRule& rule = LifeRule());
+
+    // Copies the pattern in a row at a time. Placements past an edge wrap
+    // around the torus, and a pattern larger than the board is cut to its size.
+    void insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY) override;
+    // Same, for a pattern fixed at compile time: its rows are copied straight
+    // from the pattern's constants, with no virtual calls
+    template <const char* Cells>
+    void insertPattern(const PatternCells<Cells>& pattern, std::uint32_t startX, std::uint32_t startY)
+    {
+        Placement placement;
+        if (!placePattern(pattern.SIZE_X, pattern.SIZE_Y, startX, startY, placement))
+        {
+            return;
+        }
+        for (std::uint32_t y = 0; y < placement.height; ++y)
+        {
+            stampRow(placement, y, pattern.ROWS.data() + y * pattern.WORDS_PER_ROW);
+        }
+        finishPattern(placement);
+    }
+    // Replaces every cell with the soup, the same one a PatternSoup of the
+    // board's size with the same generator inserts, but drawn straight into
+    // the board a tile per task on the simulator's threads
+    void fillSoup(const SoupGenerator& soup);
+    void update() override;
+    void advance(std::uint64_t generations) override;
+    std::uint64_t step(std::uint64_t generations, const StepControl& control) override;
+    std::uint64_t getGeneration() const override;
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+    // 0 for dead, 1 for alive, and from 2 up for dying under a Generations rule
+    std::uint32_t getState(std::uint32_t x, std::uint32_t y) const;
+
+    // Live cells are kept, dying ones become dead
+    void setRule(const LifeRule& rule);
+    const LifeRule& getRule() const;
+
+    // Number of threads update() steps the tiles with, 0 meaning one per hardware thread
+    void setThreadCount(std::size_t threadCount);
+    std::size_t getThreadCount() const;
 
-    void insertPattern(const Pattern& pattern, std::uint8_t startX, std::uint8_t startY);
-    void update();
+    // In sparse mode update() only evaluates tiles that changed in the last
+    // generation and the tiles around them, so still regions cost nothing.
+    // Larger than Life rules ignore it.
+    void setSparse(bool sparse);
+    bool isSparse() const;
+    // Tiles evaluated by the last update(), out of getTileCount()
+    std::size_t getActiveTileCount() const;
+    std::size_t getTileCount() const;
 
-    std::uint8_t getSizeX() const;
-    std::uint8_t getSizeY() const;
-    bool getCell(std::uint8_t x, std::uint8_t y) const;
+    // Live cells, kept by update() as it steps each tile rather than counted
+    std::uint64_t getPopulation() const;
+    // Smallest rectangle holding every live cell, on the board as stored
+    // rather than unwrapped across the torus's edges. Put together from the
+    // tiles' census, so it looks at each tile rather than each cell.
+    BoundingBox getBoundingBox() const;
+    // Census of each tile, tile (x, y) at [y * getTilesX() + x], its box in
+    // cells from the tile's corner at (x * TILE_WORDS * 64, y * TILE_ROWS)
+    const std::vector<BlockCensus>& getTileCensus() const;
+    std::size_t getTilesX() const;
+    std::size_t getTilesY() const;
+
+    // With a window of n generations, update() keeps a hash of the board
+    // and looks for it among the last n generations' hashes, so still lifes
+    // and oscillators are spotted as they settle. 0 turns it off. The hashes
+    // take about 100 bytes per generation of window; a window too large to
+    // hold throws std::bad_alloc or std::length_error.
+    void setCycleWindow(std::uint64_t generations);
+    std::uint64_t getCycleWindow() const;
+    // Hash of the cells and ages of the current generation. On boards of
+    // one size and rule, the same state always hashes the same.
+    std::uint64_t getHash() const;
+    // Period of the cycle the board fell into, 1 for a still life, or 0 if
+    // it has not repeated within the window since it last changed from outside
+    std::uint64_t getCyclePeriod() const;
+    // Generation in which the board first repeated; it repeated generation
+    // getRepeatGeneration() - getCyclePeriod()
+    std::uint64_t getRepeatGeneration() const;
+
+    const LifeBoard& getBoard() const;
+    // The current generation's board, shared rather than copied. While
+    // anyone holds it, the simulator copies it before writing to it again,
+    // so the holder sees this generation however far the simulation moves on.
+    // A holder on another thread must drop it on the simulator's thread.
+    std::shared_ptr<const LifeBoard> shareBoard() const;
+    // Bytes held by the simulation, and that spread over the cells
+    std::size_t getMemoryUsage() const;
+    double getBitsPerCell() const;
+
+#if defined(LIFE_INSTRUMENTATION)
+    // Timings and counts of every generation stepped since the last reset
+    const UpdateProfile& getProfile() const;
+    void resetProfile();
+#endif
 
   private:
-    std::vector<std::vector<bool>> field;
-    std::uint8_t getLiveNeighborCount(std::uint8_t x, std::uint8_t y);
-    std::uint8_t decWrap(std::uint8_t index, bool isX);
-    std::uint8_t incWrap(std::uint8_t index, bool isX);
+    // LifeSnapshot saves and restores the state below directly
+    friend class LifeSnapshot;
+
+    // update() reads board and writes nextBoard, then swaps them. Each is
+    // copied on write while shareBoard() has handed it out.
+    std::shared_ptr<LifeBoard> board;
+    std::shared_ptr<LifeBoard> nextBoard;
+    std::uint64_t generation = 0;
+
+    LifeRule rule;
+    BitRule bitRule;
+    SpanKernel spanKernel;
+    // Generations: bit plane j of the age of dying cells in row y is at
+    // ages[(y * agePlaneCount + j) * wordsPerRow]. Live and dead cells are age 0.
+    std::uint32_t agePlaneCount = 0;
+    std::vector<std::uint64_t> ages;
+    // Larger than Life: each cell's row sum over the radius, the running
+    // column sums of each band of rows, and the next state of a cell with
+    // count neighbors at [count * 2 + alive]
+    std::vector<std::uint16_t> rowSums;
+    std::vector<std::uint16_t> columnSums;
+    std::vector<std::uint8_t> nextState;
+
+    // One packed row of the pattern being inserted
+    std::vector<std::uint64_t> patternRow;
+
+    std::unique_ptr<ThreadPool> pool;
+    bool sparse = false;
+    std::size_t tilesX;
+    std::size_t tilesY;
+    // Set when the board changed outside update(), so every tile must be evaluated
+    bool allTilesActive = true;
+    std::vector<std::uint32_t> activeTiles;
+    std::vector<std::uint32_t> nextActiveTiles;
+    std::vector<std::uint8_t> tileChanged;
+    // Generation in which each tile or band of tiles was last queued
+    std::vector<std::uint64_t> tileQueued;
+    std::vector<std::uint64_t> bandQueued;
+    std::vector<std::uint32_t> activeBands;
+    std::size_t activeTileCount = 0;
+
+    // Census of every tile, and the change in each tile's population in this update()
+    std::vector<BlockCensus> tileCensus;
+    std::vector<std::int64_t> populationChanges;
+    std::uint64_t population = 0;
+
+    // Cycle detection. The hash is the sum over words of word * wordKey *
+    // rowKey in GF(2^64), with random keys: linear, so update() adds in the
+    // hash of the cells that flipped, and two different boards hash alike
+    // with odds of about 2^-63. Rows of ages are numbered on from the
+    // board's rows.
+    std::uint64_t cycleWindow = 0;
+    CycleDetector cycles;
+    std::vector<std::uint64_t> rowKeys;
+    std::vector<std::uint64_t> wordKeys;
+    // Change to the hash from each tile or band of tiles in this update()
+    std::vector<std::uint64_t> tileHashes;
+    std::uint64_t boardHash = 0;
+    // Cleared when the board changed outside update(), to hash it all again
+    bool hashValid = false;
+    std::uint64_t cyclePeriod = 0;
+    std::uint64_t repeatGeneration = 0;
+
+#if defined(LIFE_INSTRUMENTATION)
+    // What each tile's worker measured in this update(), added into the
+    // profile afterwards by the calling thread
+    struct TileProfile
+    {
+        std::uint64_t kernelTime;
+        std::uint64_t surveyTime;
+        std::uint64_t cellsChanged;
+    };
+
+    UpdateProfile profile;
+    std::vector<TileProfile> tileProfiles;
+#endif
+
+    // Runs body(task) for every task, on the pool if there is one
+    template <typename Body>
+    void runTasks(std::size_t taskCount, const Body& body)
+    {
+        if (pool)
+        {
+            pool->parallelFor(taskCount, [&body](std::size_t task, std::size_t) { body(task); });
+        }
+        else
+        {
+            for (std::size_t task = 0; task < taskCount; ++task)
+            {
+                body(task);
+            }
+        }
+    }
+
+    // Where insertPattern() puts a pattern: width by height cells from
+    // (startX, startY), the first firstWidth columns up to the right edge
+    // and the rest from x = 0
+    struct Placement
+    {
+        std::uint32_t startX;
+        std::uint32_t startY;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t firstWidth;
+    };
+
+    // Readies the board for a pattern, or returns false if it has no cells
+    bool placePattern(std::uint32_t patternSizeX, std::uint32_t patternSizeY, std::uint32_t startX, std::uint32_t startY, Placement& placement);
+    // Copies in row y of the pattern, packed as Pattern::getRow() writes it
+    void stampRow(const Placement& placement, std::uint32_t y, const std::uint64_t* row);
+    void finishPattern(const Placement& placement);
+    void detachBoard(std::shared_ptr<LifeBoard>& target);
+    // update() on a board known to have cells
+    void stepGeneration();
+    void updateTile(std::uint32_t tile);
+    // Adds the cells and ages that change, times their row keys, to word
+    // word - beginWord of cellFlips and of ageFlips[plane]
+    bool ageRow(std::uint32_t y, std::size_t beginWord, std::size_t endWord, FlipSums& cellFlips, FlipSums* ageFlips);
+    // The tile's hash changes by the flips summed as it was stepped, or,
+    // with no cellFlips, by the cells that differ between board and nextBoard
+    void surveyTile(std::uint32_t tile, const FlipSums* cellFlips, const FlipSums* ageFlips);
+    BlockCensus takeTileCensus(const LifeBoard& cells, std::uint32_t tile) const;
+    void recountTiles(std::uint32_t beginY, std::uint32_t endY);
+    void getTileSpan(std::uint32_t tile, std::size_t& beginWord, std::size_t& endWord, std::uint32_t& beginY, std::uint32_t& endY) const;
+#if defined(LIFE_INSTRUMENTATION)
+    std::uint64_t countTileCells(std::uint32_t tile) const;
+    std::uint64_t countCellFlips(std::uint32_t tile) const;
+    void addTileProfile(std::uint32_t tile);
+#endif
+    void updateLargerThanLife();
+    void sumRows(std::uint32_t beginY, std::uint32_t endY);
+    void sumColumns(std::uint32_t beginY, std::uint32_t endY, std::uint16_t* running);
+    void refreshActiveHalo();
+    void queueChangedNeighborhoods();
+    void restartCycleDetection();
+    void makeHashKeys();
+    std::uint64_t hashCellFlips(std::uint32_t beginY, std::uint32_t endY, std::size_t beginWord, std::size_t endWord) const;
+    std::uint64_t computeHash() const;
+    void recordHash(std::uint64_t hashChange);
+
+    // Bit planes needed for the ages of the rule's dying cells
+    static std::uint32_t countAgePlanes(const LifeRule& rule);
 };
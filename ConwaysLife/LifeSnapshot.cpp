@@ -0,0 +1,399 @@
+#include "LifeSnapshot.hpp"
+
+#include "LifeKernel.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace
+{
+    const char MAGIC[8] = { 'L', 'I', 'F', 'E', 'S', 'N', 'A', 'P' };
+    const std::uint32_t VERSION = 1;
+    const std::uint32_t FLAG_COMPRESSED = 1;
+    // Reads back as itself only on a machine of the same byte order
+    const std::uint64_t BYTE_ORDER_MARK = 0x0102030405060708;
+
+    // A compressed token is a word: the top bit set means a run of that many
+    // zero words, clear means that many literal words follow
+    const std::uint64_t ZERO_RUN = std::uint64_t(1) << 63;
+    // Shorter zero runs cost no less as literals than as a token of their own
+    const std::uint64_t MIN_ZERO_RUN = 3;
+    // Literals are flushed in blocks so the buffer stays small
+    const std::size_t MAX_LITERALS = 4096;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::uint32_t sizeX;
+        std::uint32_t sizeY;
+        std::uint64_t generation;
+        std::uint32_t agePlaneCount;
+        std::uint32_t ruleLength;
+        std::uint64_t wordsPerRow;
+        // Words of data in the file, tokens included
+        std::uint64_t dataWords;
+        std::uint64_t byteOrder;
+    };
+    static_assert(sizeof(Header) == 64, "Snapshot header must stay 64 bytes");
+
+    std::size_t paddedToWord(std::size_t bytes)
+    {
+        return (bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) * sizeof(std::uint64_t);
+    }
+
+    // Writes data words to the file, as is or run-length compressed
+    class WordWriter
+    {
+      public:
+        WordWriter(std::ofstream& out, bool compress) :
+            out(out),
+            compress(compress)
+        {
+        }
+
+        void add(const std::uint64_t* words, std::size_t count)
+        {
+            if (!compress)
+            {
+                write(words, count);
+                return;
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (!words[i])
+                {
+                    ++zeroRun;
+                    continue;
+                }
+                flushZeros();
+                literals.push_back(words[i]);
+                if (literals.size() == MAX_LITERALS)
+                {
+                    flushLiterals();
+                }
+            }
+        }
+
+        void finish()
+        {
+            flushZeros();
+            flushLiterals();
+        }
+
+        std::uint64_t getWrittenCount() const { return written; }
+
+      private:
+        std::ofstream& out;
+        bool compress;
+        std::vector<std::uint64_t> literals;
+        std::uint64_t zeroRun = 0;
+        std::uint64_t written = 0;
+
+        void write(const std::uint64_t* words, std::size_t count)
+        {
+            out.write(reinterpret_cast<const char*>(words), static_cast<std::streamsize>(count * sizeof(std::uint64_t)));
+            written += count;
+        }
+
+        void flushZeros()
+        {
+            if (zeroRun >= MIN_ZERO_RUN)
+            {
+                flushLiterals();
+                std::uint64_t token = ZERO_RUN | zeroRun;
+                write(&token, 1);
+            }
+            else
+            {
+                literals.insert(literals.end(), static_cast<std::size_t>(zeroRun), 0);
+            }
+            zeroRun = 0;
+        }
+
+        void flushLiterals()
+        {
+            if (literals.empty())
+            {
+                return;
+            }
+            std::uint64_t token = literals.size();
+            write(&token, 1);
+            write(literals.data(), literals.size());
+            literals.clear();
+        }
+    };
+
+    // Reads data words back out of a mapped file, as written by WordWriter
+    class WordReader
+    {
+      public:
+        WordReader(const char* begin, const char* end, bool compressed) :
+            at(begin),
+            end(end),
+            compressed(compressed)
+        {
+        }
+
+        void read(std::uint64_t* words, std::size_t count)
+        {
+            while (count)
+            {
+                if (!compressed)
+                {
+                    copyLiterals(words, count);
+                    return;
+                }
+
+                if (!zerosLeft && !literalsLeft)
+                {
+                    std::uint64_t token;
+                    copyLiterals(&token, 1);
+                    (token & ZERO_RUN ? zerosLeft : literalsLeft) = token & ~ZERO_RUN;
+                    continue;
+                }
+
+                std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(count, zerosLeft ? zerosLeft : literalsLeft));
+                if (zerosLeft)
+                {
+                    std::fill(words, words + length, 0);
+                    zerosLeft -= length;
+                }
+                else
+                {
+                    copyLiterals(words, length);
+                    literalsLeft -= length;
+                }
+                words += length;
+                count -= length;
+            }
+        }
+
+      private:
+        const char* at;
+        const char* end;
+        bool compressed;
+        std::uint64_t zerosLeft = 0;
+        std::uint64_t literalsLeft = 0;
+
+        void copyLiterals(std::uint64_t* words, std::size_t count)
+        {
+            std::size_t bytes = count * sizeof(std::uint64_t);
+            if (static_cast<std::size_t>(end - at) < bytes)
+            {
+                throw std::runtime_error("Snapshot data is truncated");
+            }
+            std::memcpy(words, at, bytes);
+            at += bytes;
+        }
+    };
+
+    // Returns how many words compressed data expands to, reading only its tokens
+    std::uint64_t countCompressedWords(const char* begin, const char* end)
+    {
+        std::uint64_t words = 0;
+        for (const char* at = begin; at != end;)
+        {
+            if (static_cast<std::size_t>(end - at) < sizeof(std::uint64_t))
+            {
+                throw std::runtime_error("Snapshot data is truncated");
+            }
+            std::uint64_t token;
+            std::memcpy(&token, at, sizeof(token));
+            at += sizeof(token);
+
+            std::uint64_t length = token & ~ZERO_RUN;
+            if (!(token & ZERO_RUN))
+            {
+                if (length > static_cast<std::uint64_t>(end - at) / sizeof(std::uint64_t))
+                {
+                    throw std::runtime_error("Snapshot data is truncated");
+                }
+                at += length * sizeof(std::uint64_t);
+            }
+            if (length > ~words)
+            {
+                throw std::runtime_error("Snapshot data is corrupt");
+            }
+            words += length;
+        }
+        return words;
+    }
+}
+
+LifeSnapshot::LifeSnapshot(const LifeSimulator& sim) :
+    cells(sim.shareBoard()),
+    ages(sim.ages),
+    agePlaneCount(sim.agePlaneCount),
+    generation(sim.generation),
+    ruleNotation(sim.rule.toString())
+{
+}
+
+std::uint64_t LifeSnapshot::getGeneration() const
+{
+    return generation;
+}
+
+void LifeSnapshot::save(const std::string& path, bool compress) const
+{
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + temporaryPath);
+        }
+
+        Header header = {};
+        std::copy(std::begin(MAGIC), std::end(MAGIC), header.magic);
+        header.version = VERSION;
+        header.flags = compress ? FLAG_COMPRESSED : 0;
+        header.sizeX = cells->getSizeX();
+        header.sizeY = cells->getSizeY();
+        header.generation = generation;
+        header.agePlaneCount = agePlaneCount;
+        header.ruleLength = static_cast<std::uint32_t>(ruleNotation.size());
+        header.wordsPerRow = cells->getWordsPerRow();
+        header.byteOrder = BYTE_ORDER_MARK;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::string rule = ruleNotation;
+        rule.resize(paddedToWord(rule.size()), '\0');
+        out.write(rule.data(), static_cast<std::streamsize>(rule.size()));
+
+        // Rows go out without the halo copy LifeBoard keeps past the last cell
+        WordWriter writer(out, compress);
+        std::vector<std::uint64_t> row(cells->getWordsPerRow());
+        for (std::uint32_t y = 0; y < cells->getSizeY(); ++y)
+        {
+            std::copy(cells->getRow(y), cells->getRow(y) + row.size(), row.begin());
+            if (!row.empty())
+            {
+                row.back() &= lastWordMask(cells->getSizeX());
+            }
+            writer.add(row.data(), row.size());
+        }
+        writer.add(ages.data(), ages.size());
+        writer.finish();
+
+        header.dataWords = writer.getWrittenCount();
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + temporaryPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        throw std::runtime_error("Cannot replace " + path + ": " + error.message());
+    }
+}
+
+LifeSimulator LifeSnapshot::load(const std::string& path)
+{
+    MappedFile file(path);
+
+    Header header;
+    if (file.size() < sizeof(header))
+    {
+        throw std::runtime_error(path + " is too short to be a snapshot");
+    }
+    std::memcpy(&header, file.begin(), sizeof(header));
+    if (!std::equal(std::begin(MAGIC), std::end(MAGIC), header.magic))
+    {
+        throw std::runtime_error(path + " is not a snapshot");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK || header.version != VERSION)
+    {
+        throw std::runtime_error(path + " was written by another version or on a machine of another byte order");
+    }
+
+    // The rule length is checked against the file before it moves a pointer,
+    // which must not point past the mapping even for a moment
+    if (paddedToWord(header.ruleLength) > file.size() - sizeof(header) || header.wordsPerRow != wordsForCells(header.sizeX))
+    {
+        throw std::runtime_error(path + " has a corrupt header");
+    }
+    const char* data = file.begin() + sizeof(header) + paddedToWord(header.ruleLength);
+
+    LifeRule rule;
+    try
+    {
+        rule = LifeRule::parse(std::string(file.begin() + sizeof(header), header.ruleLength));
+    }
+    catch (const std::invalid_argument& error)
+    {
+        throw std::runtime_error(path + " has a bad rule: " + error.what());
+    }
+
+    if (LifeSimulator::countAgePlanes(rule) != header.agePlaneCount)
+    {
+        throw std::runtime_error(path + " has ages that do not match its rule");
+    }
+
+    bool compressed = (header.flags & FLAG_COMPRESSED) != 0;
+    std::uint64_t dataBytes = header.dataWords * sizeof(std::uint64_t);
+    if (header.dataWords > ZERO_RUN / sizeof(std::uint64_t) || dataBytes > static_cast<std::uint64_t>(file.end() - data))
+    {
+        throw std::runtime_error("Snapshot data is truncated");
+    }
+
+    // Nothing is allocated for the board the header describes until the data
+    // is known to hold exactly its cells and ages: word for word when stored
+    // as is, or once the tokens are added up when compressed
+    std::uint64_t boardWords = std::uint64_t(header.sizeY) * header.wordsPerRow * (1 + header.agePlaneCount);
+    std::uint64_t storedWords = compressed ? countCompressedWords(data, data + dataBytes) : header.dataWords;
+    if (storedWords != boardWords)
+    {
+        throw std::runtime_error(path + " holds " + std::to_string(storedWords) + " words of data for a board of " + std::to_string(boardWords));
+    }
+
+    LifeSimulator sim(0, 0);
+    try
+    {
+        sim = LifeSimulator(header.sizeX, header.sizeY, rule);
+    }
+    catch (const std::invalid_argument& error)
+    {
+        throw std::runtime_error(path + " has a bad rule: " + error.what());
+    }
+
+    // Straight out of the mapping into the rows; nothing to parse unless
+    // compressed. save() leaves the bits past the last cell clear, but a
+    // corrupt file may not, and the kernel counts on them staying clear.
+    WordReader reader(data, data + dataBytes, compressed);
+    std::size_t wordsPerRow = static_cast<std::size_t>(header.wordsPerRow);
+    std::uint64_t lastMask = lastWordMask(header.sizeX);
+    for (std::uint32_t y = 0; y < header.sizeY; ++y)
+    {
+        std::uint64_t* row = sim.board->getRow(y);
+        reader.read(row, wordsPerRow);
+        if (wordsPerRow)
+        {
+            row[wordsPerRow - 1] &= lastMask;
+        }
+    }
+    reader.read(sim.ages.data(), sim.ages.size());
+    for (std::size_t end = wordsPerRow; wordsPerRow && end <= sim.ages.size(); end += wordsPerRow)
+    {
+        sim.ages[end - 1] &= lastMask;
+    }
+
+    sim.generation = header.generation;
+    sim.recountTiles(0, header.sizeY);
+    sim.allTilesActive = true;
+    return sim;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "LifeBoard.hpp"
+#include "LifeSimulator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One generation of a LifeSimulator, in a form that can be saved to a file
+// and loaded back. Taking a snapshot shares the simulator's board rather
+// than copying it; the simulator copies the board on write from then on.
+// Only Generations ages are copied, so a snapshot can be taken between any
+// two generations and saved on another thread while the simulation moves on,
+// as long as the snapshot is destroyed back on the simulation's thread.
+//
+// The file is a 64-byte header, the rule's notation padded to a whole word,
+// then the data: every row's cell words, followed by the age planes when the
+// rule has any, as 64-bit words in the machine's byte order. The data may be
+// stored as is, so loading is one copy per row out of a memory-mapped file,
+// or compressed into runs of zero words and literal words.
+class LifeSnapshot
+{
+  public:
+    explicit LifeSnapshot(const LifeSimulator& sim);
+
+    std::uint64_t getGeneration() const;
+
+    // Writes to a temporary file next to path, then renames it over path, so
+    // a crash never leaves a torn snapshot. Throws std::runtime_error.
+    void save(const std::string& path, bool compress = false) const;
+
+    // Throws std::runtime_error if the file cannot be read or is not a
+    // snapshot written on a machine of the same byte order
+    static LifeSimulator load(const std::string& path);
+
+  private:
+    std::shared_ptr<const LifeBoard> cells;
+    std::vector<std::uint64_t> ages;
+    std::uint32_t agePlaneCount;
+    std::uint64_t generation;
+    std::string ruleNotation;
+};
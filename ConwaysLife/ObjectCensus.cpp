@@ -0,0 +1,587 @@
+#include "ObjectCensus.hpp"
+
+#include "LifeKernel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    // Strips of rows per thread, so threads that finish early find more
+    const std::size_t STRIPS_PER_THREAD = 4;
+    const std::size_t OBJECTS_PER_TASK = 256;
+
+    // Common objects, rows split by '/', 'O' for a live cell. Every phase of
+    // an oscillator or spaceship is listed unless it is a rotation or
+    // reflection of one already there.
+    struct KnownObject
+    {
+        const char* name;
+        const char* cells;
+    };
+
+    const KnownObject KNOWN_OBJECTS[] = {
+        { "block", "OO/OO" },
+        { "beehive", ".OO./O..O/.OO." },
+        { "loaf", ".OO./O..O/.O.O/..O." },
+        { "boat", "OO./O.O/.O." },
+        { "ship", "OO./O.O/.OO" },
+        { "tub", ".O./O.O/.O." },
+        { "pond", ".OO./O..O/O..O/.OO." },
+        { "barge", ".O../O.O./.O.O/..O." },
+        { "long boat", "OO../O.O./.O.O/..O." },
+        { "mango", ".OO../O..O./.O..O/..OO." },
+        { "eater", "OO../O.O./..O./..OO" },
+        { "snake", "OO.O/O.OO" },
+        { "aircraft carrier", "OO../O..O/..OO" },
+        { "blinker", "OOO" },
+        { "toad", ".OOO/OOO." },
+        { "toad", "..O./O..O/O..O/.O.." },
+        { "beacon", "OO../OO../..OO/..OO" },
+        { "beacon", "OO../O.../...O/..OO" },
+        { "glider", ".O./..O/OOO" },
+        { "glider", "O.O/.OO/.O." },
+        { "lightweight spaceship", ".O..O/O..../O...O/OOOO." },
+        { "lightweight spaceship", "..OO./OO.OO/OOOO./.OO.." },
+    };
+
+    using Cells = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+    std::uint64_t mixWord(std::uint64_t hash, std::uint64_t word)
+    {
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        return hash ^ (hash >> 29);
+    }
+
+    // Form of cells given from the corner of their sizeX by sizeY box: the
+    // least hash of the cells' rows over the eight ways to turn the box
+    std::uint64_t computeForm(const Cells& cells, std::uint32_t sizeX, std::uint32_t sizeY, std::vector<std::uint64_t>& bits)
+    {
+        std::uint64_t form = std::numeric_limits<std::uint64_t>::max();
+        for (unsigned symmetry = 0; symmetry < 8; ++symmetry)
+        {
+            // Mirror left to right, top to bottom, then across the diagonal
+            bool transpose = (symmetry & 4) != 0;
+            std::uint32_t width = transpose ? sizeY : sizeX;
+            std::uint32_t height = transpose ? sizeX : sizeY;
+            std::size_t words = wordsForCells(width);
+            bits.assign(words * height, 0);
+            for (const auto& cell : cells)
+            {
+                std::uint32_t x = symmetry & 1 ? sizeX - 1 - cell.first : cell.first;
+                std::uint32_t y = symmetry & 2 ? sizeY - 1 - cell.second : cell.second;
+                if (transpose)
+                {
+                    std::swap(x, y);
+                }
+                bits[y * words + x / CELLS_PER_WORD] |= std::uint64_t(1) << (x % CELLS_PER_WORD);
+            }
+
+            std::uint64_t hash = mixWord(mixWord(0, width), height);
+            for (std::uint64_t word : bits)
+            {
+                hash = mixWord(hash, word);
+            }
+            form = std::min(form, mixWord(hash, cells.size()));
+        }
+        return form;
+    }
+
+    // Forms of KNOWN_OBJECTS, sorted, built on first use
+    const std::vector<std::pair<std::uint64_t, const char*>>& getKnownForms()
+    {
+        static const std::vector<std::pair<std::uint64_t, const char*>> forms = [] {
+            std::vector<std::pair<std::uint64_t, const char*>> known;
+            Cells cells;
+            std::vector<std::uint64_t> bits;
+            for (const KnownObject& object : KNOWN_OBJECTS)
+            {
+                cells.clear();
+                std::uint32_t x = 0;
+                std::uint32_t y = 0;
+                std::uint32_t sizeX = 0;
+                for (const char* c = object.cells; *c; ++c)
+                {
+                    if (*c == '/')
+                    {
+                        x = 0;
+                        ++y;
+                        continue;
+                    }
+                    if (*c == 'O')
+                    {
+                        cells.emplace_back(x, y);
+                    }
+                    sizeX = std::max(sizeX, ++x);
+                }
+                known.emplace_back(computeForm(cells, sizeX, y + 1, bits), object.name);
+            }
+            std::sort(known.begin(), known.end());
+            return known;
+        }();
+        return forms;
+    }
+
+    // First set bit after the longest run of clear bits in [0, size), taken
+    // around the end, or 0 if no bit is set
+    std::uint32_t findStart(const std::vector<std::uint64_t>& bits, std::uint32_t size)
+    {
+        std::uint32_t first = size;
+        std::uint32_t previous = 0;
+        std::uint32_t start = 0;
+        std::uint32_t longest = 0;
+        for (std::uint32_t i = 0; i < size; ++i)
+        {
+            if (!((bits[i / CELLS_PER_WORD] >> (i % CELLS_PER_WORD)) & 1))
+            {
+                continue;
+            }
+            if (first == size)
+            {
+                first = i;
+            }
+            else if (i - previous - 1 > longest)
+            {
+                longest = i - previous - 1;
+                start = i;
+            }
+            previous = i;
+        }
+        if (first == size)
+        {
+            return 0;
+        }
+        return first + size - previous - 1 >= longest ? first : start;
+    }
+}
+
+void ObjectCensus::setThreadCount(std::size_t threadCount)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    pool.reset();
+    if (threadCount > 1)
+    {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+}
+
+std::size_t ObjectCensus::getThreadCount() const
+{
+    return pool ? pool->getThreadCount() : 1;
+}
+
+void ObjectCensus::setReach(std::uint32_t reach)
+{
+    this->reach = std::max<std::uint32_t>(reach, 1);
+}
+
+std::uint32_t ObjectCensus::getReach() const
+{
+    return reach;
+}
+
+void ObjectCensus::take(const Pattern& board, bool wrap)
+{
+    sizeX = board.getSizeX();
+    sizeY = board.getSizeY();
+    wordsPerRow = wordsForCells(sizeX);
+    rows.resize(wordsPerRow * sizeY);
+    for (std::uint32_t y = 0; y < sizeY; ++y)
+    {
+        board.getRow(y, rows.data() + y * wordsPerRow);
+    }
+    scratch.resize(getThreadCount());
+
+    // Runs of each strip, numbered from the strip's first
+    std::size_t stripCount = std::min<std::size_t>(sizeY, getThreadCount() * STRIPS_PER_THREAD);
+    auto stripBegin = [this, stripCount](std::size_t strip) { return static_cast<std::uint32_t>(strip * sizeY / stripCount); };
+    stripRuns.resize(stripCount);
+    rowFirstRun.resize(static_cast<std::size_t>(sizeY) + 1);
+    forEachTask(stripCount, [this, &stripBegin](std::size_t strip, std::size_t) { findRuns(stripBegin(strip), stripBegin(strip + 1), stripRuns[strip]); });
+
+    runs.clear();
+    for (std::size_t strip = 0; strip < stripCount; ++strip)
+    {
+        auto offset = static_cast<std::uint32_t>(runs.size());
+        for (std::uint32_t y = stripBegin(strip); y < stripBegin(strip + 1); ++y)
+        {
+            rowFirstRun[y] += offset;
+        }
+        runs.insert(runs.end(), stripRuns[strip].begin(), stripRuns[strip].end());
+    }
+    rowFirstRun[sizeY] = static_cast<std::uint32_t>(runs.size());
+
+    // Joining runs within a strip only touches the strip's own parents
+    parents.resize(runs.size());
+    forEachTask(stripCount, [this, &stripBegin, wrap](std::size_t strip, std::size_t) {
+        for (std::uint32_t y = stripBegin(strip); y < stripBegin(strip + 1); ++y)
+        {
+            for (std::uint32_t run = rowFirstRun[y]; run < rowFirstRun[y + 1]; ++run)
+            {
+                parents[run] = run;
+            }
+            joinRow(y, wrap);
+            for (std::uint32_t above = y - std::min(y - stripBegin(strip), reach); above < y; ++above)
+            {
+                joinRows(above, y, wrap);
+            }
+        }
+    });
+
+    // Then rows within reach of each other across the strips' edges, and
+    // across the board's top and bottom edges on a torus
+    for (std::size_t strip = 1; strip < stripCount; ++strip)
+    {
+        std::uint32_t begin = stripBegin(strip);
+        for (std::uint32_t y = begin; y < std::min(begin + reach, sizeY); ++y)
+        {
+            for (std::uint32_t above = y - std::min(y, reach); above < begin; ++above)
+            {
+                joinRows(above, y, wrap);
+            }
+        }
+    }
+    if (wrap)
+    {
+        for (std::uint32_t y = 0; y < std::min(reach, sizeY); ++y)
+        {
+            for (std::uint32_t distance = y + 1; distance <= reach; ++distance)
+            {
+                joinRows((y + sizeY - distance % sizeY) % sizeY, y, wrap);
+            }
+        }
+    }
+
+    // Each set's root is its first run, so objects are numbered in the order
+    // their first runs come in, and their runs sorted by object
+    std::uint32_t objectCount = 0;
+    objectOfRun.resize(runs.size());
+    for (std::uint32_t run = 0; run < runs.size(); ++run)
+    {
+        std::uint32_t root = findRoot(run);
+        objectOfRun[run] = root == run ? objectCount++ : objectOfRun[root];
+    }
+    objectFirstRun.assign(static_cast<std::size_t>(objectCount) + 1, 0);
+    for (std::uint32_t object : objectOfRun)
+    {
+        ++objectFirstRun[object + 1];
+    }
+    for (std::uint32_t object = 0; object < objectCount; ++object)
+    {
+        objectFirstRun[object + 1] += objectFirstRun[object];
+    }
+    objectRuns.resize(runs.size());
+    for (std::uint32_t run = 0; run < runs.size(); ++run)
+    {
+        objectRuns[objectFirstRun[objectOfRun[run]]++] = run;
+    }
+    // Filling moved each start up to the next object's
+    std::memmove(objectFirstRun.data() + 1, objectFirstRun.data(), objectCount * sizeof(std::uint32_t));
+    objectFirstRun[0] = 0;
+
+    objects.resize(objectCount);
+    forEachTask((objectCount + OBJECTS_PER_TASK - 1) / OBJECTS_PER_TASK, [this, objectCount, wrap](std::size_t task, std::size_t thread) {
+        auto end = static_cast<std::uint32_t>(std::min<std::size_t>((task + 1) * OBJECTS_PER_TASK, objectCount));
+        for (auto object = static_cast<std::uint32_t>(task * OBJECTS_PER_TASK); object < end; ++object)
+        {
+            measureObject(object, wrap, scratch[thread]);
+        }
+    });
+
+    tallies.clear();
+    std::unordered_map<std::uint64_t, std::size_t> tallyOfForm;
+    for (const Object& object : objects)
+    {
+        auto found = tallyOfForm.emplace(object.form, tallies.size());
+        if (found.second)
+        {
+            tallies.push_back({ object.form, getName(object.form), object.population, 0 });
+        }
+        ++tallies[found.first->second].count;
+    }
+    std::sort(tallies.begin(), tallies.end(), [](const Tally& a, const Tally& b) {
+        if (a.count != b.count)
+        {
+            return a.count > b.count;
+        }
+        return a.population != b.population ? a.population < b.population : a.form < b.form;
+    });
+}
+
+const std::vector<ObjectCensus::Object>& ObjectCensus::getObjects() const
+{
+    return objects;
+}
+
+const std::vector<ObjectCensus::Tally>& ObjectCensus::getTallies() const
+{
+    return tallies;
+}
+
+std::uint64_t ObjectCensus::getForm(const Pattern& pattern)
+{
+    std::vector<std::uint64_t> row(wordsForCells(pattern.getSizeX()));
+    Cells cells;
+    std::uint32_t minX = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t minY = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t maxX = 0;
+    std::uint32_t maxY = 0;
+    for (std::uint32_t y = 0; y < pattern.getSizeY(); ++y)
+    {
+        pattern.getRow(y, row.data());
+        for (std::size_t word = 0; word < row.size(); ++word)
+        {
+            for (std::uint64_t bits = row[word]; bits; bits &= bits - 1)
+            {
+                auto x = static_cast<std::uint32_t>(word * CELLS_PER_WORD + countSetBits((bits & (0 - bits)) - 1));
+                cells.emplace_back(x, y);
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = y;
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> bits;
+    if (cells.empty())
+    {
+        return computeForm(cells, 0, 0, bits);
+    }
+    for (auto& cell : cells)
+    {
+        cell.first -= minX;
+        cell.second -= minY;
+    }
+    return computeForm(cells, maxX - minX + 1, maxY - minY + 1, bits);
+}
+
+const char* ObjectCensus::getName(std::uint64_t form)
+{
+    const auto& forms = getKnownForms();
+    auto found = std::lower_bound(forms.begin(), forms.end(), std::make_pair(form, static_cast<const char*>(nullptr)));
+    return found != forms.end() && found->first == form ? found->second : nullptr;
+}
+
+template <typename Body>
+void ObjectCensus::forEachTask(std::size_t taskCount, const Body& body)
+{
+    if (pool)
+    {
+        pool->parallelFor(taskCount, body);
+        return;
+    }
+
+    for (std::size_t task = 0; task < taskCount; ++task)
+    {
+        body(task, 0);
+    }
+}
+
+void ObjectCensus::findRuns(std::uint32_t beginY, std::uint32_t endY, std::vector<Run>& found)
+{
+    found.clear();
+    for (std::uint32_t y = beginY; y < endY; ++y)
+    {
+        // Numbered from the strip's first run until the strips are joined up
+        rowFirstRun[y] = static_cast<std::uint32_t>(found.size());
+        const std::uint64_t* row = rows.data() + y * wordsPerRow;
+        for (std::uint32_t x = findCell(row, 0, true); x < sizeX;)
+        {
+            std::uint32_t end = findCell(row, x, false);
+            found.push_back({ y, x, end });
+            x = findCell(row, end, true);
+        }
+    }
+}
+
+std::uint32_t ObjectCensus::findCell(const std::uint64_t* row, std::uint32_t x, bool alive) const
+{
+    if (x >= sizeX)
+    {
+        return sizeX;
+    }
+
+    // Dead cells are looked for as the set bits of the flipped row
+    std::uint64_t flip = alive ? 0 : ~std::uint64_t(0);
+    std::size_t word = x / CELLS_PER_WORD;
+    std::uint64_t bits = (row[word] ^ flip) & (~std::uint64_t(0) << (x % CELLS_PER_WORD));
+    while (!bits)
+    {
+        if (++word == wordsPerRow)
+        {
+            return sizeX;
+        }
+        bits = row[word] ^ flip;
+    }
+    return std::min(static_cast<std::uint32_t>(word * CELLS_PER_WORD + countSetBits((bits & (0 - bits)) - 1)), sizeX);
+}
+
+std::uint32_t ObjectCensus::findRoot(std::uint32_t run)
+{
+    // Path halving: each run passed on the way up skips to its grandparent
+    while (parents[run] != run)
+    {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+void ObjectCensus::join(std::uint32_t a, std::uint32_t b)
+{
+    a = findRoot(a);
+    b = findRoot(b);
+    // The earlier run stays the root
+    if (a < b)
+    {
+        parents[b] = a;
+    }
+    else if (b < a)
+    {
+        parents[a] = b;
+    }
+}
+
+void ObjectCensus::joinRow(std::uint32_t y, bool wrap)
+{
+    for (std::uint32_t run = rowFirstRun[y] + 1; run < rowFirstRun[y + 1]; ++run)
+    {
+        if (runs[run].begin - runs[run - 1].end < reach)
+        {
+            join(run - 1, run);
+        }
+    }
+    if (wrap)
+    {
+        joinAcrossEdge(y, y);
+    }
+}
+
+void ObjectCensus::joinRows(std::uint32_t above, std::uint32_t below, bool wrap)
+{
+    // Runs join unless one ends reach or more cells before the other begins.
+    // Runs of below that end too early for one run of above do for the rest.
+    std::uint32_t firstBelow = rowFirstRun[below];
+    std::uint32_t endBelow = rowFirstRun[below + 1];
+    for (std::uint32_t a = rowFirstRun[above]; a < rowFirstRun[above + 1]; ++a)
+    {
+        while (firstBelow < endBelow && runs[firstBelow].end + reach <= runs[a].begin)
+        {
+            ++firstBelow;
+        }
+        for (std::uint32_t b = firstBelow; b < endBelow && runs[b].begin < runs[a].end + reach; ++b)
+        {
+            join(a, b);
+        }
+    }
+
+    if (wrap)
+    {
+        joinAcrossEdge(above, below);
+        joinAcrossEdge(below, above);
+    }
+}
+
+void ObjectCensus::joinAcrossEdge(std::uint32_t left, std::uint32_t right)
+{
+    std::uint32_t firstLeft = rowFirstRun[left];
+    std::uint32_t firstRight = rowFirstRun[right];
+    std::uint32_t endRight = rowFirstRun[right + 1];
+    for (std::uint32_t a = rowFirstRun[left + 1]; a > firstLeft && sizeX - runs[a - 1].end < reach; --a)
+    {
+        for (std::uint32_t b = firstRight; b < endRight && runs[b].begin + (sizeX - runs[a - 1].end) < reach; ++b)
+        {
+            join(a - 1, b);
+        }
+    }
+}
+
+void ObjectCensus::measureObject(std::uint32_t object, bool wrap, Scratch& buffers)
+{
+    std::uint32_t first = objectFirstRun[object];
+    std::uint32_t last = objectFirstRun[object + 1];
+
+    // On a torus, an object that may reach across an edge is read from the
+    // far side of the widest gap in its columns, and of the widest in its rows
+    std::uint32_t startX = 0;
+    std::uint32_t startY = 0;
+    if (wrap)
+    {
+        bool left = false;
+        bool right = false;
+        for (std::uint32_t i = first; i < last; ++i)
+        {
+            left |= runs[objectRuns[i]].begin < reach;
+            right |= sizeX - runs[objectRuns[i]].end < reach;
+        }
+        if (left && right)
+        {
+            buffers.bits.assign(wordsForCells(sizeX), 0);
+            for (std::uint32_t i = first; i < last; ++i)
+            {
+                const Run& run = runs[objectRuns[i]];
+                fillBits(buffers.bits.data(), run.begin, run.end - run.begin, true);
+            }
+            startX = findStart(buffers.bits, sizeX);
+        }
+
+        // Runs come in row order
+        if (runs[objectRuns[first]].y < reach && sizeY - 1 - runs[objectRuns[last - 1]].y < reach)
+        {
+            buffers.bits.assign(wordsForCells(sizeY), 0);
+            for (std::uint32_t i = first; i < last; ++i)
+            {
+                std::uint32_t y = runs[objectRuns[i]].y;
+                buffers.bits[y / CELLS_PER_WORD] |= std::uint64_t(1) << (y % CELLS_PER_WORD);
+            }
+            startY = findStart(buffers.bits, sizeY);
+        }
+    }
+    auto unwrapX = [this, startX](std::uint32_t x) { return x >= startX ? x - startX : x + sizeX - startX; };
+    auto unwrapY = [this, startY](std::uint32_t y) { return y >= startY ? y - startY : y + sizeY - startY; };
+
+    std::uint32_t minX = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t minY = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t maxX = 0;
+    std::uint32_t maxY = 0;
+    std::uint32_t population = 0;
+    for (std::uint32_t i = first; i < last; ++i)
+    {
+        const Run& run = runs[objectRuns[i]];
+        std::uint32_t x = unwrapX(run.begin);
+        std::uint32_t y = unwrapY(run.y);
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x + (run.end - run.begin) - 1);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        population += run.end - run.begin;
+    }
+
+    buffers.cells.clear();
+    for (std::uint32_t i = first; i < last; ++i)
+    {
+        const Run& run = runs[objectRuns[i]];
+        std::uint32_t x = unwrapX(run.begin) - minX;
+        std::uint32_t y = unwrapY(run.y) - minY;
+        for (std::uint32_t cell = 0; cell < run.end - run.begin; ++cell)
+        {
+            buffers.cells.emplace_back(x + cell, y);
+        }
+    }
+
+    Object& measured = objects[object];
+    measured.x = (minX + startX) % sizeX;
+    measured.y = (minY + startY) % sizeY;
+    measured.sizeX = maxX - minX + 1;
+    measured.sizeY = maxY - minY + 1;
+    measured.population = population;
+    measured.form = computeForm(buffers.cells, measured.sizeX, measured.sizeY, buffers.bits);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Pattern.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Splits a board into objects, each a set of live cells that lie within reach
+// of one another, and tallies them by shape. Every shape is reduced to a
+// form: a hash that stays the same under all eight rotations and reflections,
+// so objects are compared by number rather than cell by cell, and common
+// objects are named from a table of their forms.
+//
+// Rows are cut into runs of live cells, and runs that touch are joined with
+// union-find, each strip of rows on a thread of its own. The strips are then
+// stitched together, and the objects hashed, again in parallel.
+//
+// With a reach of 1, cells join only their eight neighbors, and an oscillator
+// or spaceship that falls apart in some phases, such as the toad, the beacon
+// or the lightweight spaceship, is counted as its pieces there. The default
+// reach of 2 also joins cells with one dead cell between them, which holds
+// those together, at the cost of counting two still lifes that close, such as
+// a bi-block, as one object.
+class ObjectCensus
+{
+  public:
+    struct Object
+    {
+        // Corner of the object's bounding box on the board. On a torus the
+        // box may run on past the right and bottom edges.
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t sizeX;
+        std::uint32_t sizeY;
+        std::uint32_t population;
+        std::uint64_t form;
+    };
+
+    // Objects of one form
+    struct Tally
+    {
+        std::uint64_t form;
+        // nullptr for forms not in the table
+        const char* name;
+        std::uint32_t population;
+        std::size_t count;
+    };
+
+    // 0 uses one thread per hardware thread
+    void setThreadCount(std::size_t threadCount);
+    std::size_t getThreadCount() const;
+
+    // Cells join when no more than reach cells apart across and down, at least 1
+    void setReach(std::uint32_t reach);
+    std::uint32_t getReach() const;
+
+    // Takes the census of the board's live cells, replacing the last one.
+    // With wrap, cells join across the edges as they do on a torus.
+    void take(const Pattern& board, bool wrap);
+
+    // Objects in order of their top-most, then left-most, cell
+    const std::vector<Object>& getObjects() const;
+    // One tally per form seen, most common first
+    const std::vector<Tally>& getTallies() const;
+
+    // Form of the live cells of a pattern, wherever they lie in it
+    static std::uint64_t getForm(const Pattern& pattern);
+    // Name of a common object's form, or nullptr if it has none
+    static const char* getName(std::uint64_t form);
+
+  private:
+    // Live cells [begin, end) of row y
+    struct Run
+    {
+        std::uint32_t y;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Buffers of one thread, kept between censuses
+    struct Scratch
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> cells;
+        std::vector<std::uint64_t> bits;
+    };
+
+    std::unique_ptr<ThreadPool> pool;
+    std::uint32_t reach = 2;
+
+    std::uint32_t sizeX = 0;
+    std::uint32_t sizeY = 0;
+    std::size_t wordsPerRow = 0;
+    std::vector<std::uint64_t> rows;
+
+    std::vector<std::vector<Run>> stripRuns;
+    std::vector<Run> runs;
+    // Runs of row y are [rowFirstRun[y], rowFirstRun[y + 1])
+    std::vector<std::uint32_t> rowFirstRun;
+    std::vector<std::uint32_t> parents;
+    // Runs of object i are objectRuns[objectFirstRun[i]] to objectRuns[objectFirstRun[i + 1] - 1]
+    std::vector<std::uint32_t> objectOfRun;
+    std::vector<std::uint32_t> objectFirstRun;
+    std::vector<std::uint32_t> objectRuns;
+    std::vector<Scratch> scratch;
+
+    std::vector<Object> objects;
+    std::vector<Tally> tallies;
+
+    template <typename Body>
+    void forEachTask(std::size_t taskCount, const Body& body);
+
+    void findRuns(std::uint32_t beginY, std::uint32_t endY, std::vector<Run>& found);
+    // First cell of a row at or past x that is alive, or dead, or sizeX if none is
+    std::uint32_t findCell(const std::uint64_t* row, std::uint32_t x, bool alive) const;
+    std::uint32_t findRoot(std::uint32_t run);
+    void join(std::uint32_t a, std::uint32_t b);
+    void joinRow(std::uint32_t y, bool wrap);
+    void joinRows(std::uint32_t above, std::uint32_t below, bool wrap);
+    // Joins runs near the right edge of row left to those near the left edge of row right
+    void joinAcrossEdge(std::uint32_t left, std::uint32_t right);
+    void measureObject(std::uint32_t object, bool wrap, Scratch& buffers);
+};
@@ -0,0 +1,15 @@
+#include "Pattern.hpp"
+
+#include "LifeKernel.hpp"
+
+#include <algorithm>
+
+void Pattern::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    std::uint32_t sizeX = getSizeX();
+    std::fill(words, words + wordsForCells(sizeX), 0);
+    for (std::uint32_t x = 0; x < sizeX; ++x)
+    {
+        words[x / CELLS_PER_WORD] |= static_cast<std::uint64_t>(getCell(x, y)) << (x % CELLS_PER_WORD);
+    }
+}
@@ -5,7 +5,16 @@
 class Pattern
 {
   public:
-    virtual std::uint8_t getSizeX() const = 0;
-    virtual std::uint8_t getSizeY() const = 0;
-    virtual bool getCell(std::uint8_t x, std::uint8_t y) const = 0;
+    virtual ~Pattern() = default;
+
+    virtual std::uint32_t getSizeX() const = 0;
+    virtual std::uint32_t getSizeY() const = 0;
+    virtual bool getCell(std::uint32_t x, std::uint32_t y) const = 0;
+
+    // Writes row y packed 64 cells to a word, cell x in bit x % 64 of word
+    // x / 64, into wordsForCells(getSizeX()) words with the bits past the
+    // row clear. Engines insert patterns a row at a time through this; the
+    // default asks getCell() for each cell, so patterns that already hold
+    // packed rows should override it.
+    virtual void getRow(std::uint32_t y, std::uint64_t* words) const;
 };
@@ -0,0 +1,33 @@
+#include "PatternBitmap.hpp"
+
+#include <algorithm>
+
+PatternBitmap::PatternBitmap(const Pattern& pattern) :
+    cells(pattern.getSizeX(), pattern.getSizeY())
+{
+    for (std::uint32_t y = 0; y < cells.getSizeY(); ++y)
+    {
+        pattern.getRow(y, cells.getRow(y));
+    }
+}
+
+std::uint32_t PatternBitmap::getSizeX() const
+{
+    return cells.getSizeX();
+}
+
+std::uint32_t PatternBitmap::getSizeY() const
+{
+    return cells.getSizeY();
+}
+
+bool PatternBitmap::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    return cells.getCell(x, y);
+}
+
+void PatternBitmap::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    const std::uint64_t* row = cells.getRow(y);
+    std::copy(row, row + cells.getWordsPerRow(), words);
+}
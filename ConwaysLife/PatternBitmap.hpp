@@ -0,0 +1,20 @@
+#pragma once
+
+#include "LifeBoard.hpp"
+#include "Pattern.hpp"
+
+// Any pattern, read once and held as packed rows, so getRow() is a plain copy.
+// Wrap a hand-written pattern in one before stamping it many times.
+class PatternBitmap : public Pattern
+{
+  public:
+    explicit PatternBitmap(const Pattern& pattern);
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+
+  private:
+    LifeBoard cells;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "LifeKernel.hpp"
+#include "Pattern.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+// Patterns written as text: 'O' for a live cell, '.' for a dead one, and '/'
+// between rows. Rows shorter than the widest are dead past their end. Any
+// other character throws std::invalid_argument, which fails the build when
+// the text is read at compile time.
+constexpr std::uint32_t countTextColumns(const char* cells)
+{
+    std::uint32_t widest = 0;
+    std::uint32_t column = 0;
+    for (; *cells; ++cells)
+    {
+        if (*cells == '/')
+        {
+            column = 0;
+        }
+        else if (*cells == 'O' || *cells == '.')
+        {
+            widest = std::max(widest, ++column);
+        }
+        else
+        {
+            throw std::invalid_argument("Pattern text holds only 'O', '.' and '/'");
+        }
+    }
+    return widest;
+}
+
+constexpr std::uint32_t countTextRows(const char* cells)
+{
+    std::uint32_t rows = 1;
+    for (; *cells; ++cells)
+    {
+        rows += *cells == '/';
+    }
+    return rows;
+}
+
+// Rows of a pattern written as text, packed as Pattern::getRow() writes them
+template <std::uint32_t SizeX, std::uint32_t SizeY>
+constexpr std::array<std::uint64_t, SizeY*((SizeX + CELLS_PER_WORD - 1) / CELLS_PER_WORD)> packTextRows(const char* cells)
+{
+    std::array<std::uint64_t, SizeY*((SizeX + CELLS_PER_WORD - 1) / CELLS_PER_WORD)> rows = {};
+    std::size_t wordsPerRow = (SizeX + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+    std::size_t x = 0;
+    std::size_t y = 0;
+    for (; *cells; ++cells)
+    {
+        if (*cells == '/')
+        {
+            x = 0;
+            ++y;
+            continue;
+        }
+        if (*cells == 'O')
+        {
+            rows[y * wordsPerRow + x / CELLS_PER_WORD] |= std::uint64_t(1) << (x % CELLS_PER_WORD);
+        }
+        ++x;
+    }
+    return rows;
+}
+
+// A pattern fixed at compile time. Its size and packed rows are constants of
+// the type, so code that knows the type reads them straight, with no virtual
+// calls; see LifeSimulator::insertPattern(). Through the Pattern interface it
+// goes anywhere any other pattern does.
+//
+// C++17 takes no string literal as a template argument, so Cells names an
+// array of text, declared inline constexpr:
+//
+//     inline constexpr char GLIDER_CELLS[] = ".O./..O/OOO";
+//     using PatternGlider = PatternCells<GLIDER_CELLS>;
+template <const char* Cells>
+class PatternCells : public Pattern
+{
+  public:
+    static constexpr std::uint32_t SIZE_X = countTextColumns(Cells);
+    static constexpr std::uint32_t SIZE_Y = countTextRows(Cells);
+    static constexpr std::size_t WORDS_PER_ROW = (SIZE_X + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+    // Row y is words [y * WORDS_PER_ROW, (y + 1) * WORDS_PER_ROW)
+    static constexpr std::array<std::uint64_t, SIZE_Y * WORDS_PER_ROW> ROWS = packTextRows<SIZE_X, SIZE_Y>(Cells);
+
+    static constexpr bool isAlive(std::uint32_t x, std::uint32_t y)
+    {
+        return (ROWS[y * WORDS_PER_ROW + x / CELLS_PER_WORD] >> (x % CELLS_PER_WORD)) & 1;
+    }
+
+    std::uint32_t getSizeX() const final
+    {
+        return SIZE_X;
+    }
+    std::uint32_t getSizeY() const final
+    {
+        return SIZE_Y;
+    }
+    bool getCell(std::uint32_t x, std::uint32_t y) const final
+    {
+        return isAlive(x, y);
+    }
+    void getRow(std::uint32_t y, std::uint64_t* words) const final
+    {
+        std::copy(ROWS.begin() + y * WORDS_PER_ROW, ROWS.begin() + (y + 1) * WORDS_PER_ROW, words);
+    }
+};
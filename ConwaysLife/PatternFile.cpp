@@ -0,0 +1,419 @@
+#include "PatternFile.hpp"
+
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::uint64_t MAX_SIZE = std::numeric_limits<std::uint32_t>::max();
+
+    // Returns the line starting at begin, without its line break, and moves begin past it
+    std::string nextLine(const char*& begin, const char* end)
+    {
+        const char* lineEnd = std::find(begin, end, '\n');
+        std::string line(begin, lineEnd);
+        begin = lineEnd == end ? end : lineEnd + 1;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        return line;
+    }
+
+    std::string trim(const std::string& text)
+    {
+        std::size_t first = text.find_first_not_of(" \t");
+        std::size_t last = text.find_last_not_of(" \t");
+        return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+    }
+
+    std::uint64_t parseSize(const std::string& text)
+    {
+        std::string digits = trim(text);
+        if (digits.empty() || digits.size() > 10 || !std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+        {
+            throw std::runtime_error("Bad number in pattern file: " + text);
+        }
+        std::uint64_t value = std::stoull(digits);
+        if (value > MAX_SIZE)
+        {
+            throw std::runtime_error("Pattern too large: " + text);
+        }
+        return value;
+    }
+
+    // A board for the pattern, failing as a bad file does when memory cannot hold it
+    LifeBoard makeBoard(std::uint64_t sizeX, std::uint64_t sizeY)
+    {
+        try
+        {
+            return LifeBoard(static_cast<std::uint32_t>(sizeX), static_cast<std::uint32_t>(sizeY));
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+        catch (const std::length_error&)
+        {
+        }
+        throw std::runtime_error("Pattern too large: " + std::to_string(sizeX) + " by " + std::to_string(sizeY) + " cells");
+    }
+
+    // A Macrocell node. Level 3 nodes are 8 by 8 leaves, bit y * 8 + x of
+    // leaf being cell (x, y); higher levels have four children. The bounding
+    // box of the live cells is relative to the node's corner.
+    struct MacroNode
+    {
+        std::uint32_t level;
+        std::uint32_t children[4];
+        std::uint64_t leaf;
+        std::int64_t minX;
+        std::int64_t minY;
+        std::int64_t maxX;
+        std::int64_t maxY;
+
+        bool isEmpty() const { return minX > maxX; }
+    };
+
+    // ORs the live cells under node into board, with the node's corner at (x, y)
+    void blitMacroNode(const std::vector<MacroNode>& nodes, std::uint32_t index, std::int64_t x, std::int64_t y, LifeBoard& board)
+    {
+        const MacroNode& node = nodes[index];
+        if (node.isEmpty())
+        {
+            return;
+        }
+
+        if (node.level == 3)
+        {
+            for (std::int64_t row = node.minY; row <= node.maxY; ++row)
+            {
+                // Live cells lie inside the board, so shifting them in from a negative x loses none
+                std::uint64_t bits = (node.leaf >> (row * 8)) & 0xFF;
+                std::int64_t left = x;
+                if (left < 0)
+                {
+                    bits >>= -left;
+                    left = 0;
+                }
+
+                std::uint64_t* cells = board.getRow(y + row);
+                std::size_t word = static_cast<std::size_t>(left) / CELLS_PER_WORD;
+                std::size_t bit = static_cast<std::size_t>(left) % CELLS_PER_WORD;
+                cells[word] |= bits << bit;
+                if (bit > CELLS_PER_WORD - 8)
+                {
+                    cells[word + 1] |= bits >> (CELLS_PER_WORD - bit);
+                }
+            }
+            return;
+        }
+
+        std::int64_t half = std::int64_t(1) << (node.level - 1);
+        blitMacroNode(nodes, node.children[0], x, y, board);
+        blitMacroNode(nodes, node.children[1], x + half, y, board);
+        blitMacroNode(nodes, node.children[2], x, y + half, board);
+        blitMacroNode(nodes, node.children[3], x + half, y + half, board);
+    }
+}
+
+PatternFile::PatternFile(const std::string& path) :
+    cells(0, 0)
+{
+    MappedFile file(path);
+
+    static const std::string MACROCELL_HEADER = "[M2]";
+    if (file.size() >= MACROCELL_HEADER.size() && std::equal(MACROCELL_HEADER.begin(), MACROCELL_HEADER.end(), file.begin()))
+    {
+        parseMacrocell(file.begin(), file.end());
+    }
+    else
+    {
+        parseRle(file.begin(), file.end());
+    }
+}
+
+std::uint32_t PatternFile::getSizeX() const
+{
+    return cells.getSizeX();
+}
+
+std::uint32_t PatternFile::getSizeY() const
+{
+    return cells.getSizeY();
+}
+
+bool PatternFile::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    return cells.getCell(x, y);
+}
+
+void PatternFile::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    const std::uint64_t* row = cells.getRow(y);
+    std::size_t wordCount = cells.getWordsPerRow();
+    std::copy(row, row + wordCount, words);
+    if (wordCount)
+    {
+        words[wordCount - 1] &= lastWordMask(cells.getSizeX());
+    }
+}
+
+const std::string& PatternFile::getRuleNotation() const
+{
+    return ruleNotation;
+}
+
+const LifeBoard& PatternFile::getBoard() const
+{
+    return cells;
+}
+
+void PatternFile::setRuleNotation(const std::string& notation)
+{
+    ruleNotation = trim(notation.substr(0, notation.find(':')));
+}
+
+void PatternFile::parseRle(const char* begin, const char* end)
+{
+    // Comment lines, then a header such as "x = 3, y = 3, rule = B3/S23"
+    const char* at = begin;
+    std::uint64_t sizeX = 0;
+    std::uint64_t sizeY = 0;
+    bool sawHeader = false;
+    while (at < end && !sawHeader)
+    {
+        std::string line = nextLine(at, end);
+        if (trim(line).empty())
+        {
+            continue;
+        }
+        if (line[0] == '#')
+        {
+            if (line.size() > 1 && line[1] == 'r')
+            {
+                setRuleNotation(line.substr(2));
+            }
+            continue;
+        }
+
+        // The rule comes last and may itself hold commas, as in "B3/S23:T100,100"
+        std::size_t rule = line.find("rule");
+        if (rule != std::string::npos)
+        {
+            std::size_t equals = line.find('=', rule);
+            if (equals == std::string::npos)
+            {
+                throw std::runtime_error("Bad RLE header: " + line);
+            }
+            setRuleNotation(line.substr(equals + 1));
+        }
+
+        std::stringstream fields(line.substr(0, rule));
+        std::string field;
+        while (std::getline(fields, field, ','))
+        {
+            if (trim(field).empty())
+            {
+                continue;
+            }
+
+            std::size_t equals = field.find('=');
+            if (equals == std::string::npos)
+            {
+                throw std::runtime_error("Bad RLE header: " + line);
+            }
+
+            std::string key = trim(field.substr(0, equals));
+            if (key == "x")
+            {
+                sizeX = parseSize(field.substr(equals + 1));
+            }
+            else if (key == "y")
+            {
+                sizeY = parseSize(field.substr(equals + 1));
+            }
+        }
+        sawHeader = true;
+    }
+
+    if (!sawHeader)
+    {
+        throw std::runtime_error("RLE file has no header line");
+    }
+    cells = makeBoard(sizeX, sizeY);
+
+    // Runs such as "3o2b$" until "!". Cells past the declared size are dropped.
+    std::uint64_t count = 0;
+    std::uint64_t x = 0;
+    std::uint64_t y = 0;
+    for (; at < end; ++at)
+    {
+        char c = *at;
+        if (c >= '0' && c <= '9')
+        {
+            count = count * 10 + static_cast<std::uint64_t>(c - '0');
+            if (count > MAX_SIZE)
+            {
+                throw std::runtime_error("RLE run too long");
+            }
+            continue;
+        }
+
+        std::uint64_t run = count ? count : 1;
+        if (c == 'b' || c == '.')
+        {
+            x += run;
+        }
+        else if (c == 'o' || (c >= 'A' && c <= 'Z') || (c >= 'p' && c <= 'y'))
+        {
+            // Multi-state files write some states as a prefix in p to y and a capital
+            if (c >= 'p' && at + 1 < end && at[1] >= 'A' && at[1] <= 'Z')
+            {
+                ++at;
+            }
+            if (y < sizeY && x < sizeX)
+            {
+                cells.setSpan(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y), static_cast<std::uint32_t>(std::min(run, sizeX - x)), true);
+            }
+            x += run;
+        }
+        else if (c == '$')
+        {
+            y += run;
+            x = 0;
+        }
+        else if (c == '!')
+        {
+            break;
+        }
+        else if (c == '#')
+        {
+            nextLine(at, end);
+            --at;
+        }
+        else if (!std::isspace(static_cast<unsigned char>(c)))
+        {
+            throw std::runtime_error(std::string("Unexpected character in RLE: ") + c);
+        }
+        else
+        {
+            // Line breaks may fall anywhere, even inside a run count
+            continue;
+        }
+        count = 0;
+    }
+}
+
+void PatternFile::parseMacrocell(const char* begin, const char* end)
+{
+    // Node 0 stands for an empty square of any level
+    std::vector<MacroNode> nodes;
+    const std::int64_t NONE_MIN = std::numeric_limits<std::int64_t>::max();
+    const std::int64_t NONE_MAX = std::numeric_limits<std::int64_t>::min();
+    nodes.push_back({ 0, { 0, 0, 0, 0 }, 0, NONE_MIN, NONE_MIN, NONE_MAX, NONE_MAX });
+
+    const char* at = begin;
+    nextLine(at, end);
+    while (at < end)
+    {
+        std::string line = nextLine(at, end);
+        if (trim(line).empty())
+        {
+            continue;
+        }
+        if (line[0] == '#')
+        {
+            if (line.size() > 1 && line[1] == 'R')
+            {
+                setRuleNotation(line.substr(2));
+            }
+            continue;
+        }
+
+        MacroNode node = { 3, { 0, 0, 0, 0 }, 0, NONE_MIN, NONE_MIN, NONE_MAX, NONE_MAX };
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$')
+        {
+            // An 8 by 8 leaf, one row per '$', trailing dead cells left out
+            std::int64_t x = 0;
+            std::int64_t y = 0;
+            for (char c : line)
+            {
+                if (c == '$')
+                {
+                    ++y;
+                    x = 0;
+                    continue;
+                }
+                if ((c != '.' && c != '*') || x >= 8 || y >= 8)
+                {
+                    throw std::runtime_error("Bad Macrocell leaf: " + line);
+                }
+                if (c == '*')
+                {
+                    node.leaf |= std::uint64_t(1) << (y * 8 + x);
+                    node.minX = std::min(node.minX, x);
+                    node.minY = std::min(node.minY, y);
+                    node.maxX = std::max(node.maxX, x);
+                    node.maxY = std::max(node.maxY, y);
+                }
+                ++x;
+            }
+        }
+        else
+        {
+            std::stringstream fields(line);
+            if (!(fields >> node.level >> node.children[0] >> node.children[1] >> node.children[2] >> node.children[3]))
+            {
+                throw std::runtime_error("Bad Macrocell node: " + line);
+            }
+            if (node.level < 4 || node.level > 62)
+            {
+                throw std::runtime_error("Unsupported Macrocell node level (only two-state patterns are read): " + line);
+            }
+
+            std::int64_t half = std::int64_t(1) << (node.level - 1);
+            for (std::size_t quadrant = 0; quadrant < 4; ++quadrant)
+            {
+                std::uint32_t index = node.children[quadrant];
+                if (index >= nodes.size() || (index && nodes[index].level != node.level - 1))
+                {
+                    throw std::runtime_error("Bad Macrocell child in node: " + line);
+                }
+
+                const MacroNode& child = nodes[index];
+                if (!child.isEmpty())
+                {
+                    std::int64_t offsetX = (quadrant % 2) * half;
+                    std::int64_t offsetY = (quadrant / 2) * half;
+                    node.minX = std::min(node.minX, child.minX + offsetX);
+                    node.minY = std::min(node.minY, child.minY + offsetY);
+                    node.maxX = std::max(node.maxX, child.maxX + offsetX);
+                    node.maxY = std::max(node.maxY, child.maxY + offsetY);
+                }
+            }
+        }
+        nodes.push_back(node);
+    }
+
+    // The last node is the root. The pattern is the bounding box of its live cells.
+    const MacroNode& root = nodes.back();
+    if (root.isEmpty())
+    {
+        return;
+    }
+    if (std::uint64_t(root.maxX - root.minX) >= MAX_SIZE || std::uint64_t(root.maxY - root.minY) >= MAX_SIZE)
+    {
+        throw std::runtime_error("Macrocell pattern too large to lay out on a board");
+    }
+
+    cells = makeBoard(std::uint64_t(root.maxX - root.minX) + 1, std::uint64_t(root.maxY - root.minY) + 1);
+    blitMacroNode(nodes, static_cast<std::uint32_t>(nodes.size() - 1), -root.minX, -root.minY, cells);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "LifeBoard.hpp"
+#include "Pattern.hpp"
+
+#include <string>
+
+// A pattern read from a run length encoded (.rle) or Macrocell (.mc) file.
+// The file is memory-mapped and decoded straight into a packed board: each
+// run of live cells costs a few word writes, and nothing goes cell by cell.
+// Only two-state patterns are read; any other live state counts as alive.
+class PatternFile : public Pattern
+{
+  public:
+    // Throws std::runtime_error if the file cannot be read, is neither
+    // valid RLE nor valid Macrocell, or describes a pattern too large for memory
+    explicit PatternFile(const std::string& path);
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+
+    // The rule the file names, without any bounded grid suffix, or empty if it names none
+    const std::string& getRuleNotation() const;
+    const LifeBoard& getBoard() const;
+
+  private:
+    LifeBoard cells;
+    std::string ruleNotation;
+
+    void parseRle(const char* begin, const char* end);
+    void parseMacrocell(const char* begin, const char* end);
+    void setRuleNotation(const std::string& notation);
+};
@@ -0,0 +1,37 @@
+#include "PatternSoup.hpp"
+
+#include "LifeKernel.hpp"
+
+PatternSoup::PatternSoup(std::uint32_t sizeX, std::uint32_t sizeY, std::uint64_t seed, double density) :
+    sizeX(sizeX),
+    sizeY(sizeY),
+    generator(seed, density)
+{
+}
+
+std::uint32_t PatternSoup::getSizeX() const
+{
+    return sizeX;
+}
+
+std::uint32_t PatternSoup::getSizeY() const
+{
+    return sizeY;
+}
+
+bool PatternSoup::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    std::uint64_t word;
+    generator.fill(&word, static_cast<std::uint64_t>(y) * wordsForCells(sizeX) + x / CELLS_PER_WORD, 1);
+    return (word >> (x % CELLS_PER_WORD)) & 1;
+}
+
+void PatternSoup::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    generator.fillRow(sizeX, y, words);
+}
+
+const SoupGenerator& PatternSoup::getGenerator() const
+{
+    return generator;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Pattern.hpp"
+#include "SoupGenerator.hpp"
+
+#include <cstdint>
+
+// A random soup, drawn row by row from a SoupGenerator as it is read, so even
+// a soup the size of a large board takes no memory. The same seed and
+// density always give the same soup.
+class PatternSoup : public Pattern
+{
+  public:
+    PatternSoup(std::uint32_t sizeX, std::uint32_t sizeY, std::uint64_t seed, double density = 0.5);
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+
+    const SoupGenerator& getGenerator() const;
+
+  private:
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    SoupGenerator generator;
+};
@@ -1,9 +1,12 @@
 #pragma once
 
-#include "LifeSimulator.hpp"
+#include "Pattern.hpp"
 
 class Renderer
 {
   public:
-    virtual void render(const LifeSimulator& simulation) = 0;
+    virtual ~Renderer() = default;
+
+    // Draws the cells of an engine or of a captured frame
+    virtual void render(const Pattern& cells) = 0;
 };
@@ -1,25 +1,124 @@
 #include "RendererConsole.hpp"
 
-#include "rlutil.h"
+#include "TerminalOutput.hpp"
 
-void RendererConsole::render(const LifeSimulator& simulation)
+#include <cstdio>
+
+namespace
+{
+    const char LIVE_CELL = 'X';
+    const char DEAD_CELL = ' ';
+    // Characters the readout covers at the start of the top row
+    const std::size_t READOUT_WIDTH = 30;
+    // Rewriting a few unchanged cells is cheaper than a cursor move
+    const std::uint32_t MAX_REWRITTEN_GAP = 6;
+}
+
+RendererConsole::RendererConsole()
+{
+    enableTerminalEscapes();
+}
+
+RendererConsole::~RendererConsole()
+{
+    // Leave the cursor visible, below the board
+    if (started)
+    {
+        writeTerminal("\x1b[" + std::to_string(sizeY + 1) + ";1H\x1b[?25h");
+    }
+}
+
+void RendererConsole::render(const Pattern& cells)
 {
-    rlutil::cls();
-    rlutil::hidecursor();
+    auto now = std::chrono::steady_clock::now();
+    frame.clear();
+
+    // First frame, or the board changed size: start from a blank screen
+    if (cells.getSizeX() != sizeX || cells.getSizeY() != sizeY || !started)
+    {
+        sizeX = cells.getSizeX();
+        sizeY = cells.getSizeY();
+        started = true;
+        screen.assign(static_cast<std::size_t>(sizeX) * sizeY, DEAD_CELL);
+        frame += "\x1b[?25l\x1b[2J";
+        cursorKnown = false;
+        lastFrame = now;
+    }
 
-    std::uint8_t sizeX = simulation.getSizeX();
-    std::uint8_t sizeY = simulation.getSizeY();
-    for (std::uint8_t x = 0; x < sizeX; ++x)
+    std::size_t readoutWidth = (sizeX >= READOUT_WIDTH && sizeY) ? READOUT_WIDTH : 0;
+    for (std::uint32_t y = 0; y < sizeY; ++y)
     {
-        for (std::uint8_t y = 0; y < sizeY; ++y)
+        std::uint32_t firstX = y == 0 ? static_cast<std::uint32_t>(readoutWidth) : 0;
+        char* shown = screen.data() + static_cast<std::size_t>(y) * sizeX;
+        for (std::uint32_t x = firstX; x < sizeX; ++x)
         {
-            if (simulation.getCell(x, y))
+            char cell = cells.getCell(x, y) ? LIVE_CELL : DEAD_CELL;
+            if (cell != shown[x])
             {
-                rlutil::locate(x + 1, y + 1);
-                rlutil::setChar('X');
+                moveCursor(x, y);
+                frame += cell;
+                shown[x] = cell;
+                ++cursorX;
+                // Past the last column the terminal may or may not have wrapped
+                cursorKnown = cursorX < sizeX;
             }
         }
     }
 
-    rlutil::showcursor();
-}
\ No newline at end of file
+    double seconds = std::chrono::duration<double>(now - lastFrame).count();
+    if (seconds > 0.0)
+    {
+        framesPerSecond = framesPerSecond > 0.0 ? 0.9 * framesPerSecond + 0.1 / seconds : 1.0 / seconds;
+    }
+    lastFrame = now;
+    appendReadout(readoutWidth);
+
+    writeTerminal(frame);
+}
+
+void RendererConsole::moveCursor(std::uint32_t x, std::uint32_t y)
+{
+    if (cursorKnown && cursorY == y && cursorX <= x)
+    {
+        if (cursorX == x)
+        {
+            return;
+        }
+
+        // The cells in between are unchanged, so writing them again is harmless
+        if (x - cursorX <= MAX_REWRITTEN_GAP)
+        {
+            frame.append(screen.data() + static_cast<std::size_t>(y) * sizeX + cursorX, x - cursorX);
+            cursorX = x;
+            return;
+        }
+    }
+
+    frame += "\x1b[" + std::to_string(y + 1) + ';' + std::to_string(x + 1) + 'H';
+    cursorX = x;
+    cursorY = y;
+    cursorKnown = true;
+}
+
+void RendererConsole::appendReadout(std::size_t width)
+{
+    if (!width)
+    {
+        return;
+    }
+
+    // The byte count covers the readout itself, which is always the same length
+    const char* MOVE_HOME = "\x1b[1;1H";
+    std::size_t bytes = frame.size() + std::char_traits<char>::length(MOVE_HOME) + width;
+
+    char readout[READOUT_WIDTH + 1];
+    std::snprintf(readout, sizeof(readout), "%7.1f fps %9zu B/frame", framesPerSecond, bytes);
+    std::string text(readout);
+    text.resize(width, ' ');
+
+    frame += MOVE_HOME;
+    frame += text;
+    cursorX = static_cast<std::uint32_t>(width);
+    cursorY = 0;
+    cursorKnown = cursorX < sizeX;
+}
@@ -2,8 +2,42 @@
 
 #include "Renderer.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Draws the cells as text through ANSI escape sequences. It remembers what
+// the terminal shows, so each frame only redraws the cells that changed, and
+// the whole frame goes out in a single write. The top-left corner shows the
+// frame rate and the bytes each frame took.
 class RendererConsole : public Renderer
 {
   public:
-    void render(const LifeSimulator& simulation);
-};
\ No newline at end of file
+    RendererConsole();
+    ~RendererConsole() override;
+
+    RendererConsole(const RendererConsole&) = delete;
+    RendererConsole& operator=(const RendererConsole&) = delete;
+
+    void render(const Pattern& cells) override;
+
+  private:
+    std::uint32_t sizeX = 0;
+    std::uint32_t sizeY = 0;
+    bool started = false;
+    // What the terminal shows, one character per cell
+    std::vector<char> screen;
+    // Escape sequences of the frame being built, reused between frames
+    std::string frame;
+    // Where the terminal's cursor is, if known
+    std::uint32_t cursorX = 0;
+    std::uint32_t cursorY = 0;
+    bool cursorKnown = false;
+
+    std::chrono::steady_clock::time_point lastFrame;
+    double framesPerSecond = 0.0;
+
+    void moveCursor(std::uint32_t x, std::uint32_t y);
+    void appendReadout(std::size_t width);
+};
@@ -0,0 +1,223 @@
+#include "RendererDownsampled.hpp"
+
+#include "LifeKernel.hpp"
+#include "TerminalOutput.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // No glyph has this code, so a screen full of it redraws everything
+    const std::uint32_t UNDRAWN = ~std::uint32_t(0);
+    // The 256-color palette's gray ramp; 0 stands for black
+    const std::uint32_t GRAY_FIRST = 232;
+    const std::uint32_t GRAY_LEVELS = 24;
+
+    // Bit of a Braille character for the dot at (x, y) of its 2 by 4 grid
+    const std::uint32_t BRAILLE_DOTS[4][2] = { { 0x01, 0x08 }, { 0x02, 0x10 }, { 0x04, 0x20 }, { 0x40, 0x80 } };
+    const std::uint32_t BRAILLE_BASE = 0x2800;
+    const char* UPPER_HALF_BLOCK = "\xe2\x96\x80";
+    const char* LOWER_HALF_BLOCK = "\xe2\x96\x84";
+
+    void appendUtf8(std::string& out, std::uint32_t codePoint)
+    {
+        // Three bytes cover everything drawn here
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+
+    // 0 for an empty block, else a palette gray that brightens as it fills
+    std::uint32_t shade(std::uint64_t count, std::uint64_t area)
+    {
+        if (!count || !area)
+        {
+            return 0;
+        }
+        return GRAY_FIRST + static_cast<std::uint32_t>((count * (GRAY_LEVELS - 1) + area - 1) / area);
+    }
+}
+
+RendererDownsampled::RendererDownsampled(std::uint32_t columns, std::uint32_t rows, Glyphs glyphs) :
+    columns(columns),
+    rows(rows),
+    glyphs(glyphs),
+    dotsPerColumn(glyphs == Glyphs::Braille ? 2 : 1),
+    dotsPerRow(glyphs == Glyphs::Braille ? 4 : 2)
+{
+    enableTerminalEscapes();
+    dotCounts.resize(static_cast<std::size_t>(columns) * dotsPerColumn * dotsPerRow);
+    screen.assign(static_cast<std::size_t>(columns) * rows, UNDRAWN);
+}
+
+RendererDownsampled::~RendererDownsampled()
+{
+    // Leave default colors and a visible cursor, below the picture
+    if (started)
+    {
+        writeTerminal("\x1b[0m\x1b[" + std::to_string(rows + 1) + ";1H\x1b[?25h");
+    }
+}
+
+void RendererDownsampled::setViewport(std::uint32_t x, std::uint32_t y, std::uint32_t zoom)
+{
+    viewX = x;
+    viewY = y;
+    this->zoom = zoom;
+}
+
+void RendererDownsampled::render(const Pattern& cells)
+{
+    frame.clear();
+    if (!started)
+    {
+        frame += "\x1b[?25l\x1b[0m\x1b[2J";
+        started = true;
+        shownColors = 0;
+        cursorKnown = false;
+    }
+
+    std::uint32_t sizeX = cells.getSizeX();
+    std::uint32_t sizeY = cells.getSizeY();
+    std::uint32_t dotsX = columns * dotsPerColumn;
+    std::uint32_t dotsY = rows * dotsPerRow;
+    std::uint32_t cellsPerDot = zoom;
+    if (!cellsPerDot)
+    {
+        // Fit the board, rounding up so nothing hangs off the edge
+        cellsPerDot = std::max<std::uint32_t>({ 1, (sizeX + dotsX - 1) / std::max<std::uint32_t>(dotsX, 1), (sizeY + dotsY - 1) / std::max<std::uint32_t>(dotsY, 1) });
+    }
+    rowWords.resize(wordsForCells(sizeX));
+    blockWords.resize(rowWords.size());
+    slicePieces(sizeX, cellsPerDot);
+    std::size_t firstWord = pieces.empty() ? 0 : pieces.front().word;
+    std::size_t endWord = pieces.empty() ? 0 : pieces.back().word + 1;
+
+    for (std::uint32_t row = 0; row < rows; ++row)
+    {
+        std::fill(dotCounts.begin(), dotCounts.end(), 0);
+        for (std::uint32_t dotY = 0; dotY < dotsPerRow; ++dotY)
+        {
+            std::uint32_t* counts = dotCounts.data() + static_cast<std::size_t>(dotY) * dotsX;
+            std::uint64_t firstY = viewY + static_cast<std::uint64_t>(row * dotsPerRow + dotY) * cellsPerDot;
+            std::uint64_t endY = std::min<std::uint64_t>(firstY + cellsPerDot, sizeY);
+            if (glyphs == Glyphs::Braille)
+            {
+                // Braille dots only show whether a block has any live cell,
+                // so OR its rows together and count once
+                std::fill(blockWords.begin(), blockWords.end(), 0);
+                for (std::uint64_t y = firstY; y < endY; ++y)
+                {
+                    cells.getRow(static_cast<std::uint32_t>(y), rowWords.data());
+                    for (std::size_t word = firstWord; word < endWord; ++word)
+                    {
+                        blockWords[word] |= rowWords[word];
+                    }
+                }
+                addPieceCounts(blockWords.data(), counts);
+                continue;
+            }
+
+            for (std::uint64_t y = firstY; y < endY; ++y)
+            {
+                cells.getRow(static_cast<std::uint32_t>(y), rowWords.data());
+                addPieceCounts(rowWords.data(), counts);
+            }
+        }
+
+        std::uint32_t* shown = screen.data() + static_cast<std::size_t>(row) * columns;
+        for (std::uint32_t column = 0; column < columns; ++column)
+        {
+            std::uint32_t code = glyphCode(column, static_cast<std::uint64_t>(cellsPerDot) * cellsPerDot);
+            if (code == shown[column])
+            {
+                continue;
+            }
+
+            if (!cursorKnown || cursorY != row || cursorX != column)
+            {
+                frame += "\x1b[" + std::to_string(row + 1) + ';' + std::to_string(column + 1) + 'H';
+            }
+            appendGlyph(code);
+            shown[column] = code;
+            cursorX = column + 1;
+            cursorY = row;
+            // Past the last column the terminal may or may not have wrapped
+            cursorKnown = cursorX < columns;
+        }
+    }
+
+    writeTerminal(frame);
+}
+
+void RendererDownsampled::slicePieces(std::uint32_t sizeX, std::uint32_t cellsPerDot)
+{
+    pieces.clear();
+    std::uint32_t dotsX = columns * dotsPerColumn;
+    for (std::uint32_t dot = 0; dot < dotsX; ++dot)
+    {
+        std::uint64_t bit = viewX + static_cast<std::uint64_t>(dot) * cellsPerDot;
+        std::uint64_t end = std::min<std::uint64_t>(bit + cellsPerDot, sizeX);
+        while (bit < end)
+        {
+            std::uint64_t offset = bit % CELLS_PER_WORD;
+            std::uint64_t length = std::min<std::uint64_t>(CELLS_PER_WORD - offset, end - bit);
+            std::uint64_t mask = (length == CELLS_PER_WORD ? ~std::uint64_t(0) : (std::uint64_t(1) << length) - 1) << offset;
+            pieces.push_back({ static_cast<std::size_t>(bit / CELLS_PER_WORD), dot, mask });
+            bit += length;
+        }
+    }
+}
+
+void RendererDownsampled::addPieceCounts(const std::uint64_t* words, std::uint32_t* counts) const
+{
+    for (const Piece& piece : pieces)
+    {
+        counts[piece.dot] += countSetBits(words[piece.word] & piece.mask);
+    }
+}
+
+std::uint32_t RendererDownsampled::glyphCode(std::uint32_t column, std::uint64_t dotArea) const
+{
+    std::uint32_t dotsX = columns * dotsPerColumn;
+    if (glyphs == Glyphs::Braille)
+    {
+        std::uint32_t bits = 0;
+        for (std::uint32_t dotY = 0; dotY < 4; ++dotY)
+        {
+            for (std::uint32_t dotX = 0; dotX < 2; ++dotX)
+            {
+                bits |= dotCounts[dotY * dotsX + column * 2 + dotX] ? BRAILLE_DOTS[dotY][dotX] : 0;
+            }
+        }
+        return bits;
+    }
+
+    // The shades of the upper and lower dot
+    return shade(dotCounts[column], dotArea) << 8 | shade(dotCounts[dotsX + column], dotArea);
+}
+
+void RendererDownsampled::appendGlyph(std::uint32_t code)
+{
+    if (glyphs == Glyphs::Braille)
+    {
+        appendUtf8(frame, BRAILLE_BASE + code);
+        return;
+    }
+
+    // The upper half block in the top shade on a background of the bottom
+    // one. An empty top is left to the default background rather than drawn
+    // in the default foreground, which is light on most terminals, so it
+    // takes the lower half block in the bottom shade instead.
+    std::uint32_t top = code >> 8;
+    std::uint32_t bottom = code & 0xFF;
+    if (code != shownColors)
+    {
+        std::uint32_t foreground = top ? top : bottom;
+        std::uint32_t background = top ? bottom : 0;
+        frame += foreground ? "\x1b[38;5;" + std::to_string(foreground) + 'm' : std::string("\x1b[39m");
+        frame += background ? "\x1b[48;5;" + std::to_string(background) + 'm' : std::string("\x1b[49m");
+        shownColors = code;
+    }
+    frame += top ? UPPER_HALF_BLOCK : bottom ? LOWER_HALF_BLOCK : " ";
+}
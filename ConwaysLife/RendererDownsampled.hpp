@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Draws a board of any size in a terminal of columns by rows characters.
+// Each character shows a few dots, and each dot a zoom by zoom block of
+// cells, counted with popcounts over masked words of the packed rows:
+// - Braille: 2 by 4 dots per character, a dot lit if its block holds any
+//   live cell
+// - HalfBlock: 1 by 2 dots per character, each shaded gray by how full its
+//   block is
+// Like RendererConsole it redraws only the characters that changed, with one
+// write per frame.
+class RendererDownsampled : public Renderer
+{
+  public:
+    enum class Glyphs
+    {
+        Braille,
+        HalfBlock
+    };
+
+    RendererDownsampled(std::uint32_t columns, std::uint32_t rows, Glyphs glyphs);
+    ~RendererDownsampled() override;
+
+    RendererDownsampled(const RendererDownsampled&) = delete;
+    RendererDownsampled& operator=(const RendererDownsampled&) = delete;
+
+    // Shows the board from cell (x, y) on, zoom cells to a dot each way.
+    // A zoom of 0, the default, fits the whole board in the terminal.
+    void setViewport(std::uint32_t x, std::uint32_t y, std::uint32_t zoom);
+
+    void render(const Pattern& cells) override;
+
+  private:
+    std::uint32_t columns;
+    std::uint32_t rows;
+    Glyphs glyphs;
+    std::uint32_t dotsPerColumn;
+    std::uint32_t dotsPerRow;
+
+    std::uint32_t viewX = 0;
+    std::uint32_t viewY = 0;
+    std::uint32_t zoom = 0;
+
+    // The viewport's columns cut at dot and word edges, so every piece lies
+    // under one dot and in one word of a row
+    struct Piece
+    {
+        std::size_t word;
+        std::uint32_t dot;
+        std::uint64_t mask;
+    };
+    std::vector<Piece> pieces;
+    // Live cells under each dot of one row of characters, one packed board
+    // row, and the rows of one block ORed together
+    std::vector<std::uint32_t> dotCounts;
+    std::vector<std::uint64_t> rowWords;
+    std::vector<std::uint64_t> blockWords;
+    // Glyph code of each character on screen; the frame being built
+    std::vector<std::uint32_t> screen;
+    std::string frame;
+    std::uint32_t cursorX = 0;
+    std::uint32_t cursorY = 0;
+    bool cursorKnown = false;
+    std::uint32_t shownColors = 0;
+    bool started = false;
+
+    void slicePieces(std::uint32_t sizeX, std::uint32_t cellsPerDot);
+    // Adds the live cells of each piece of a packed row to its dot's count
+    void addPieceCounts(const std::uint64_t* words, std::uint32_t* counts) const;
+    std::uint32_t glyphCode(std::uint32_t column, std::uint64_t dotArea) const;
+    void appendGlyph(std::uint32_t code);
+};
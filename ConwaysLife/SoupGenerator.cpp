@@ -0,0 +1,98 @@
+#include "SoupGenerator.hpp"
+
+#include "LifeKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const std::uint32_t DENSITY_BITS = 16;
+    const std::uint32_t DENSITY_ONE = 1 << DENSITY_BITS;
+    // Words drawn a pass at a time, so every pass over them stays in cache
+    const std::size_t BLOCK_WORDS = 512;
+
+    // SplitMix64's output function: a bijection that scatters counters
+    // a golden-ratio step apart into independent-looking words
+    inline std::uint64_t mix(std::uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    inline std::uint64_t draw(std::uint64_t key, std::uint64_t counter)
+    {
+        return mix(key + counter * 0x9E3779B97F4A7C15ull);
+    }
+}
+
+SoupGenerator::SoupGenerator(std::uint64_t seed, double density) :
+    seed(seed),
+    // Hashed, so that nearby seeds give unrelated streams
+    key(mix(seed)),
+    threshold(static_cast<std::uint32_t>(std::lround(std::min(std::max(density, 0.0), 1.0) * DENSITY_ONE)))
+{
+}
+
+std::uint64_t SoupGenerator::getSeed() const
+{
+    return seed;
+}
+
+double SoupGenerator::getDensity() const
+{
+    return static_cast<double>(threshold) / DENSITY_ONE;
+}
+
+void SoupGenerator::fill(std::uint64_t* words, std::uint64_t first, std::size_t count) const
+{
+    if (threshold == 0 || threshold == DENSITY_ONE)
+    {
+        std::fill(words, words + count, threshold ? ~std::uint64_t(0) : 0);
+        return;
+    }
+
+    // Bits alive with chance 0.b1b2...b16 in binary, built up from the
+    // lowest set bit of the density: a random word is alive half the time,
+    // and ORing (ANDing) in another takes a chance p to (1 + p) / 2 (p / 2).
+    // Draw j for word i is counter i * 16 + j.
+    std::uint32_t lowest = countSetBits((threshold & (0 - threshold)) - 1);
+    for (std::size_t begin = 0; begin < count; begin += BLOCK_WORDS)
+    {
+        std::size_t end = std::min(begin + BLOCK_WORDS, count);
+        std::uint64_t counter = (first + begin) * DENSITY_BITS;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            words[i] = draw(key, counter + (i - begin) * DENSITY_BITS);
+        }
+        for (std::uint32_t bit = lowest + 1; bit < DENSITY_BITS; ++bit)
+        {
+            std::uint64_t draws = counter + bit - lowest;
+            if ((threshold >> bit) & 1)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    words[i] |= draw(key, draws + (i - begin) * DENSITY_BITS);
+                }
+            }
+            else
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    words[i] &= draw(key, draws + (i - begin) * DENSITY_BITS);
+                }
+            }
+        }
+    }
+}
+
+void SoupGenerator::fillRow(std::uint32_t sizeX, std::uint32_t y, std::uint64_t* words) const
+{
+    std::size_t wordsPerRow = wordsForCells(sizeX);
+    fill(words, static_cast<std::uint64_t>(y) * wordsPerRow, wordsPerRow);
+    if (wordsPerRow)
+    {
+        words[wordsPerRow - 1] &= lastWordMask(sizeX);
+    }
+}
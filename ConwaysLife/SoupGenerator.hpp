@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Random soups from a counter-based generator: word i of a soup's stream of
+// words is a hash of the seed and i alone, so any stretch of it can be drawn
+// on its own, on any thread and in any order, and always comes out the same.
+// A board lays its rows out in the stream one after another, row y of a
+// board sizeX wide from word y * wordsForCells(sizeX), so a soup does not
+// depend on how the board is split into tiles or threads.
+class SoupGenerator
+{
+  public:
+    // density is the chance of each cell being alive, rounded to a multiple
+    // of 1 / 65536. A density of 1/2 takes one hash per word; others take up
+    // to 16, one per bit of the density.
+    explicit SoupGenerator(std::uint64_t seed, double density = 0.5);
+
+    std::uint64_t getSeed() const;
+    double getDensity() const;
+
+    // Words [first, first + count) of the stream
+    void fill(std::uint64_t* words, std::uint64_t first, std::size_t count) const;
+    // Row y of a board sizeX wide, wordsForCells(sizeX) words with the bits past sizeX clear
+    void fillRow(std::uint32_t sizeX, std::uint32_t y, std::uint64_t* words) const;
+
+  private:
+    std::uint64_t seed;
+    std::uint64_t key;
+    // density * 65536
+    std::uint32_t threshold;
+};
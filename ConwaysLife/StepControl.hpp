@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Asks a long LifeEngine::step() to stop, from any thread or from a signal
+// handler. The engine looks at it between generations, or between jumps for
+// engines that advance by more than one at a time.
+class CancellationToken
+{
+  public:
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled.store(false, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<bool> cancelled{ false };
+};
+
+// How LifeEngine::step() reports on a long run and is stopped
+struct StepControl
+{
+    // Called with the generations done so far each time they reach a
+    // multiple of progressInterval, on the thread that called step()
+    std::function<void(std::uint64_t done)> progress;
+    std::uint64_t progressInterval = 0;
+    // Not owned; none means the run cannot be cancelled
+    const CancellationToken* cancellation = nullptr;
+
+    bool isCancelled() const { return cancellation && cancellation->isCancelled(); }
+
+    // Generations from done to the next progress report, or to the end
+    std::uint64_t getChunk(std::uint64_t done, std::uint64_t generations) const
+    {
+        if (!progress || !progressInterval)
+        {
+            return generations - done;
+        }
+        return std::min(generations - done, progressInterval - done % progressInterval);
+    }
+
+    void report(std::uint64_t done) const
+    {
+        if (progress && progressInterval && done % progressInterval == 0)
+        {
+            progress(done);
+        }
+    }
+};
@@ -0,0 +1,51 @@
+#include "TerminalOutput.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+        #define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+    #endif
+#else
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+void enableTerminalEscapes()
+{
+#if defined(_WIN32)
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(output, &mode))
+    {
+        SetConsoleMode(output, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+}
+
+void writeTerminal(const std::string& text)
+{
+#if defined(_WIN32)
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), text.data(), static_cast<DWORD>(text.size()), &written, nullptr);
+#else
+    const char* data = text.data();
+    std::size_t left = text.size();
+    while (left)
+    {
+        ssize_t written = write(STDOUT_FILENO, data, left);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+#endif
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+// Asks the terminal to follow ANSI escape sequences and to read UTF-8.
+// Only Windows consoles need asking; elsewhere it does nothing.
+void enableTerminalEscapes();
+
+// Writes text to standard output in one system call, bypassing the stream
+// buffers, unless the terminal takes less than all of it
+void writeTerminal(const std::string& text);
@@ -0,0 +1,74 @@
+#include "AllocationCounter.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternAcorn.hpp"
+#include "PatternBlinker.hpp"
+#include "PatternBlock.hpp"
+#include "PatternGlider.hpp"
+#include "PatternGosperGliderGun.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    const std::uint32_t BOARD_SIZE = 1024;
+    const std::uint64_t GENERATIONS = 100;
+
+    // The interactive program's starting patterns, blinkers across the corners
+    void insertPatterns(LifeSimulator& sim)
+    {
+        std::uint32_t sizeX = sim.getSizeX();
+        std::uint32_t sizeY = sim.getSizeY();
+
+        sim.insertPattern(PatternAcorn(), 5, 9);
+        sim.insertPattern(PatternGosperGliderGun(), sizeX / 4, sizeY / 2);
+        sim.insertPattern(PatternBlinker(), 2, 2);
+        sim.insertPattern(PatternBlinker(), 2, sizeY - 2);
+        sim.insertPattern(PatternBlinker(), sizeX - 4, 2);
+        sim.insertPattern(PatternBlinker(), sizeX - 4, sizeY - 2);
+        sim.insertPattern(PatternBlock(), sizeX - 8, sizeY - 6);
+        sim.insertPattern(PatternGlider(), 10, 10);
+    }
+}
+
+// Types aligned past what malloc guarantees go through another operator new
+TEST(AllocationCounter, CountsOverAlignedAllocations)
+{
+    struct alignas(128) Line
+    {
+        char bytes[128];
+    };
+
+    std::uint64_t before = getAllocationCount();
+    std::vector<Line> lines(3);
+    EXPECT_EQ(1, getAllocationCount() - before);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(lines.data()) % alignof(Line));
+}
+
+// Once the first generation has sized everything, stepping must not allocate
+// under any kind of rule, thread count or tile tracking
+TEST(LifeSimulator_Update, DoesNotAllocate)
+{
+    for (const char* notation : { "B3/S23", "B36/S125", "B2/S345/C4", "R5,C0,M1,S34..58,B34..45,NM" })
+    {
+        for (std::size_t threadCount : { 1, 4 })
+        {
+            for (bool sparse : { false, true })
+            {
+                SCOPED_TRACE(std::string(notation) + ", " + std::to_string(threadCount) + " thread(s), " + (sparse ? "sparse" : "dense"));
+
+                LifeSimulator sim(BOARD_SIZE, BOARD_SIZE, LifeRule::parse(notation));
+                sim.setThreadCount(threadCount);
+                sim.setSparse(sparse);
+                sim.setCycleWindow(GENERATIONS);
+                insertPatterns(sim);
+                sim.update();
+
+                std::uint64_t before = getAllocationCount();
+                sim.advance(GENERATIONS);
+                EXPECT_EQ(0, getAllocationCount() - before);
+            }
+        }
+    }
+}
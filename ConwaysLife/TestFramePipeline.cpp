@@ -0,0 +1,98 @@
+#include "FramePipeline.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternGlider.hpp"
+
+#include "gtest/gtest.h"
+#include <thread>
+
+namespace
+{
+    const std::uint32_t BOARD_SIZE = 64;
+    const std::uint64_t THREADED_FRAMES = 5000;
+
+    // Steps the board on and hands its next generation to the consumer
+    void publishNext(FramePipeline& pipeline, LifeSimulator& sim)
+    {
+        sim.update();
+        pipeline.beginWrite().capture(sim);
+        pipeline.publish();
+    }
+}
+
+TEST(FramePipeline_Acquire, TakesNewestFrameAndDropsOlder)
+{
+    FramePipeline pipeline(4);
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        publishNext(pipeline, sim);
+    }
+
+    const LifeFrame* frame = pipeline.acquire();
+    ASSERT_NE(nullptr, frame);
+    EXPECT_EQ(3, frame->getGeneration());
+    EXPECT_EQ(3, pipeline.getPublishedCount());
+    EXPECT_EQ(2, pipeline.getDroppedCount());
+}
+
+TEST(FramePipeline_BeginWrite, OverwritesOldestReadyFrameWhenNoneFree)
+{
+    FramePipeline pipeline(3);
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    LifeFrame* written[3];
+    for (LifeFrame*& slot : written)
+    {
+        sim.update();
+        slot = &pipeline.beginWrite();
+        slot->capture(sim);
+        pipeline.publish();
+    }
+    EXPECT_EQ(0, pipeline.getDroppedCount());
+
+    // Every slot holds a frame not yet read, so the first one goes
+    EXPECT_EQ(written[0], &pipeline.beginWrite());
+    EXPECT_EQ(1, pipeline.getDroppedCount());
+}
+
+TEST(FramePipeline_Close, DrainsLastFrameThenEnds)
+{
+    FramePipeline pipeline;
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    publishNext(pipeline, sim);
+    pipeline.close();
+
+    const LifeFrame* frame = pipeline.acquire();
+    ASSERT_NE(nullptr, frame);
+    EXPECT_EQ(1, frame->getGeneration());
+    EXPECT_EQ(nullptr, pipeline.acquire());
+}
+
+// Every frame is either read or dropped, and the consumer never sees an
+// older generation after a newer one
+TEST(FramePipeline_Acquire, AccountsForEveryFrameAcrossThreads)
+{
+    FramePipeline pipeline;
+    std::thread producer([&pipeline]() {
+        LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+        sim.insertPattern(PatternGlider(), 0, 0);
+        for (std::uint64_t frame = 0; frame < THREADED_FRAMES; ++frame)
+        {
+            publishNext(pipeline, sim);
+        }
+        pipeline.close();
+    });
+
+    std::uint64_t read = 0;
+    std::uint64_t lastGeneration = 0;
+    while (const LifeFrame* frame = pipeline.acquire())
+    {
+        EXPECT_GT(frame->getGeneration(), lastGeneration);
+        lastGeneration = frame->getGeneration();
+        ++read;
+    }
+    producer.join();
+
+    EXPECT_EQ(THREADED_FRAMES, lastGeneration);
+    EXPECT_EQ(THREADED_FRAMES, pipeline.getPublishedCount());
+    EXPECT_EQ(pipeline.getPublishedCount(), read + pipeline.getDroppedCount());
+}
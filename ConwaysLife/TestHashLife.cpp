@@ -0,0 +1,142 @@
+#include "HashLife.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternAcorn.hpp"
+#include "PatternBlinker.hpp"
+#include "PatternBlock.hpp"
+#include "PatternGlider.hpp"
+#include "PatternGosperGliderGun.hpp"
+#include "PatternSoup.hpp"
+#include "TestPatterns.hpp"
+
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    // Big enough that nothing these patterns send out in the generations
+    // below reaches the edge, so the torus never wraps
+    const std::uint32_t BOARD_SIZE = 1024;
+    const std::uint32_t START = 480;
+    const std::uint64_t ADVANCE_GENERATIONS = 1000;
+    const std::uint64_t UPDATE_GENERATIONS = 200;
+    // Small enough that HashLife evicts while advancing the gun and the acorn
+    const std::size_t SMALL_MEMORY_LIMIT = 1 << 17;
+    // What the limit may be overshot by: the hash table rounds up to a power
+    // of two and the array of empty nodes is not counted against it
+    const std::size_t MEMORY_LIMIT_SLACK = 1 << 12;
+
+    // Steps the pattern on both engines, by one advance() or by repeated
+    // update(), and compares every cell of the window
+    void compareWithSimulator(const Pattern& pattern, std::size_t memoryLimit, bool byUpdates, bool evicts)
+    {
+        LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+        HashLife hashLife(BOARD_SIZE, BOARD_SIZE);
+        hashLife.setMemoryLimit(memoryLimit);
+        sim.insertPattern(pattern, START, START);
+        hashLife.insertPattern(pattern, START, START);
+
+        std::uint64_t generations = byUpdates ? UPDATE_GENERATIONS : ADVANCE_GENERATIONS;
+        if (byUpdates)
+        {
+            for (std::uint64_t i = 0; i < generations; ++i)
+            {
+                hashLife.update();
+            }
+        }
+        else
+        {
+            hashLife.advance(generations);
+        }
+        sim.advance(generations);
+
+        EXPECT_EQ(generations, hashLife.getGeneration());
+        EXPECT_EQ(sim.getPopulation(), hashLife.getPopulation());
+        expectSameCells(sim, hashLife);
+
+        if (memoryLimit)
+        {
+            EXPECT_LE(hashLife.getMemoryUsage(), memoryLimit + MEMORY_LIMIT_SLACK);
+            if (evicts)
+            {
+                EXPECT_GT(hashLife.getCollectionCount(), 0u);
+            }
+        }
+    }
+
+    // Each pattern, with no memory limit and with one small enough that the
+    // gun and the acorn have to evict
+    void compareEachPattern(bool byUpdates)
+    {
+        PatternAcorn acorn;
+        PatternGosperGliderGun gun;
+        PatternGlider glider;
+        PatternBlinker blinker;
+        PatternBlock block;
+        const std::tuple<const char*, const Pattern*, bool> patterns[] = {
+            { "acorn", &acorn, true }, { "Gosper glider gun", &gun, true }, { "glider", &glider, false }, { "blinker", &blinker, false }, { "block", &block, false },
+        };
+        for (const auto& [name, pattern, evicts] : patterns)
+        {
+            for (std::size_t memoryLimit : { std::size_t(0), SMALL_MEMORY_LIMIT })
+            {
+                SCOPED_TRACE(std::string(name) + ", memory limit " + std::to_string(memoryLimit));
+                compareWithSimulator(*pattern, memoryLimit, byUpdates, evicts);
+            }
+        }
+    }
+}
+
+TEST(HashLife_Advance, MatchesSimulator)
+{
+    compareEachPattern(false);
+}
+
+TEST(HashLife_Update, MatchesSimulator)
+{
+    compareEachPattern(true);
+}
+
+TEST(HashLife_Advance, StaysWithinMemoryLimitInsideOneJump)
+{
+    // A single advance() of 2^14 generations on a soup builds far more than
+    // the limit inside one power-of-two jump
+    const std::size_t memoryLimit = 1 << 20;
+    const std::uint32_t soupSize = 128;
+    PatternSoup soup(soupSize, soupSize, 1);
+    HashLife unlimited(BOARD_SIZE, BOARD_SIZE);
+    HashLife limited(BOARD_SIZE, BOARD_SIZE);
+    limited.setMemoryLimit(memoryLimit);
+    unlimited.insertPattern(soup, (BOARD_SIZE - soupSize) / 2, (BOARD_SIZE - soupSize) / 2);
+    limited.insertPattern(soup, (BOARD_SIZE - soupSize) / 2, (BOARD_SIZE - soupSize) / 2);
+
+    unlimited.advance(1 << 14);
+    limited.advance(1 << 14);
+
+    ASSERT_GT(unlimited.getMemoryUsage(), memoryLimit);
+    EXPECT_LE(limited.getMemoryUsage(), memoryLimit + MEMORY_LIMIT_SLACK);
+    EXPECT_GT(limited.getCollectionCount(), 0u);
+    EXPECT_EQ(unlimited.getGeneration(), limited.getGeneration());
+    EXPECT_EQ(unlimited.getPopulation(), limited.getPopulation());
+    expectSameCells(unlimited, limited);
+}
+
+TEST(HashLife_Advance, ThrowsOnJumpsPastTheLargestPlane)
+{
+    PatternGlider glider;
+    HashLife hashLife(BOARD_SIZE, BOARD_SIZE);
+    hashLife.insertPattern(glider, START, START);
+
+    EXPECT_THROW(hashLife.advance(std::uint64_t(1) << 62), std::overflow_error);
+    EXPECT_EQ(hashLife.getGeneration(), 0u);
+    EXPECT_EQ(hashLife.getPopulation(), 5u);
+
+    // The largest jump a glider's plane holds still runs, carrying it far
+    // out of the window
+    hashLife.advance(std::uint64_t(1) << 59);
+    EXPECT_EQ(hashLife.getGeneration(), std::uint64_t(1) << 59);
+    EXPECT_EQ(hashLife.getPopulation(), 5u);
+    EXPECT_FALSE(hashLife.getCell(START + 1, START + 1));
+}
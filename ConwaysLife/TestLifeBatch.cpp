@@ -0,0 +1,71 @@
+#include "LifeBatch.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternSoup.hpp"
+
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // Two full groups and a partial one
+    const std::size_t BOARD_COUNT = 2 * BATCH_LANES + 3;
+    const std::uint32_t SIZE_X = 37;
+    const std::uint32_t SIZE_Y = 29;
+    const std::uint64_t GENERATIONS = 3000;
+    const std::uint64_t FIRST_SEED = 100;
+}
+
+TEST(LifeBatch_Advance, MatchesSimulatorForEachBoard)
+{
+    for (const char* notation : { "B3/S23", "B36/S23" })
+    {
+        LifeRule rule = LifeRule::parse(notation);
+        LifeBatch batch(BOARD_COUNT, SIZE_X, SIZE_Y, rule);
+        batch.setThreadCount(3);
+        for (std::size_t board = 0; board < BOARD_COUNT; ++board)
+        {
+            batch.insertPattern(board, PatternSoup(SIZE_X, SIZE_Y, FIRST_SEED + board), 0, 0);
+        }
+        batch.advance(GENERATIONS);
+
+        std::size_t settled = 0;
+        for (std::size_t board = 0; board < BOARD_COUNT; ++board)
+        {
+            SCOPED_TRACE(std::string(notation) + ", board " + std::to_string(board));
+            LifeBatch::Result result = batch.getResult(board);
+
+            // Stepped as far as its group was, the simulator watching for
+            // cycles the whole way
+            LifeSimulator sim(SIZE_X, SIZE_Y, rule);
+            sim.setCycleWindow(GENERATIONS);
+            sim.insertPattern(PatternSoup(SIZE_X, SIZE_Y, FIRST_SEED + board), 0, 0);
+            sim.advance(result.generation);
+
+            EXPECT_EQ(sim.getPopulation(), result.population);
+            for (std::uint32_t y = 0; y < SIZE_Y; ++y)
+            {
+                for (std::uint32_t x = 0; x < SIZE_X; ++x)
+                {
+                    ASSERT_EQ(sim.getCell(x, y), batch.getCell(board, x, y)) << "cell " << x << ", " << y;
+                }
+            }
+            // The batch may spot a cycle later than the simulator, never earlier
+            if (result.period)
+            {
+                EXPECT_EQ(sim.getCyclePeriod(), result.period);
+                ++settled;
+            }
+        }
+        EXPECT_LT(0, settled);
+    }
+}
+
+TEST(LifeBatch_Construct, RejectsBadArgumentsBeforeAllocating)
+{
+    // Boards this tall would take terabytes, so sizing them first would
+    // fail with std::bad_alloc instead
+    const std::uint32_t tall = 0xFFFFFFFF;
+    EXPECT_THROW(LifeBatch(BATCH_LANES, CELLS_PER_WORD + 1, tall), std::invalid_argument);
+    EXPECT_THROW(LifeBatch(BATCH_LANES, 8, tall, LifeRule::parse("B2/S345/C4")), std::invalid_argument);
+}
@@ -0,0 +1,116 @@
+#include "HashLife.hpp"
+#include "LifeSimulator.hpp"
+#include "PatternAcorn.hpp"
+#include "TestPatterns.hpp"
+#include "UnboundedLife.hpp"
+
+#include "gtest/gtest.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const std::uint32_t BOARD_SIZE = 256;
+    const std::uint32_t START = 120;
+    const std::uint64_t GENERATIONS = 1000;
+    const std::uint64_t PROGRESS_INTERVAL = 64;
+    // The report at which the progress callback cancels the run
+    const std::uint64_t CANCEL_AT = 4 * PROGRESS_INTERVAL;
+
+    using EngineFactory = std::function<std::unique_ptr<LifeEngine>()>;
+
+    template <typename Engine>
+    EngineFactory makeFactory()
+    {
+        return [] {
+            std::unique_ptr<LifeEngine> engine = std::make_unique<Engine>(BOARD_SIZE, BOARD_SIZE);
+            engine->insertPattern(PatternAcorn(), START, START);
+            return engine;
+        };
+    }
+
+    // Reports come at every multiple of the interval, and only then
+    void expectProgressReports(const EngineFactory& makeEngine)
+    {
+        std::unique_ptr<LifeEngine> engine = makeEngine();
+        std::vector<std::uint64_t> reports;
+        StepControl control;
+        control.progress = [&reports](std::uint64_t done) { reports.push_back(done); };
+        control.progressInterval = PROGRESS_INTERVAL;
+
+        EXPECT_EQ(GENERATIONS, engine->step(GENERATIONS, control));
+        EXPECT_EQ(GENERATIONS, engine->getGeneration());
+        std::vector<std::uint64_t> expected;
+        for (std::uint64_t done = PROGRESS_INTERVAL; done <= GENERATIONS; done += PROGRESS_INTERVAL)
+        {
+            expected.push_back(done);
+        }
+        EXPECT_EQ(expected, reports);
+
+        std::unique_ptr<LifeEngine> advanced = makeEngine();
+        advanced->advance(GENERATIONS);
+        expectSameCells(*advanced, *engine);
+    }
+
+    // Cancelled from a progress report, the run stops there and says how
+    // far it got, and the engine is left at that generation
+    void expectCancelStops(const EngineFactory& makeEngine)
+    {
+        std::unique_ptr<LifeEngine> engine = makeEngine();
+        CancellationToken cancellation;
+        StepControl control;
+        control.progress = [&cancellation](std::uint64_t done) {
+            if (done == CANCEL_AT)
+            {
+                cancellation.cancel();
+            }
+        };
+        control.progressInterval = PROGRESS_INTERVAL;
+        control.cancellation = &cancellation;
+
+        EXPECT_EQ(CANCEL_AT, engine->step(GENERATIONS, control));
+        EXPECT_EQ(CANCEL_AT, engine->getGeneration());
+        std::unique_ptr<LifeEngine> advanced = makeEngine();
+        advanced->advance(CANCEL_AT);
+        expectSameCells(*advanced, *engine);
+
+        // Still cancelled, the next run does nothing; reset, it carries on
+        EXPECT_EQ(0, engine->step(GENERATIONS, control));
+        EXPECT_EQ(CANCEL_AT, engine->getGeneration());
+        cancellation.reset();
+        control.progress = nullptr;
+        EXPECT_EQ(GENERATIONS, engine->step(GENERATIONS, control));
+        EXPECT_EQ(CANCEL_AT + GENERATIONS, engine->getGeneration());
+    }
+}
+
+TEST(LifeEngine_Step, ReportsProgressOnLifeSimulator)
+{
+    expectProgressReports(makeFactory<LifeSimulator>());
+}
+
+TEST(LifeEngine_Step, ReportsProgressOnHashLife)
+{
+    expectProgressReports(makeFactory<HashLife>());
+}
+
+TEST(LifeEngine_Step, ReportsProgressOnUnboundedLife)
+{
+    expectProgressReports(makeFactory<UnboundedLife>());
+}
+
+TEST(LifeEngine_Step, StopsWhenCancelledOnLifeSimulator)
+{
+    expectCancelStops(makeFactory<LifeSimulator>());
+}
+
+TEST(LifeEngine_Step, StopsWhenCancelledOnHashLife)
+{
+    expectCancelStops(makeFactory<HashLife>());
+}
+
+TEST(LifeEngine_Step, StopsWhenCancelledOnUnboundedLife)
+{
+    expectCancelStops(makeFactory<UnboundedLife>());
+}
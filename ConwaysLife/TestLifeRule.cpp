@@ -0,0 +1,111 @@
+#include "LifeRule.hpp"
+
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // The notation written back, and a rule parsed from that equal to the first
+    void expectRoundTrip(const std::string& notation, const std::string& written)
+    {
+        SCOPED_TRACE(notation);
+        LifeRule rule = LifeRule::parse(notation);
+        EXPECT_EQ(written, rule.toString());
+        EXPECT_EQ(rule, LifeRule::parse(rule.toString()));
+    }
+}
+
+TEST(LifeRule_Parse, ReadsBirthSurvival)
+{
+    expectRoundTrip("B3/S23", "B3/S23");
+    expectRoundTrip("b36/s23", "B36/S23");
+    expectRoundTrip("S23/B3", "B3/S23");
+    expectRoundTrip("B/S", "B/S");
+    expectRoundTrip("B012345678/S012345678", "B012345678/S012345678");
+    EXPECT_EQ(LifeRule(), LifeRule::parse("B3/S23"));
+
+    LifeRule rule = LifeRule::parse("B36/S125");
+    EXPECT_EQ(1, rule.getRadius());
+    EXPECT_EQ(2, rule.getStateCount());
+    EXPECT_EQ(8, rule.getMaxCount());
+    EXPECT_EQ((1 << 3) | (1 << 6), rule.getBirthMask());
+    EXPECT_EQ((1 << 1) | (1 << 2) | (1 << 5), rule.getSurvivalMask());
+}
+
+TEST(LifeRule_Parse, ReadsSurvivalBirthStates)
+{
+    // Without letters the parts are survival, birth and states, in that order
+    expectRoundTrip("23/3", "B3/S23");
+    expectRoundTrip("345/2/4", "B2/S345/C4");
+    EXPECT_EQ(LifeRule::parse("B2/S345/C4"), LifeRule::parse("345/2/4"));
+    expectRoundTrip("B2/S345/C5", "B2/S345/C5");
+    expectRoundTrip("B2/S345/G5", "B2/S345/C5");
+
+    EXPECT_EQ(5, LifeRule::parse("B2/S345/C5").getStateCount());
+    // Two states is plain Life, written without C
+    expectRoundTrip("B3/S23/C2", "B3/S23");
+    expectRoundTrip("B2/S/C256", "B2/S/C256");
+    EXPECT_EQ(256, LifeRule::parse("B2/S/C256").getStateCount());
+}
+
+TEST(LifeRule_Parse, ReadsLargerThanLife)
+{
+    // M1 counts the cell itself, so survival is written one higher than it
+    // is stored, and comes back as M0
+    expectRoundTrip("R5,C0,M1,S34..58,B34..45,NM", "R5,C0,M0,S33..57,B34..45,NM");
+    expectRoundTrip("R2,C0,M0,S6..9,B7..8,NM", "R2,C0,M0,S6..9,B7..8,NM");
+    expectRoundTrip("r2,c2,m0,s6,b7,nm", "R2,C0,M0,S6..6,B7..7,NM");
+    expectRoundTrip("R2,C0,M0,S,B7..8,NM", "R2,C0,M0,S,B7..8,NM");
+
+    LifeRule rule = LifeRule::parse("R5,C0,M1,S34..58,B34..45,NM");
+    EXPECT_EQ(5, rule.getRadius());
+    EXPECT_EQ(2, rule.getStateCount());
+    EXPECT_EQ(120, rule.getMaxCount());
+    EXPECT_FALSE(rule.survives(32));
+    EXPECT_TRUE(rule.survives(33));
+    EXPECT_TRUE(rule.survives(57));
+    EXPECT_FALSE(rule.survives(58));
+    EXPECT_FALSE(rule.isBorn(33));
+    EXPECT_TRUE(rule.isBorn(34));
+    EXPECT_TRUE(rule.isBorn(45));
+    EXPECT_FALSE(rule.isBorn(46));
+
+    // The largest radius is read, and the largest count with it
+    EXPECT_EQ(100, LifeRule::parse("R100,C0,M0,S1..2,B3..4,NM").getRadius());
+    EXPECT_EQ(201 * 201 - 1, LifeRule::parse("R100,C0,M0,S1..2,B3..4,NM").getMaxCount());
+}
+
+TEST(LifeRule_Parse, RejectsBadNotation)
+{
+    const char* const bad[] = {
+        "",
+        "B3",
+        "B3/S23/C4/D",
+        "B9/S23",
+        "B3/Sx",
+        "B3/B3",
+        "Q3/S23",
+        "B3/S23/X4",
+        // Past MAX_STATES, or too few to be a rule
+        "B3/S23/C257",
+        "B3/S23/C1",
+        "B3/S23/C",
+        // Past MAX_RADIUS, or none
+        "R101,C0,M0,S1..2,B3..4,NM",
+        "R0,C0,M0,S1..2,B3..4,NM",
+        "R,C0,M0,S1..2,B3..4,NM",
+        "R5,C3,M0,S1..2,B3..4,NM",
+        "R5,C0,M0,S1..2,B3..4,NN",
+        "R5,C0,M0,S1..2,NM",
+        "R5,C0,M0,B3..4,NM",
+        "R5,C0,M0,Sx..2,B3..4,NM",
+        "R5,C0,M0,S1..2,B3..4,NM,X",
+        "R5,C0,M0,S1..2,B3..1234567890,NM",
+    };
+    for (const char* notation : bad)
+    {
+        SCOPED_TRACE(notation);
+        EXPECT_THROW(LifeRule::parse(notation), std::invalid_argument);
+    }
+}
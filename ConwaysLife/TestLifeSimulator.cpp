@@ -0,0 +1,564 @@
+#include "LifeSimulator.hpp"
+#include "PatternAcorn.hpp"
+#include "PatternBlinker.hpp"
+#include "PatternBlock.hpp"
+#include "PatternGlider.hpp"
+#include "PatternGosperGliderGun.hpp"
+#include "PatternSoup.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::uint32_t BOARD_SIZE = 64;
+    const std::uint64_t WINDOW = 100;
+    // A glider comes back to where it started once it has crossed the torus,
+    // four generations per cell
+    const std::uint32_t TORUS_SIZE = 16;
+    const std::uint64_t GLIDER_WRAP_PERIOD = 4 * TORUS_SIZE;
+
+    // Sizes that end mid-word and mid-tile, and one cell wrapping onto itself
+    const Coordinate REFERENCE_SIZES[] = { { 1, 1 }, { 63, 65 }, { 130, 70 }, { 520, 130 } };
+    const std::uint64_t REFERENCE_GENERATIONS = 40;
+
+    // Several tiles each way, the last ones partial
+    const std::uint32_t STEPPING_SIZE_X = 1100;
+    const std::uint32_t STEPPING_SIZE_Y = 300;
+    const std::uint64_t STEPPING_GENERATIONS = 150;
+    const std::uint64_t STEPPING_SEED = 7;
+    const std::uint64_t STATISTICS_GENERATIONS = 60;
+
+    // Big enough that most tiles are neither changing nor next to a change
+    const std::uint32_t SCATTERED_SIZE_X = 3000;
+    const std::uint32_t SCATTERED_SIZE_Y = 700;
+    const std::uint32_t STEPPING_PATCH_SIZE = 40;
+    const char* const STEPPING_RULES[] = { "B3/S23", "B36/S23", "B2/S345/C4", "R2,C0,M1,S6..9,B7..8,NM" };
+
+    // A torus stepped the slow way, each cell counting its neighbors one by
+    // one. States are numbered as LifeSimulator::getState() numbers them.
+    class Reference : public Pattern
+    {
+      public:
+        Reference(std::uint32_t sizeX, std::uint32_t sizeY, std::uint32_t seed) :
+            sizeX(sizeX),
+            sizeY(sizeY),
+            states(static_cast<std::size_t>(sizeX) * sizeY)
+        {
+            std::mt19937 random(seed);
+            for (std::uint8_t& state : states)
+            {
+                state = random() % 3 == 0;
+            }
+        }
+
+        std::uint32_t getSizeX() const override { return sizeX; }
+        std::uint32_t getSizeY() const override { return sizeY; }
+        bool getCell(std::uint32_t x, std::uint32_t y) const override { return getState(x, y) == 1; }
+        std::uint32_t getState(std::uint32_t x, std::uint32_t y) const { return states[static_cast<std::size_t>(y) * sizeX + x]; }
+
+        void update(const LifeRule& rule)
+        {
+            std::uint32_t radius = rule.getRadius();
+            std::vector<std::uint8_t> next(states.size());
+            for (std::uint32_t y = 0; y < sizeY; ++y)
+            {
+                for (std::uint32_t x = 0; x < sizeX; ++x)
+                {
+                    std::uint32_t count = 0;
+                    for (std::uint32_t dy = sizeY * radius - radius; dy <= sizeY * radius + radius; ++dy)
+                    {
+                        for (std::uint32_t dx = sizeX * radius - radius; dx <= sizeX * radius + radius; ++dx)
+                        {
+                            count += (dx != sizeX * radius || dy != sizeY * radius) && getCell((x + dx) % sizeX, (y + dy) % sizeY);
+                        }
+                    }
+
+                    // Live cells that do not survive start dying, if the
+                    // rule has dying states, and dying cells age until dead
+                    std::uint32_t state = getState(x, y);
+                    if (state == 0)
+                    {
+                        state = rule.isBorn(count);
+                    }
+                    else if (state == 1)
+                    {
+                        state = rule.survives(count) ? 1 : rule.getStateCount() > 2 ? 2 : 0;
+                    }
+                    else
+                    {
+                        state = state + 1 < rule.getStateCount() ? state + 1 : 0;
+                    }
+                    next[static_cast<std::size_t>(y) * sizeX + x] = static_cast<std::uint8_t>(state);
+                }
+            }
+            states.swap(next);
+        }
+
+      private:
+        std::uint32_t sizeX;
+        std::uint32_t sizeY;
+        std::vector<std::uint8_t> states;
+    };
+
+    void expectSameStates(const Reference& expected, const LifeSimulator& actual)
+    {
+        for (std::uint32_t y = 0; y < expected.getSizeY(); ++y)
+        {
+            for (std::uint32_t x = 0; x < expected.getSizeX(); ++x)
+            {
+                ASSERT_EQ(expected.getCell(x, y), actual.getCell(x, y)) << "cell " << x << ", " << y;
+                ASSERT_EQ(expected.getState(x, y), actual.getState(x, y)) << "cell " << x << ", " << y;
+            }
+        }
+    }
+
+    // Steps a random board on the simulator and the reference side by side
+    void compareWithReference(const char* notation)
+    {
+        LifeRule rule = LifeRule::parse(notation);
+        for (const Coordinate& size : REFERENCE_SIZES)
+        {
+            // Larger than Life needs a board at least as wide and high as its box
+            if (rule.getRadius() > 1 && (size.first <= 2 * rule.getRadius() || size.second <= 2 * rule.getRadius()))
+            {
+                continue;
+            }
+            SCOPED_TRACE(std::string(notation) + " on " + std::to_string(size.first) + " by " + std::to_string(size.second));
+            Reference reference(size.first, size.second, size.first);
+            LifeSimulator sim(size.first, size.second, rule);
+            sim.insertPattern(reference, 0, 0);
+
+            for (std::uint64_t generation = 1; generation <= REFERENCE_GENERATIONS; ++generation)
+            {
+                SCOPED_TRACE("generation " + std::to_string(generation));
+                reference.update(rule);
+                sim.update();
+                expectSameStates(reference, sim);
+                if (testing::Test::HasFatalFailure())
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    void fillSoup(LifeSimulator& sim)
+    {
+        sim.fillSoup(SoupGenerator(STEPPING_SEED));
+    }
+
+    // A patch of soup across the corner of four tiles, a glider that crosses
+    // tile edges on its way down and right, and a blinker and a block far
+    // from both, leaving most tiles empty or still
+    void insertScattered(LifeSimulator& sim)
+    {
+        sim.insertPattern(PatternSoup(STEPPING_PATCH_SIZE, STEPPING_PATCH_SIZE, STEPPING_SEED), 512 - STEPPING_PATCH_SIZE / 2, TILE_ROWS - STEPPING_PATCH_SIZE / 2);
+        sim.insertPattern(PatternGlider(), 10, 3 * TILE_ROWS - 20);
+        sim.insertPattern(PatternBlinker(), sim.getSizeX() - 2, sim.getSizeY() - 2);
+        sim.insertPattern(PatternBlock(), sim.getSizeX() / 2, sim.getSizeY() / 2);
+    }
+
+    // Counts the live cells of the box from (beginX, beginY) to before
+    // (endX, endY) one by one, with their box in cells from its corner
+    BlockCensus scanCells(const LifeSimulator& sim, std::uint32_t beginX, std::uint32_t beginY, std::uint32_t endX, std::uint32_t endY)
+    {
+        BlockCensus census;
+        for (std::uint32_t y = beginY; y < endY; ++y)
+        {
+            for (std::uint32_t x = beginX; x < endX; ++x)
+            {
+                if (sim.getCell(x, y))
+                {
+                    ++census.population;
+                    census.box.minX = std::min(census.box.minX, x - beginX);
+                    census.box.minY = std::min(census.box.minY, y - beginY);
+                    census.box.maxX = std::max(census.box.maxX, x - beginX);
+                    census.box.maxY = std::max(census.box.maxY, y - beginY);
+                }
+            }
+        }
+        return census;
+    }
+
+    void expectSameCensus(const BlockCensus& expected, const BlockCensus& actual)
+    {
+        EXPECT_EQ(expected.population, actual.population);
+        ASSERT_EQ(expected.box.isEmpty(), actual.box.isEmpty());
+        if (!expected.box.isEmpty())
+        {
+            EXPECT_EQ(expected.box.minX, actual.box.minX);
+            EXPECT_EQ(expected.box.minY, actual.box.minY);
+            EXPECT_EQ(expected.box.maxX, actual.box.maxX);
+            EXPECT_EQ(expected.box.maxY, actual.box.maxY);
+        }
+    }
+
+    // Population, bounding box and each tile's census against a scan of every cell
+    void expectStatistics(const LifeSimulator& sim)
+    {
+        BlockCensus board = scanCells(sim, 0, 0, sim.getSizeX(), sim.getSizeY());
+        BlockCensus kept;
+        kept.population = static_cast<std::uint32_t>(sim.getPopulation());
+        kept.box = sim.getBoundingBox();
+        ASSERT_EQ(board.population, sim.getPopulation());
+        ASSERT_NO_FATAL_FAILURE(expectSameCensus(board, kept));
+
+        const std::uint32_t tileCells = static_cast<std::uint32_t>(TILE_WORDS * CELLS_PER_WORD);
+        for (std::size_t tileY = 0; tileY < sim.getTilesY(); ++tileY)
+        {
+            for (std::size_t tileX = 0; tileX < sim.getTilesX(); ++tileX)
+            {
+                SCOPED_TRACE("tile " + std::to_string(tileX) + ", " + std::to_string(tileY));
+                std::uint32_t beginX = static_cast<std::uint32_t>(tileX) * tileCells;
+                std::uint32_t beginY = static_cast<std::uint32_t>(tileY) * TILE_ROWS;
+                BlockCensus tile = scanCells(sim, beginX, beginY, std::min(beginX + tileCells, sim.getSizeX()), std::min(beginY + TILE_ROWS, sim.getSizeY()));
+                ASSERT_NO_FATAL_FAILURE(expectSameCensus(tile, sim.getTileCensus()[tileY * sim.getTilesX() + tileX]));
+            }
+        }
+    }
+
+    // Where the gun goes: inside, across the right edge, across the bottom
+    // edge, across the corner, and past the board's end, which wraps too
+    const Coordinate PLACEMENTS[] = { { 10, 10 }, { 110, 20 }, { 40, 65 }, { 110, 65 }, { 129, 69 }, { 240, 135 } };
+
+    // The cells a pattern copied in at (startX, startY) should leave: its own
+    // where it lands, wrapped around the torus and cut to the board, and the
+    // board's cells elsewhere
+    void expectPlaced(const Pattern& board, const Pattern& pattern, std::uint32_t startX, std::uint32_t startY, const LifeSimulator& sim)
+    {
+        std::uint32_t sizeX = sim.getSizeX();
+        std::uint32_t sizeY = sim.getSizeY();
+        for (std::uint32_t y = 0; y < sizeY; ++y)
+        {
+            for (std::uint32_t x = 0; x < sizeX; ++x)
+            {
+                std::uint32_t patternX = (x + sizeX - startX % sizeX) % sizeX;
+                std::uint32_t patternY = (y + sizeY - startY % sizeY) % sizeY;
+                bool covered = patternX < pattern.getSizeX() && patternY < pattern.getSizeY();
+                bool expected = covered ? pattern.getCell(patternX, patternY) : board.getCell(x, y);
+                ASSERT_EQ(expected, sim.getCell(x, y)) << "cell " << x << ", " << y;
+            }
+        }
+    }
+
+    void expectSameStatesAs(const LifeSimulator& expected, const LifeSimulator& actual)
+    {
+        for (std::uint32_t y = 0; y < expected.getSizeY(); ++y)
+        {
+            for (std::uint32_t x = 0; x < expected.getSizeX(); ++x)
+            {
+                ASSERT_EQ(expected.getState(x, y), actual.getState(x, y)) << "cell " << x << ", " << y;
+            }
+        }
+    }
+
+    // How a simulator steps, to be compared with one thread stepping every tile
+    struct Stepping
+    {
+        std::size_t threadCount;
+        bool sparse;
+    };
+
+    // Steps one soup the plain way and each other way side by side,
+    // comparing the boards every generation
+    void compareStepping(const char* notation, std::initializer_list<Stepping> steppings, const Coordinate& size = { STEPPING_SIZE_X, STEPPING_SIZE_Y },
+                         const std::function<void(LifeSimulator&)>& start = fillSoup)
+    {
+        LifeRule rule = LifeRule::parse(notation);
+        LifeSimulator plain(size.first, size.second, rule);
+        plain.setThreadCount(1);
+        start(plain);
+
+        std::vector<std::unique_ptr<LifeSimulator>> others;
+        for (const Stepping& stepping : steppings)
+        {
+            others.push_back(std::make_unique<LifeSimulator>(size.first, size.second, rule));
+            others.back()->setThreadCount(stepping.threadCount);
+            others.back()->setSparse(stepping.sparse);
+            start(*others.back());
+        }
+
+        std::vector<std::uint64_t> expectedRow(wordsForCells(size.first));
+        std::vector<std::uint64_t> actualRow(expectedRow.size());
+        for (std::uint64_t generation = 1; generation <= STEPPING_GENERATIONS; ++generation)
+        {
+            plain.update();
+            for (std::size_t i = 0; i < others.size(); ++i)
+            {
+                const Stepping& stepping = steppings.begin()[i];
+                SCOPED_TRACE(std::string(notation) + ", " + std::to_string(stepping.threadCount) + " thread(s), " + (stepping.sparse ? "sparse" : "dense") +
+                             ", generation " + std::to_string(generation));
+                LifeSimulator& other = *others[i];
+                other.update();
+                ASSERT_EQ(plain.getPopulation(), other.getPopulation());
+                // The hash covers the ages of Generations rules too
+                ASSERT_EQ(plain.getHash(), other.getHash());
+                for (std::uint32_t y = 0; y < size.second; ++y)
+                {
+                    plain.getRow(y, expectedRow.data());
+                    other.getRow(y, actualRow.data());
+                    ASSERT_EQ(expectedRow, actualRow) << "row " << y;
+                }
+            }
+        }
+    }
+}
+
+TEST(LifeSimulator_Update, MatchesReferenceForLife)
+{
+    compareWithReference("B3/S23");
+}
+
+TEST(LifeSimulator_Update, MatchesReferenceForOtherRules)
+{
+    for (const char* notation : { "B36/S23", "B3678/S34678", "B1/S012345678", "B0/S8", "B2/S" })
+    {
+        compareWithReference(notation);
+    }
+}
+
+TEST(LifeSimulator_Update, MatchesReferenceForGenerations)
+{
+    for (const char* notation : { "B2/S345/C4", "B2/S/C3", "B3/S23/C8", "B34/S34/C256" })
+    {
+        compareWithReference(notation);
+    }
+}
+
+TEST(LifeSimulator_Update, MatchesReferenceForLargerThanLife)
+{
+    for (const char* notation : { "R2,C0,M1,S6..9,B7..8,NM", "R3,C0,M0,S10..22,B13..20,NM", "R5,C0,M1,S34..58,B34..45,NM" })
+    {
+        compareWithReference(notation);
+    }
+}
+
+TEST(LifeSimulator_SetRule, RejectsBoxWiderThanBoard)
+{
+    // R5 counts over an 11 by 11 box, which wraps onto itself on anything smaller
+    LifeRule rule = LifeRule::parse("R5,C0,M1,S34..58,B34..45,NM");
+    EXPECT_THROW(LifeSimulator(8, 8, rule), std::invalid_argument);
+    EXPECT_THROW(LifeSimulator(10, 64, rule), std::invalid_argument);
+    EXPECT_THROW(LifeSimulator(64, 10, rule), std::invalid_argument);
+    EXPECT_NO_THROW(LifeSimulator(11, 11, rule));
+
+    // A rejected rule leaves the simulator under its old one
+    LifeSimulator sim(8, 8);
+    EXPECT_THROW(sim.setRule(rule), std::invalid_argument);
+    EXPECT_EQ(LifeRule(), sim.getRule());
+
+    // Radius 1 rules step any torus, however small
+    EXPECT_NO_THROW(LifeSimulator(1, 1, LifeRule::parse("B2/S345/C4")));
+}
+
+TEST(LifeSimulator_SetThreadCount, MatchesOneThread)
+{
+    for (const char* notation : STEPPING_RULES)
+    {
+        compareStepping(notation, { { 2, false }, { 4, false }, { 7, false } });
+    }
+}
+
+TEST(LifeSimulator_SetSparse, MatchesDenseStepping)
+{
+    for (const char* notation : STEPPING_RULES)
+    {
+        compareStepping(notation, { { 1, true }, { 4, true } });
+        compareStepping(notation, { { 1, true }, { 4, true } }, { SCATTERED_SIZE_X, SCATTERED_SIZE_Y }, insertScattered);
+    }
+}
+
+TEST(LifeSimulator_Statistics, MatchFullScan)
+{
+    for (bool sparse : { false, true })
+    {
+        SCOPED_TRACE(sparse ? "sparse" : "dense");
+        LifeSimulator sim(STEPPING_SIZE_X, STEPPING_SIZE_Y);
+        sim.setSparse(sparse);
+        // In the first tile, across tile edges inside the board, in the
+        // partial tiles at the right and bottom, and wrapping around the corner
+        sim.insertPattern(PatternGlider(), 10, 10);
+        sim.insertPattern(PatternAcorn(), 510, TILE_ROWS - 2);
+        sim.insertPattern(PatternBlinker(), 1060, 150);
+        sim.insertPattern(PatternGlider(), 700, STEPPING_SIZE_Y - 8);
+        sim.insertPattern(PatternBlock(), STEPPING_SIZE_X - 1, STEPPING_SIZE_Y - 1);
+        ASSERT_NO_FATAL_FAILURE(expectStatistics(sim));
+
+        for (std::uint64_t generation = 1; generation <= STATISTICS_GENERATIONS; ++generation)
+        {
+            SCOPED_TRACE("generation " + std::to_string(generation));
+            sim.update();
+            ASSERT_NO_FATAL_FAILURE(expectStatistics(sim));
+        }
+
+        // A pattern dropped into a quiet tile shows up at once
+        sim.insertPattern(PatternBlinker(), 300, 200);
+        ASSERT_NO_FATAL_FAILURE(expectStatistics(sim));
+    }
+}
+
+TEST(LifeSimulator_InsertPattern, WrapsAroundEdges)
+{
+    const Coordinate size = REFERENCE_SIZES[2];
+    const PatternGosperGliderGun gun;
+    for (const Coordinate& start : PLACEMENTS)
+    {
+        SCOPED_TRACE("at " + std::to_string(start.first) + ", " + std::to_string(start.second));
+        // Dead cells of the pattern overwrite live ones of the board
+        Reference board(size.first, size.second, start.first);
+        LifeSimulator sim(size.first, size.second);
+        sim.insertPattern(board, 0, 0);
+        sim.insertPattern(static_cast<const Pattern&>(gun), start.first, start.second);
+        ASSERT_NO_FATAL_FAILURE(expectPlaced(board, gun, start.first, start.second, sim));
+        EXPECT_EQ(sim.getPopulation(), scanCells(sim, 0, 0, size.first, size.second).population);
+    }
+
+    // Cut to a board smaller than the pattern
+    LifeSimulator small(20, 5);
+    small.insertPattern(static_cast<const Pattern&>(gun), 15, 3);
+    expectPlaced(LifeSimulator(20, 5), gun, 15, 3, small);
+}
+
+TEST(LifeSimulator_InsertPattern, CopiesFixedPatternsAsAnyOther)
+{
+    const Coordinate size = REFERENCE_SIZES[2];
+    const PatternGosperGliderGun gun;
+    for (const Coordinate& start : PLACEMENTS)
+    {
+        SCOPED_TRACE("at " + std::to_string(start.first) + ", " + std::to_string(start.second));
+        Reference board(size.first, size.second, start.first);
+        // The template overload, reading the rows the type holds, and the
+        // virtual one, reading them through getRow()
+        LifeSimulator fixed(size.first, size.second);
+        fixed.insertPattern(board, 0, 0);
+        fixed.insertPattern(gun, start.first, start.second);
+        LifeSimulator virtualCopy(size.first, size.second);
+        virtualCopy.insertPattern(board, 0, 0);
+        virtualCopy.insertPattern(static_cast<const Pattern&>(gun), start.first, start.second);
+
+        ASSERT_NO_FATAL_FAILURE(expectPlaced(board, gun, start.first, start.second, fixed));
+        EXPECT_EQ(virtualCopy.getPopulation(), fixed.getPopulation());
+        EXPECT_EQ(virtualCopy.getHash(), fixed.getHash());
+        expectSameStatesAs(virtualCopy, fixed);
+    }
+
+    // Under a Generations rule both clear the ages of the cells they cover
+    LifeSimulator fixed(size.first, size.second, LifeRule::parse("B2/S/C5"));
+    LifeSimulator virtualCopy(size.first, size.second, LifeRule::parse("B2/S/C5"));
+    for (LifeSimulator* sim : { &fixed, &virtualCopy })
+    {
+        sim->fillSoup(SoupGenerator(1));
+        sim->advance(3);
+    }
+    fixed.insertPattern(gun, 110, 65);
+    virtualCopy.insertPattern(static_cast<const Pattern&>(gun), 110, 65);
+    EXPECT_EQ(virtualCopy.getHash(), fixed.getHash());
+    expectSameStatesAs(virtualCopy, fixed);
+}
+
+TEST(LifeSimulator_CycleWindow, FindsStillLife)
+{
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    sim.setCycleWindow(WINDOW);
+    sim.insertPattern(PatternBlock(), 10, 10);
+
+    sim.advance(5);
+    EXPECT_EQ(1, sim.getCyclePeriod());
+    EXPECT_EQ(1, sim.getRepeatGeneration());
+}
+
+TEST(LifeSimulator_CycleWindow, FindsOscillator)
+{
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    sim.setCycleWindow(WINDOW);
+    sim.insertPattern(PatternBlinker(), 10, 10);
+
+    sim.update();
+    EXPECT_EQ(0, sim.getCyclePeriod());
+
+    // Back to where it started in generation 2, and still reported as such later
+    sim.update();
+    EXPECT_EQ(2, sim.getCyclePeriod());
+    EXPECT_EQ(2, sim.getRepeatGeneration());
+    sim.advance(7);
+    EXPECT_EQ(2, sim.getCyclePeriod());
+    EXPECT_EQ(2, sim.getRepeatGeneration());
+}
+
+TEST(LifeSimulator_CycleWindow, FindsGliderWrappingAroundTorus)
+{
+    LifeSimulator sim(TORUS_SIZE, TORUS_SIZE);
+    sim.setCycleWindow(WINDOW);
+    sim.insertPattern(PatternGlider(), 4, 4);
+
+    sim.advance(GLIDER_WRAP_PERIOD - 1);
+    EXPECT_EQ(0, sim.getCyclePeriod());
+    sim.update();
+    EXPECT_EQ(GLIDER_WRAP_PERIOD, sim.getCyclePeriod());
+    EXPECT_EQ(GLIDER_WRAP_PERIOD, sim.getRepeatGeneration());
+}
+
+TEST(LifeSimulator_CycleWindow, MissesCycleLongerThanWindow)
+{
+    LifeSimulator sim(TORUS_SIZE, TORUS_SIZE);
+    sim.setCycleWindow(GLIDER_WRAP_PERIOD / 2);
+    sim.insertPattern(PatternGlider(), 4, 4);
+
+    sim.advance(GLIDER_WRAP_PERIOD * 3);
+    EXPECT_EQ(0, sim.getCyclePeriod());
+    EXPECT_EQ(0, sim.getRepeatGeneration());
+}
+
+TEST(LifeSimulator_CycleWindow, RestartsWhenPatternInserted)
+{
+    LifeSimulator sim(BOARD_SIZE, BOARD_SIZE);
+    sim.setCycleWindow(WINDOW);
+    sim.insertPattern(PatternBlock(), 10, 10);
+    sim.advance(5);
+    ASSERT_EQ(1, sim.getCyclePeriod());
+
+    // The block alone repeated, but the board with the blinker has not yet
+    sim.insertPattern(PatternBlinker(), 30, 30);
+    EXPECT_EQ(0, sim.getCyclePeriod());
+    EXPECT_EQ(0, sim.getRepeatGeneration());
+    sim.update();
+    EXPECT_EQ(0, sim.getCyclePeriod());
+    sim.update();
+    EXPECT_EQ(2, sim.getCyclePeriod());
+    EXPECT_EQ(7, sim.getRepeatGeneration());
+}
+
+// The hash kept up to date from the cells that flip stays the one taken from
+// the whole board, under every kind of kernel and in the partial tiles
+TEST(LifeSimulator_CycleWindow, KeepsHashOfWholeBoard)
+{
+    for (const char* notation : STEPPING_RULES)
+    {
+        for (bool sparse : { false, true })
+        {
+            SCOPED_TRACE(std::string(notation) + (sparse ? ", sparse" : ", dense"));
+            LifeRule rule = LifeRule::parse(notation);
+            LifeSimulator tracked(STEPPING_SIZE_X, STEPPING_SIZE_Y, rule);
+            LifeSimulator recomputed(STEPPING_SIZE_X, STEPPING_SIZE_Y, rule);
+            tracked.setCycleWindow(WINDOW);
+            tracked.setSparse(sparse);
+            fillSoup(tracked);
+            fillSoup(recomputed);
+
+            for (std::uint64_t generation = 1; generation <= STATISTICS_GENERATIONS; ++generation)
+            {
+                tracked.update();
+                recomputed.update();
+                ASSERT_EQ(recomputed.getHash(), tracked.getHash()) << "generation " << generation;
+            }
+        }
+    }
+}
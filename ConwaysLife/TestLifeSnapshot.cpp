@@ -0,0 +1,208 @@
+#include "CheckpointWriter.hpp"
+#include "LifeKernel.hpp"
+#include "LifeSimulator.hpp"
+#include "LifeSnapshot.hpp"
+#include "SoupGenerator.hpp"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Not a multiple of 64 wide, so rows end in a partial word
+    const std::uint32_t SIZE_X = 200;
+    const std::uint32_t SIZE_Y = 150;
+    const std::uint64_t GENERATIONS = 20;
+    const char* const RULES[] = { "B3/S23", "B2/S345/C5", "R2,C0,M1,S6..9,B7..8,NM" };
+
+    // Removed again when done, along with any temporary file a save left
+    class SnapshotPath
+    {
+      public:
+        explicit SnapshotPath(const std::string& name) :
+            path(testing::TempDir() + name)
+        {
+        }
+        ~SnapshotPath()
+        {
+            std::remove(path.c_str());
+            std::remove((path + ".tmp").c_str());
+        }
+
+        const std::string path;
+    };
+
+    // A soup some generations on, so a Generations rule has dying cells of every age
+    LifeSimulator makeSimulator(const char* notation)
+    {
+        LifeSimulator sim(SIZE_X, SIZE_Y, LifeRule::parse(notation));
+        sim.fillSoup(SoupGenerator(1));
+        sim.advance(GENERATIONS);
+        return sim;
+    }
+
+    void expectSameState(const LifeSimulator& expected, const LifeSimulator& actual)
+    {
+        ASSERT_EQ(expected.getSizeX(), actual.getSizeX());
+        ASSERT_EQ(expected.getSizeY(), actual.getSizeY());
+        EXPECT_EQ(expected.getRule().toString(), actual.getRule().toString());
+        EXPECT_EQ(expected.getGeneration(), actual.getGeneration());
+        EXPECT_EQ(expected.getPopulation(), actual.getPopulation());
+        EXPECT_EQ(expected.getHash(), actual.getHash());
+        for (std::uint32_t y = 0; y < expected.getSizeY(); ++y)
+        {
+            for (std::uint32_t x = 0; x < expected.getSizeX(); ++x)
+            {
+                ASSERT_EQ(expected.getState(x, y), actual.getState(x, y)) << "cell " << x << ", " << y;
+            }
+        }
+    }
+
+    void expectRoundTrip(bool compress)
+    {
+        for (const char* notation : RULES)
+        {
+            SCOPED_TRACE(notation);
+            SnapshotPath file("round-trip.snap");
+            LifeSimulator sim = makeSimulator(notation);
+            LifeSnapshot(sim).save(file.path, compress);
+
+            LifeSimulator loaded = LifeSnapshot::load(file.path);
+            expectSameState(sim, loaded);
+
+            // Both step on to the same board
+            sim.update();
+            loaded.update();
+            expectSameState(sim, loaded);
+        }
+    }
+}
+
+TEST(LifeSnapshot_Load, ReadsBackRawSnapshot)
+{
+    expectRoundTrip(false);
+}
+
+TEST(LifeSnapshot_Load, ReadsBackCompressedSnapshot)
+{
+    expectRoundTrip(true);
+}
+
+TEST(LifeSnapshot_Load, RejectsTruncatedSnapshot)
+{
+    for (bool compress : { false, true })
+    {
+        SCOPED_TRACE(compress ? "compressed" : "raw");
+        SnapshotPath file("truncated.snap");
+        LifeSnapshot(makeSimulator("B2/S345/C5")).save(file.path, compress);
+
+        // Short of its last word, then cut off in the middle of the header
+        std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - sizeof(std::uint64_t));
+        EXPECT_THROW(LifeSnapshot::load(file.path), std::runtime_error);
+        std::filesystem::resize_file(file.path, 40);
+        EXPECT_THROW(LifeSnapshot::load(file.path), std::runtime_error);
+    }
+}
+
+TEST(LifeSnapshot_Load, RejectsRuleLengthPastEndOfFile)
+{
+    SnapshotPath file("rule-length.snap");
+    LifeSnapshot(makeSimulator("B3/S23")).save(file.path);
+
+    // The rule length sits 36 bytes into the header
+    std::fstream stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+    const std::uint32_t ruleLength = 0xFFFFFFFF;
+    stream.seekp(36);
+    stream.write(reinterpret_cast<const char*>(&ruleLength), sizeof(ruleLength));
+    stream.close();
+
+    EXPECT_THROW(LifeSnapshot::load(file.path), std::runtime_error);
+}
+
+TEST(LifeSnapshot_Load, ClearsBitsPastTheLastCell)
+{
+    SnapshotPath file("stray-bits.snap");
+    LifeSimulator sim = makeSimulator("B2/S345/C5");
+    LifeSnapshot(sim).save(file.path);
+
+    // Sets the bits past the last cell in the first row, then in the first
+    // row of ages, which follow the 64-byte header and the rule padded to
+    // 16 bytes
+    const std::uint64_t wordsPerRow = wordsForCells(SIZE_X);
+    const std::uint64_t cellsStart = 64 + 16;
+    const std::uint64_t agesStart = cellsStart + SIZE_Y * wordsPerRow * sizeof(std::uint64_t);
+    std::fstream stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+    for (std::uint64_t rowStart : { cellsStart, agesStart })
+    {
+        auto lastWord = static_cast<std::streamoff>(rowStart + (wordsPerRow - 1) * sizeof(std::uint64_t));
+        std::uint64_t word = 0;
+        stream.seekg(lastWord);
+        stream.read(reinterpret_cast<char*>(&word), sizeof(word));
+        word |= ~lastWordMask(SIZE_X);
+        stream.seekp(lastWord);
+        stream.write(reinterpret_cast<const char*>(&word), sizeof(word));
+    }
+    stream.close();
+
+    LifeSimulator loaded = LifeSnapshot::load(file.path);
+    EXPECT_EQ(0u, loaded.getBoard().getRow(0)[wordsPerRow - 1] & ~lastWordMask(SIZE_X));
+    expectSameState(sim, loaded);
+    sim.update();
+    loaded.update();
+    expectSameState(sim, loaded);
+}
+
+TEST(LifeSimulator_ShareBoard, UpdateLeavesSharedBoardUntouched)
+{
+    // A fresh soup leaves the halo to the next update(), which must not
+    // refresh it in the board a snapshot is still reading
+    LifeSimulator sim(SIZE_X, SIZE_Y);
+    sim.fillSoup(SoupGenerator(1));
+    auto shared = sim.shareBoard();
+    const std::uint64_t* first = shared->getRow(-1) - 1;
+    std::vector<std::uint64_t> before(first, first + (SIZE_Y + 2) * shared->getStride());
+
+    sim.update();
+
+    EXPECT_EQ(before, std::vector<std::uint64_t>(first, first + before.size()));
+}
+
+TEST(CheckpointWriter_Submit, SavesWhileTheSimulationSteps)
+{
+    // A snapshot every other generation, and a pause after each for the
+    // writer to finish it, so the simulator next writes to a board the
+    // writer let go of without anything else passing between the threads.
+    // Run under ThreadSanitizer, this catches those writes racing the save.
+    const auto pause = std::chrono::milliseconds(2);
+    for (const char* notation : RULES)
+    {
+        SCOPED_TRACE(notation);
+        SnapshotPath file("checkpoint.snap");
+        LifeSimulator sim = makeSimulator(notation);
+        CheckpointWriter writer(file.path, false);
+        for (std::uint64_t generation = 1; generation <= GENERATIONS; ++generation)
+        {
+            sim.update();
+            if (generation % 2 == 0)
+            {
+                writer.submit(LifeSnapshot(sim));
+                std::this_thread::sleep_for(pause);
+            }
+        }
+        writer.flush();
+
+        // Snapshots still waiting when a newer one came were never written
+        EXPECT_GE(writer.getSavedCount(), 1u);
+        EXPECT_LE(writer.getSavedCount(), GENERATIONS / 2);
+        EXPECT_EQ("", writer.getLastError());
+        LifeSimulator loaded = LifeSnapshot::load(file.path);
+        expectSameState(sim, loaded);
+    }
+}
@@ -0,0 +1,154 @@
+#include "LifeSimulator.hpp"
+#include "ObjectCensus.hpp"
+#include "SoupGenerator.hpp"
+#include "TestPatterns.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Far enough apart that no two objects come within reach of each other
+    const std::uint32_t SPACING = 10;
+    const std::uint32_t ROTATION_ROUNDS = 8;
+    const std::uint32_t SOUP_SIZE = 512;
+    const std::uint64_t SOUP_GENERATIONS = 200;
+
+    struct Named
+    {
+        const char* name;
+        const char* cells;
+    };
+
+    const Named OBJECTS[] = {
+        { "block", "OO/OO" },
+        { "beehive", ".OO./O..O/.OO." },
+        { "loaf", ".OO./O..O/.O.O/..O." },
+        { "boat", "OO./O.O/.O." },
+        { "ship", "OO./O.O/.OO" },
+        { "tub", ".O./O.O/.O." },
+        { "pond", ".OO./O..O/O..O/.OO." },
+        { "barge", ".O../O.O./.O.O/..O." },
+        { "long boat", "OO../O.O./.O.O/..O." },
+        { "mango", ".OO../O..O./.O..O/..OO." },
+        { "eater", "OO../O.O./..O./..OO" },
+        { "snake", "OO.O/O.OO" },
+        { "aircraft carrier", "OO../O..O/..OO" },
+        { "blinker", "OOO" },
+        { "toad", ".OOO/OOO." },
+        { "beacon", "OO../OO../..OO/..OO" },
+        { "glider", ".O./..O/OOO" },
+        { "lightweight spaceship", ".O..O/O..../O...O/OOOO." },
+    };
+
+    // The beacon's phase whose halves touch only across a dead cell
+    const char* const OPEN_BEACON = "OO../O.../...O/..OO";
+
+    const char* getName(const ObjectCensus::Object& object)
+    {
+        const char* name = ObjectCensus::getName(object.form);
+        return name ? name : "unnamed";
+    }
+}
+
+TEST(ObjectCensus_Take, NamesKnownObjectsInAnyOrientation)
+{
+    std::mt19937 random(1);
+    std::uint32_t objectCount = static_cast<std::uint32_t>(std::size(OBJECTS));
+    for (std::uint32_t round = 0; round < ROTATION_ROUNDS; ++round)
+    {
+        // One object to each SPACING wide column, turned at random
+        Board board(objectCount * SPACING, SPACING);
+        std::vector<std::uint32_t> orientations;
+        for (std::uint32_t i = 0; i < objectCount; ++i)
+        {
+            orientations.push_back(random() % 8);
+            board.draw(OBJECTS[i].cells, i * SPACING + 1, 1, orientations.back());
+        }
+
+        ObjectCensus census;
+        census.take(board, false);
+        ASSERT_EQ(objectCount, census.getObjects().size());
+        for (const ObjectCensus::Object& object : census.getObjects())
+        {
+            std::uint32_t i = object.x / SPACING;
+            SCOPED_TRACE(std::string(OBJECTS[i].name) + " in orientation " + std::to_string(orientations[i]));
+            EXPECT_STREQ(OBJECTS[i].name, getName(object));
+        }
+    }
+}
+
+TEST(ObjectCensus_Take, CountsObjectsAcrossEdgesOnce)
+{
+    // A beehive split by the right edge and a block by the corner
+    Board board(32, 32);
+    board.draw(OBJECTS[1].cells, 30, 10);
+    board.draw(OBJECTS[0].cells, 31, 31);
+
+    // The block comes first, as its lower half is in the top row
+    ObjectCensus census;
+    census.take(board, true);
+    ASSERT_EQ(2, census.getObjects().size());
+    EXPECT_STREQ("block", getName(census.getObjects()[0]));
+    EXPECT_EQ(4, census.getObjects()[0].population);
+    EXPECT_STREQ("beehive", getName(census.getObjects()[1]));
+    EXPECT_EQ(6, census.getObjects()[1].population);
+
+    // Without wrap, each piece is an object of its own
+    census.take(board, false);
+    EXPECT_EQ(6, census.getObjects().size());
+}
+
+TEST(ObjectCensus_Take, GivesSameObjectsOnAnyThreadCount)
+{
+    LifeSimulator sim(SOUP_SIZE, SOUP_SIZE);
+    sim.fillSoup(SoupGenerator(1));
+    sim.advance(SOUP_GENERATIONS);
+
+    for (bool wrap : { false, true })
+    {
+        SCOPED_TRACE(wrap ? "wrapped" : "bounded");
+        ObjectCensus single;
+        single.setThreadCount(1);
+        single.take(sim, wrap);
+        ObjectCensus several;
+        several.setThreadCount(7);
+        several.take(sim, wrap);
+
+        const std::vector<ObjectCensus::Object>& expected = single.getObjects();
+        const std::vector<ObjectCensus::Object>& actual = several.getObjects();
+        ASSERT_LT(100, expected.size());
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            SCOPED_TRACE("object " + std::to_string(i));
+            EXPECT_EQ(expected[i].x, actual[i].x);
+            EXPECT_EQ(expected[i].y, actual[i].y);
+            EXPECT_EQ(expected[i].sizeX, actual[i].sizeX);
+            EXPECT_EQ(expected[i].sizeY, actual[i].sizeY);
+            EXPECT_EQ(expected[i].population, actual[i].population);
+            EXPECT_EQ(expected[i].form, actual[i].form);
+        }
+    }
+}
+
+TEST(ObjectCensus_SetReach, SplitsBeaconOnlyWithinReachOne)
+{
+    Board board(SPACING, SPACING);
+    board.draw(OPEN_BEACON, 2, 2);
+
+    ObjectCensus census;
+    census.take(board, false);
+    ASSERT_EQ(1, census.getObjects().size());
+    EXPECT_STREQ("beacon", getName(census.getObjects()[0]));
+
+    census.setReach(1);
+    census.take(board, false);
+    ASSERT_EQ(2, census.getObjects().size());
+    EXPECT_EQ(3, census.getObjects()[0].population);
+    EXPECT_EQ(3, census.getObjects()[1].population);
+}
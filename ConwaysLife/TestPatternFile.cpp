@@ -0,0 +1,141 @@
+#include "PatternFile.hpp"
+#include "PatternGlider.hpp"
+#include "PatternGosperGliderGun.hpp"
+#include "TestPatterns.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // Writes the text to a file for PatternFile to map, removed again when done
+    class PatternText
+    {
+      public:
+        PatternText(const std::string& name, const std::string& text) :
+            path(testing::TempDir() + name)
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << text;
+        }
+        ~PatternText()
+        {
+            std::remove(path.c_str());
+        }
+
+        const std::string path;
+    };
+
+    const char* const GOSPER_GLIDER_GUN_RLE =
+        "#N Gosper glider gun\n"
+        "#C This is a glider gun\n"
+        "x = 36, y = 9, rule = B3/S23\n"
+        "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4b\n"
+        "obo$10bo5bo7bo$11bo3bo$12b2o!\n";
+}
+
+TEST(PatternFile_Rle, ReadsGosperGliderGun)
+{
+    PatternText file("gun.rle", GOSPER_GLIDER_GUN_RLE);
+    PatternFile pattern(file.path);
+
+    expectSameCells(PatternGosperGliderGun(), pattern);
+    EXPECT_EQ("B3/S23", pattern.getRuleNotation());
+}
+
+TEST(PatternFile_Rle, DropsBoundedGridSuffixFromRule)
+{
+    PatternText header("header.rle", "x = 3, y = 3, rule = B36/S23:T100,100\nbo$2bo$3o!\n");
+    EXPECT_EQ("B36/S23", PatternFile(header.path).getRuleNotation());
+
+    PatternText comment("comment.rle", "#r B2/S345/C5:T20,20\nx = 3, y = 3\nbo$2bo$3o!\n");
+    PatternFile pattern(comment.path);
+    EXPECT_EQ("B2/S345/C5", pattern.getRuleNotation());
+    expectSameCells(PatternGlider(), pattern);
+}
+
+TEST(PatternFile_Rle, ReadsRunsAcrossLines)
+{
+    // A run count broken by a line break, and a run of row ends
+    PatternText file("runs.rle", "x = 14, y = 4\n1\n2o2$\n2b\n3o!\n");
+    PatternFile pattern(file.path);
+
+    ASSERT_EQ(14, pattern.getSizeX());
+    ASSERT_EQ(4, pattern.getSizeY());
+    for (std::uint32_t x = 0; x < 14; ++x)
+    {
+        EXPECT_EQ(x < 12, pattern.getCell(x, 0)) << x;
+        EXPECT_FALSE(pattern.getCell(x, 1)) << x;
+        EXPECT_EQ(x >= 2 && x < 5, pattern.getCell(x, 2)) << x;
+        EXPECT_FALSE(pattern.getCell(x, 3)) << x;
+    }
+}
+
+TEST(PatternFile_Rle, RejectsUnexpectedCharacter)
+{
+    PatternText file("bad.rle", "x = 3, y = 3\nbo$2b?$3o!\n");
+    EXPECT_THROW(PatternFile pattern(file.path), std::runtime_error);
+}
+
+TEST(PatternFile_Rle, RejectsSizeTooLargeToHold)
+{
+    PatternText file("huge.rle", "x = 4000000000, y = 4000000000\no!\n");
+    EXPECT_THROW(PatternFile pattern(file.path), std::runtime_error);
+}
+
+TEST(PatternFile_Macrocell, ReadsLeafOnlyGlider)
+{
+    PatternText file("glider.mc", "[M2] (golly 4.0)\n#R B3/S23\n.*$..*$***$\n");
+    PatternFile pattern(file.path);
+
+    expectSameCells(PatternGlider(), pattern);
+    EXPECT_EQ("B3/S23", pattern.getRuleNotation());
+}
+
+TEST(PatternFile_Macrocell, ReadsNodesAboveLeaves)
+{
+    // A level 4 node with a lone cell at (7, 7) of its north-west leaf and
+    // a glider in its south-east one, which starts at (8, 8)
+    PatternText file("node.mc", "[M2] (golly 4.0)\n$$$$$$$.......*$\n.*$..*$***$\n4 1 0 0 2\n");
+    PatternFile pattern(file.path);
+
+    ASSERT_EQ(4, pattern.getSizeX());
+    ASSERT_EQ(4, pattern.getSizeY());
+    for (std::uint32_t y = 0; y < 4; ++y)
+    {
+        for (std::uint32_t x = 0; x < 4; ++x)
+        {
+            bool alive = (x == 0 && y == 0) || (x > 0 && y > 0 && PatternGlider::isAlive(x - 1, y - 1));
+            EXPECT_EQ(alive, pattern.getCell(x, y)) << "cell " << x << ", " << y;
+        }
+    }
+}
+
+TEST(PatternFile_Macrocell, RejectsBadLeaf)
+{
+    PatternText file("leaf.mc", "[M2] (golly 4.0)\n.*$..x$***$\n");
+    EXPECT_THROW(PatternFile pattern(file.path), std::runtime_error);
+}
+
+TEST(PatternFile_Macrocell, RejectsBadChildIndex)
+{
+    PatternText file("child.mc", "[M2] (golly 4.0)\n.*$..*$***$\n4 0 0 0 5\n");
+    EXPECT_THROW(PatternFile pattern(file.path), std::runtime_error);
+}
+
+TEST(PatternFile_Macrocell, RejectsBoundingBoxTooLargeToHold)
+{
+    // A cell in the north-west and south-east corners of every level up to
+    // 32, so the box is just over 2^31 cells a side
+    std::string text = "[M2] (golly 4.0)\n*$\n";
+    for (std::uint32_t level = 4; level <= 32; ++level)
+    {
+        std::string child = std::to_string(level - 3);
+        text += std::to_string(level) + ' ' + child + " 0 0 " + child + '\n';
+    }
+    PatternText file("huge.mc", text);
+    EXPECT_THROW(PatternFile pattern(file.path), std::runtime_error);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "LifeKernel.hpp"
+#include "Pattern.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Checks that two patterns are the same size and hold the same cells,
+// comparing them a row of words at a time. A mismatch ends the check; wrap
+// it in ASSERT_NO_FATAL_FAILURE to end the test there as well.
+inline void expectSameCells(const Pattern& expected, const Pattern& actual)
+{
+    ASSERT_EQ(expected.getSizeX(), actual.getSizeX());
+    ASSERT_EQ(expected.getSizeY(), actual.getSizeY());
+
+    std::vector<std::uint64_t> expectedRow(wordsForCells(expected.getSizeX()));
+    std::vector<std::uint64_t> actualRow(expectedRow.size());
+    for (std::uint32_t y = 0; y < expected.getSizeY(); ++y)
+    {
+        expected.getRow(y, expectedRow.data());
+        actual.getRow(y, actualRow.data());
+        ASSERT_EQ(expectedRow, actualRow) << "row " << y;
+    }
+}
+
+// A board of cells set one by one
+class Board : public Pattern
+{
+  public:
+    Board(std::uint32_t sizeX, std::uint32_t sizeY) :
+        sizeX(sizeX),
+        sizeY(sizeY),
+        cells(static_cast<std::size_t>(sizeX) * sizeY)
+    {
+    }
+
+    std::uint32_t getSizeX() const override { return sizeX; }
+    std::uint32_t getSizeY() const override { return sizeY; }
+    bool getCell(std::uint32_t x, std::uint32_t y) const override { return cells[static_cast<std::size_t>(y) * sizeX + x]; }
+
+    // Draws cells written as rows of 'O' and '.' split by '/', turned by
+    // orientation 0 to 7 and wrapped across the edges, from (x, y)
+    void draw(const char* pattern, std::uint32_t x, std::uint32_t y, std::uint32_t orientation = 0)
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> live;
+        std::uint32_t width = 0;
+        std::uint32_t height = 1;
+        std::uint32_t column = 0;
+        for (const char* c = pattern; *c; ++c)
+        {
+            if (*c == '/')
+            {
+                column = 0;
+                ++height;
+                continue;
+            }
+            if (*c == 'O')
+            {
+                live.emplace_back(column, height - 1);
+            }
+            width = std::max(width, ++column);
+        }
+
+        for (auto cell : live)
+        {
+            std::uint32_t cellX = cell.first;
+            std::uint32_t cellY = cell.second;
+            std::uint32_t turnedWidth = width;
+            std::uint32_t turnedHeight = height;
+            if (orientation & 1)
+            {
+                std::swap(cellX, cellY);
+                std::swap(turnedWidth, turnedHeight);
+            }
+            if (orientation & 2)
+            {
+                cellX = turnedWidth - 1 - cellX;
+            }
+            if (orientation & 4)
+            {
+                cellY = turnedHeight - 1 - cellY;
+            }
+            cells[static_cast<std::size_t>((y + cellY) % sizeY) * sizeX + (x + cellX) % sizeX] = true;
+        }
+    }
+
+    // Sets every cell of the width by height block from (x, y)
+    void fill(std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height)
+    {
+        for (std::uint32_t row = y; row < y + height; ++row)
+        {
+            for (std::uint32_t column = x; column < x + width; ++column)
+            {
+                cells[static_cast<std::size_t>(row) * sizeX + column] = true;
+            }
+        }
+    }
+
+  private:
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    std::vector<bool> cells;
+};
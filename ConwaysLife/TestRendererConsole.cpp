@@ -0,0 +1,91 @@
+#include "PatternCells.hpp"
+#include "RendererConsole.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Three rows of 40 cells, wide enough for the 30 character readout;
+    // rows shorter than the first are dead past their end
+    inline constexpr char EMPTY_BOARD[] = "........................................//";
+    inline constexpr char ONE_CELL[] = "........................................//...................................O";
+    inline constexpr char GAP_OF_SIX[] = "......................................../..........O......O/";
+    inline constexpr char GAP_OF_SEVEN[] = "......................................../..........O.......O/";
+
+    // What the first frame starts with: cursor hidden, screen cleared
+    const std::string FIRST_FRAME = "\x1b[?25l\x1b[2J";
+    const std::string MOVE_HOME = "\x1b[1;1H";
+    const std::size_t READOUT_WIDTH = 30;
+
+    // The bytes of each frame, one write apiece, kept off the real terminal
+    // along with the renderer's last write
+    std::vector<std::string> renderFrames(const std::vector<const Pattern*>& frames)
+    {
+        std::vector<std::string> written;
+        testing::internal::CaptureStdout();
+        {
+            RendererConsole renderer;
+            testing::internal::GetCapturedStdout();
+            for (const Pattern* cells : frames)
+            {
+                testing::internal::CaptureStdout();
+                renderer.render(*cells);
+                written.push_back(testing::internal::GetCapturedStdout());
+            }
+            testing::internal::CaptureStdout();
+        }
+        testing::internal::GetCapturedStdout();
+        return written;
+    }
+
+    // Checks that a frame ends in the readout, counting the frame's own
+    // bytes, and returns what comes before it
+    std::string withoutReadout(const std::string& frame)
+    {
+        std::size_t readoutSize = MOVE_HOME.size() + READOUT_WIDTH;
+        if (frame.size() < readoutSize)
+        {
+            ADD_FAILURE() << "frame too short for the readout: " << frame.size() << " bytes";
+            return frame;
+        }
+
+        std::string readout = frame.substr(frame.size() - readoutSize);
+        EXPECT_EQ(MOVE_HOME, readout.substr(0, MOVE_HOME.size()));
+        double framesPerSecond = 0.0;
+        std::size_t bytes = 0;
+        EXPECT_EQ(2, std::sscanf(readout.c_str() + MOVE_HOME.size(), "%lf fps %zu B/frame", &framesPerSecond, &bytes)) << readout;
+        EXPECT_EQ(frame.size(), bytes);
+        return frame.substr(0, frame.size() - readoutSize);
+    }
+}
+
+TEST(RendererConsole_Render, RedrawsOnlyChangedCell)
+{
+    PatternCells<EMPTY_BOARD> empty;
+    PatternCells<ONE_CELL> oneCell;
+    std::vector<std::string> frames = renderFrames({ &empty, &oneCell });
+    ASSERT_EQ(2, frames.size());
+
+    EXPECT_EQ(FIRST_FRAME, withoutReadout(frames[0]));
+    EXPECT_EQ("\x1b[3;36HX", withoutReadout(frames[1]));
+}
+
+TEST(RendererConsole_Render, RewritesShortGapsInsteadOfMovingCursor)
+{
+    PatternCells<EMPTY_BOARD> empty;
+    PatternCells<GAP_OF_SIX> gapOfSix;
+    PatternCells<GAP_OF_SEVEN> gapOfSeven;
+
+    // Six unchanged cells between the two are written out again, seven are
+    // stepped over with a cursor move
+    std::vector<std::string> frames = renderFrames({ &empty, &gapOfSix });
+    ASSERT_EQ(2, frames.size());
+    EXPECT_EQ("\x1b[2;11HX      X", withoutReadout(frames[1]));
+
+    frames = renderFrames({ &empty, &gapOfSeven });
+    ASSERT_EQ(2, frames.size());
+    EXPECT_EQ("\x1b[2;11HX\x1b[2;19HX", withoutReadout(frames[1]));
+}
@@ -0,0 +1,134 @@
+#include "PatternCells.hpp"
+#include "RendererDownsampled.hpp"
+#include "TestPatterns.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace
+{
+    // One cell above another, each a dot of one half block character
+    inline constexpr char EMPTY_CELLS[] = "./.";
+    inline constexpr char TOP_CELLS[] = "O/.";
+    inline constexpr char BOTTOM_CELLS[] = "./O";
+    inline constexpr char BOTH_CELLS[] = "O/O";
+
+    // What the first frame starts with: cursor hidden, colors reset, screen cleared, cursor home
+    const std::string FIRST_FRAME = "\x1b[?25l\x1b[0m\x1b[2J\x1b[1;1H";
+    // What the renderer leaves behind: colors reset, cursor below the picture and shown again
+    const std::string LAST_WRITE = "\x1b[0m\x1b[2;1H\x1b[?25h";
+    // The shade of a full block, the last of the gray ramp
+    const std::string FULL_FOREGROUND = "\x1b[38;5;255m";
+    const std::string FULL_BACKGROUND = "\x1b[48;5;255m";
+    const std::string UPPER_HALF_BLOCK = "\xe2\x96\x80";
+    const std::string LOWER_HALF_BLOCK = "\xe2\x96\x84";
+
+    std::string foreground(std::uint32_t color)
+    {
+        return "\x1b[38;5;" + std::to_string(color) + 'm';
+    }
+
+    // U+2800 plus the dot bits, in UTF-8
+    std::string braille(std::uint32_t dots)
+    {
+        std::uint32_t codePoint = 0x2800 + dots;
+        return { static_cast<char>(0xE0 | (codePoint >> 12)), static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)), static_cast<char>(0x80 | (codePoint & 0x3F)) };
+    }
+
+    // The bytes of the one frame of a terminal one character high showing
+    // the pattern, kept off the real terminal along with the renderer's last
+    // write
+    std::string renderFrame(const Pattern& cells, std::uint32_t columns, RendererDownsampled::Glyphs glyphs, std::uint32_t x, std::uint32_t y, std::uint32_t zoom)
+    {
+        testing::internal::CaptureStdout();
+        {
+            RendererDownsampled renderer(columns, 1, glyphs);
+            renderer.setViewport(x, y, zoom);
+            renderer.render(cells);
+        }
+        std::string written = testing::internal::GetCapturedStdout();
+        EXPECT_EQ(LAST_WRITE, written.substr(written.size() - std::min(written.size(), LAST_WRITE.size())));
+        return written.substr(0, written.size() - std::min(written.size(), LAST_WRITE.size()));
+    }
+
+    std::string renderHalfBlock(const Pattern& cells)
+    {
+        return renderFrame(cells, 1, RendererDownsampled::Glyphs::HalfBlock, 0, 0, 1);
+    }
+}
+
+TEST(RendererDownsampled_HalfBlock, LeavesEmptyDotsToDefaultBackground)
+{
+    EXPECT_EQ(FIRST_FRAME + " ", renderHalfBlock(PatternCells<EMPTY_CELLS>()));
+    EXPECT_EQ(FIRST_FRAME + FULL_FOREGROUND + "\x1b[49m" + UPPER_HALF_BLOCK, renderHalfBlock(PatternCells<TOP_CELLS>()));
+    EXPECT_EQ(FIRST_FRAME + FULL_FOREGROUND + "\x1b[49m" + LOWER_HALF_BLOCK, renderHalfBlock(PatternCells<BOTTOM_CELLS>()));
+    EXPECT_EQ(FIRST_FRAME + FULL_FOREGROUND + FULL_BACKGROUND + UPPER_HALF_BLOCK, renderHalfBlock(PatternCells<BOTH_CELLS>()));
+}
+
+TEST(RendererDownsampled_HalfBlock, ShadesByLiveCellsAcrossWordEdge)
+{
+    // At 40 cells to a dot, the second column's dots span cells 40 to 79, so
+    // each row of them is cut into two pieces at the word edge at 64
+    Board board(80, 80);
+    // 80 of the top dot's 1600 cells, half on each side of the edge
+    board.fill(60, 0, 8, 10);
+    // The whole bottom dot
+    board.fill(40, 40, 40, 40);
+
+    // 232 + ceil(80 * 23 / 1600) over the gray ramp's end; the first column is empty
+    std::string expected = FIRST_FRAME + " " + foreground(234) + FULL_BACKGROUND + UPPER_HALF_BLOCK;
+    EXPECT_EQ(expected, renderFrame(board, 2, RendererDownsampled::Glyphs::HalfBlock, 0, 0, 40));
+}
+
+TEST(RendererDownsampled_HalfBlock, FitsBoardToTerminalAtZoomZero)
+{
+    // Two characters of two dots take a 10 by 6 board at 5 cells to a dot,
+    // enough for the wider side; the bottom dots hold just row 5
+    Board board(10, 6);
+    board.fill(0, 0, 1, 1);
+    board.fill(9, 5, 1, 1);
+
+    // One cell of 25 is 232 + ceil(23 / 25)
+    std::string oneCell = foreground(233) + "\x1b[49m";
+    std::string expected = FIRST_FRAME + oneCell + UPPER_HALF_BLOCK + oneCell + LOWER_HALF_BLOCK;
+    EXPECT_EQ(expected, renderFrame(board, 2, RendererDownsampled::Glyphs::HalfBlock, 0, 0, 0));
+}
+
+TEST(RendererDownsampled_Braille, MapsEachCellToItsDot)
+{
+    // Dots 1 to 8 of the Unicode Braille patterns, numbered down the left
+    // column and then the right, with the bottom row last
+    struct Dot
+    {
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t bit;
+    };
+    const Dot dots[] = { { 0, 0, 0x01 }, { 0, 1, 0x02 }, { 0, 2, 0x04 }, { 1, 0, 0x08 }, { 1, 1, 0x10 }, { 1, 2, 0x20 }, { 0, 3, 0x40 }, { 1, 3, 0x80 } };
+
+    EXPECT_EQ(FIRST_FRAME + braille(0), renderFrame(Board(2, 4), 1, RendererDownsampled::Glyphs::Braille, 0, 0, 1));
+    for (const Dot& dot : dots)
+    {
+        SCOPED_TRACE("cell " + std::to_string(dot.x) + ", " + std::to_string(dot.y));
+        Board board(2, 4);
+        board.fill(dot.x, dot.y, 1, 1);
+        EXPECT_EQ(FIRST_FRAME + braille(dot.bit), renderFrame(board, 1, RendererDownsampled::Glyphs::Braille, 0, 0, 1));
+    }
+}
+
+TEST(RendererDownsampled_Braille, ShowsViewportOffsetWithinWord)
+{
+    // The viewport's 2 by 4 cells start at (100, 5), in the middle of the
+    // second word of each row. Its cells, and those just around it.
+    Board board(200, 20);
+    board.fill(101, 6, 1, 1);
+    board.fill(100, 8, 1, 1);
+    board.fill(99, 5, 1, 1);
+    board.fill(102, 5, 1, 1);
+    board.fill(100, 4, 1, 1);
+    board.fill(101, 9, 1, 1);
+
+    EXPECT_EQ(FIRST_FRAME + braille(0x10 | 0x40), renderFrame(board, 1, RendererDownsampled::Glyphs::Braille, 100, 5, 1));
+}
@@ -0,0 +1,89 @@
+#include "LifeSimulator.hpp"
+#include "PatternSoup.hpp"
+#include "SoupGenerator.hpp"
+#include "TestPatterns.hpp"
+
+#include "gtest/gtest.h"
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // fillSoup() draws a tile at a time, each tile from its own counters,
+    // so the board is two tiles and a part across, ending mid-word, and four
+    // and a part down: a part tile must draw what a whole one would there
+    const std::uint32_t SIZE_X = 2 * TILE_WORDS * CELLS_PER_WORD + 3 * CELLS_PER_WORD / 2;
+    const std::uint32_t SIZE_Y = 4 * TILE_ROWS + TILE_ROWS / 2;
+    const std::uint64_t SEED = 42;
+
+    const std::size_t DENSITY_WORDS = 1 << 15;
+    // Over two million cells the measured density is within about 0.0003
+    // of the true one, so this is many standard deviations out
+    const double DENSITY_TOLERANCE = 0.003;
+}
+
+TEST(LifeSimulator_FillSoup, GivesSameBoardOnAnyThreadCount)
+{
+    for (double density : { 0.5, 0.3 })
+    {
+        SCOPED_TRACE("density " + std::to_string(density));
+        SoupGenerator soup(SEED, density);
+        LifeSimulator single(SIZE_X, SIZE_Y);
+        single.setThreadCount(1);
+        single.fillSoup(soup);
+        LifeSimulator several(SIZE_X, SIZE_Y);
+        several.setThreadCount(4);
+        several.fillSoup(soup);
+        // The same soup read a row at a time, with no tiles at all
+        LifeSimulator inserted(SIZE_X, SIZE_Y);
+        inserted.insertPattern(PatternSoup(SIZE_X, SIZE_Y, SEED, density), 0, 0);
+
+        ASSERT_NO_FATAL_FAILURE(expectSameCells(single, several));
+        ASSERT_NO_FATAL_FAILURE(expectSameCells(single, inserted));
+        EXPECT_EQ(single.getPopulation(), several.getPopulation());
+        EXPECT_EQ(single.getPopulation(), inserted.getPopulation());
+    }
+
+    // Another seed gives another soup
+    LifeSimulator first(SIZE_X, SIZE_Y);
+    first.fillSoup(SoupGenerator(SEED));
+    LifeSimulator second(SIZE_X, SIZE_Y);
+    second.fillSoup(SoupGenerator(SEED + 1));
+    EXPECT_NE(first.getHash(), second.getHash());
+}
+
+TEST(SoupGenerator_Fill, DrawsAnyStretchTheSame)
+{
+    SoupGenerator soup(SEED, 0.25);
+    std::vector<std::uint64_t> whole(1000);
+    soup.fill(whole.data(), 0, whole.size());
+
+    // In pieces, last piece first
+    const std::size_t cuts[] = { 0, 1, 333, 700, 1000 };
+    std::vector<std::uint64_t> pieces(whole.size());
+    for (std::size_t piece = std::size(cuts) - 1; piece-- > 0;)
+    {
+        soup.fill(pieces.data() + cuts[piece], cuts[piece], cuts[piece + 1] - cuts[piece]);
+    }
+    EXPECT_EQ(whole, pieces);
+}
+
+TEST(SoupGenerator_Fill, DrawsCellsAtDensity)
+{
+    for (double density : { 0.5, 0.1, 0.37, 0.9 })
+    {
+        SCOPED_TRACE("density " + std::to_string(density));
+        SoupGenerator soup(SEED, density);
+        EXPECT_NEAR(density, soup.getDensity(), 1.0 / 65536);
+
+        std::vector<std::uint64_t> words(DENSITY_WORDS);
+        soup.fill(words.data(), 0, words.size());
+        std::uint64_t alive = 0;
+        for (std::uint64_t word : words)
+        {
+            alive += countSetBits(word);
+        }
+        EXPECT_NEAR(density, double(alive) / (DENSITY_WORDS * CELLS_PER_WORD), DENSITY_TOLERANCE);
+    }
+}
@@ -0,0 +1,118 @@
+#include "LifeSimulator.hpp"
+#include "PatternCells.hpp"
+#include "UnboundedLife.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    // A glider heading up and left, and the R-pentomino, which throws out
+    // gliders every way before it settles
+    inline constexpr char NORTH_WEST_GLIDER_CELLS[] = "OOO/O../.O.";
+    inline constexpr char R_PENTOMINO_CELLS[] = ".OO/OO./.O.";
+    // Dies out after 130 generations
+    inline constexpr char DIEHARD_CELLS[] = "......O./OO....../.O...OOO";
+    const std::uint64_t DIEHARD_LIFETIME = 130;
+
+    // The torus the plane is checked against, big enough that nothing in
+    // the generations below wraps, and where the plane's window sits on it
+    const std::uint32_t TORUS_SIZE = 1024;
+    const std::uint32_t WINDOW_SIZE = 256;
+    const std::uint32_t WINDOW_OFFSET = 400;
+    const std::uint32_t START = 100;
+
+    const std::uint64_t GLIDER_GENERATIONS = 400;
+    const std::uint64_t R_PENTOMINO_GENERATIONS = 1000;
+    const std::uint64_t WINDOW_CHECK_INTERVAL = 50;
+    // Generations between trims of UnboundedLife's tile pool
+    const std::uint64_t TRIM_INTERVAL = 1024;
+
+    void expectSameWindow(const UnboundedLife& plane, const LifeSimulator& torus)
+    {
+        for (std::uint32_t y = 0; y < plane.getSizeY(); ++y)
+        {
+            for (std::uint32_t x = 0; x < plane.getSizeX(); ++x)
+            {
+                ASSERT_EQ(torus.getCell(x + WINDOW_OFFSET, y + WINDOW_OFFSET), plane.getCell(x, y)) << "cell " << x << ", " << y;
+            }
+        }
+    }
+
+    // Steps the pattern on the plane and on the torus, comparing the live
+    // cells everywhere by count and those in the window cell by cell
+    void compareWithTorus(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY, std::uint64_t generations)
+    {
+        UnboundedLife plane(WINDOW_SIZE, WINDOW_SIZE);
+        LifeSimulator torus(TORUS_SIZE, TORUS_SIZE);
+        plane.insertPattern(pattern, startX, startY);
+        torus.insertPattern(pattern, startX + WINDOW_OFFSET, startY + WINDOW_OFFSET);
+
+        for (std::uint64_t generation = 1; generation <= generations; ++generation)
+        {
+            SCOPED_TRACE("generation " + std::to_string(generation));
+            plane.update();
+            torus.update();
+            ASSERT_EQ(torus.getPopulation(), plane.getPopulation());
+            if (generation % WINDOW_CHECK_INTERVAL == 0)
+            {
+                ASSERT_NO_FATAL_FAILURE(expectSameWindow(plane, torus));
+            }
+        }
+    }
+}
+
+TEST(UnboundedLife_Update, StepsGliderIntoNegativeTiles)
+{
+    // It leaves the window within a few generations, and from then on
+    // lives only in tiles left of and above it
+    compareWithTorus(PatternCells<NORTH_WEST_GLIDER_CELLS>(), 1, 1, GLIDER_GENERATIONS);
+
+    // Tiles it leaves behind are freed, so it never holds more than the four it may straddle
+    UnboundedLife plane(WINDOW_SIZE, WINDOW_SIZE);
+    plane.insertPattern(PatternCells<NORTH_WEST_GLIDER_CELLS>(), 1, 1);
+    for (std::uint64_t generation = 0; generation < GLIDER_GENERATIONS; ++generation)
+    {
+        plane.update();
+        ASSERT_EQ(5, plane.getPopulation());
+        ASSERT_LE(plane.getTileCount(), 4);
+    }
+}
+
+TEST(UnboundedLife_Update, MatchesTorusForRPentomino)
+{
+    compareWithTorus(PatternCells<R_PENTOMINO_CELLS>(), START, START, R_PENTOMINO_GENERATIONS);
+}
+
+TEST(UnboundedLife_Update, FreesTilesOncePatternDiesOut)
+{
+    // Diehards spread over more tiles than one chunk of the pool holds
+    const std::uint32_t spacing = 128;
+    const std::uint32_t size = 1024;
+    UnboundedLife plane(size, size);
+    for (std::uint32_t y = spacing / 2; y < size; y += spacing)
+    {
+        for (std::uint32_t x = spacing / 2; x < size; x += spacing)
+        {
+            plane.insertPattern(PatternCells<DIEHARD_CELLS>(), x, y);
+        }
+    }
+
+    std::size_t peakTiles = 0;
+    std::size_t peakMemory = 0;
+    for (std::uint64_t generation = 0; generation < DIEHARD_LIFETIME; ++generation)
+    {
+        plane.update();
+        peakTiles = std::max(peakTiles, plane.getTileCount());
+        peakMemory = std::max(peakMemory, plane.getMemoryUsage());
+    }
+    EXPECT_LT(32, peakTiles);
+    EXPECT_EQ(0, plane.getPopulation());
+    EXPECT_EQ(0, plane.getTileCount());
+
+    // The pool keeps the empty tiles until its next trim hands them back
+    plane.advance(TRIM_INTERVAL - DIEHARD_LIFETIME);
+    EXPECT_EQ(0, plane.getTileCount());
+    EXPECT_LT(plane.getMemoryUsage() * 4, peakMemory);
+}
@@ -0,0 +1,145 @@
+#include "UpdateProfile.hpp"
+
+#if defined(LIFE_INSTRUMENTATION)
+    #include "LifeSimulator.hpp"
+    #include "SoupGenerator.hpp"
+#endif
+
+#include "gtest/gtest.h"
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // Two generations of known tile times and cell counts
+    UpdateProfile makeProfile()
+    {
+        UpdateProfile profile;
+        profile.startGeneration();
+        profile.addTime(UpdatePhase::Kernel, 100);
+        profile.addTime(UpdatePhase::Kernel, 50);
+        profile.addCells(10, 2);
+        profile.addCells(5, 1);
+        profile.endGeneration();
+
+        profile.startGeneration();
+        profile.addTime(UpdatePhase::Kernel, 30);
+        profile.addCells(7, 4);
+        profile.endGeneration();
+        return profile;
+    }
+
+    void expectSeries(std::uint64_t total, std::uint64_t max, const UpdateProfile::Series& series)
+    {
+        EXPECT_EQ(total, series.total);
+        EXPECT_EQ(max, series.max);
+    }
+}
+
+TEST(UpdateProfile_EndGeneration, SumsTotalsAndKeepsMaxima)
+{
+    UpdateProfile profile = makeProfile();
+
+    EXPECT_EQ(2, profile.getGenerations());
+    expectSeries(180, 150, profile.getPhase(UpdatePhase::Kernel));
+    expectSeries(22, 15, profile.getCellsEvaluated());
+    expectSeries(7, 4, profile.getCellsChanged());
+    expectSeries(0, 0, profile.getPhase(UpdatePhase::Survey));
+}
+
+TEST(UpdateProfile_Lap, SplitsUpdateTimeBetweenPhases)
+{
+    UpdateProfile profile;
+    profile.startGeneration();
+    profile.lap(UpdatePhase::Tiles);
+    profile.lap(UpdatePhase::Halo);
+    profile.endGeneration();
+
+    // The laps follow one another within the update, with no overlap
+    std::uint64_t lapped = profile.getPhase(UpdatePhase::Tiles).total + profile.getPhase(UpdatePhase::Halo).total;
+    EXPECT_LE(lapped, profile.getUpdateTime().total);
+    EXPECT_EQ(profile.getUpdateTime().total, profile.getUpdateTime().max);
+    expectSeries(0, 0, profile.getPhase(UpdatePhase::Prepare));
+}
+
+TEST(UpdateProfile_Reset, ForgetsEveryGeneration)
+{
+    UpdateProfile profile = makeProfile();
+    profile.reset();
+
+    EXPECT_EQ(0, profile.getGenerations());
+    for (std::size_t phase = 0; phase < static_cast<std::size_t>(UpdatePhase::Count); ++phase)
+    {
+        SCOPED_TRACE(UpdateProfile::getPhaseName(static_cast<UpdatePhase>(phase)));
+        expectSeries(0, 0, profile.getPhase(static_cast<UpdatePhase>(phase)));
+    }
+    expectSeries(0, 0, profile.getUpdateTime());
+    expectSeries(0, 0, profile.getCellsEvaluated());
+    expectSeries(0, 0, profile.getCellsChanged());
+    expectSeries(0, 0, profile.getAllocations());
+}
+
+TEST(UpdateProfile_WriteJson, WritesEverySeriesWithMean)
+{
+    std::ostringstream out;
+    makeProfile().writeJson(out);
+    std::string json = out.str();
+
+    EXPECT_NE(std::string::npos, json.find("\"generations\": 2,")) << json;
+    EXPECT_NE(std::string::npos, json.find("\"kernel\": {\"total\": 180, \"max\": 150, \"mean\": 90}")) << json;
+    EXPECT_NE(std::string::npos, json.find("\"cellsEvaluated\": {\"total\": 22, \"max\": 15, \"mean\": 11}")) << json;
+    EXPECT_NE(std::string::npos, json.find("\"survey\": {\"total\": 0, \"max\": 0, \"mean\": 0}")) << json;
+    for (std::size_t phase = 0; phase < static_cast<std::size_t>(UpdatePhase::Count); ++phase)
+    {
+        EXPECT_NE(std::string::npos, json.find(std::string("\"") + UpdateProfile::getPhaseName(static_cast<UpdatePhase>(phase)) + "\": {")) << json;
+    }
+    EXPECT_EQ('{', json.front());
+    EXPECT_EQ("}\n", json.substr(json.size() - 2));
+}
+
+TEST(UpdateProfile_WriteCsv, WritesHeaderThenLinePerSeries)
+{
+    std::ostringstream out;
+    makeProfile().writeCsv(out);
+    std::istringstream in(out.str());
+
+    std::string line;
+    ASSERT_TRUE(std::getline(in, line));
+    EXPECT_EQ("name,unit,total,max,mean", line);
+    ASSERT_TRUE(std::getline(in, line));
+    EXPECT_EQ("generations,generations,2,1,1", line);
+
+    // The update, every phase, then the three counters
+    std::size_t lines = 0;
+    bool kernel = false;
+    bool cellsEvaluated = false;
+    while (std::getline(in, line))
+    {
+        ++lines;
+        kernel = kernel || line == "kernel,ns,180,150,90";
+        cellsEvaluated = cellsEvaluated || line == "cellsEvaluated,cells,22,15,11";
+    }
+    EXPECT_EQ(1 + static_cast<std::size_t>(UpdatePhase::Count) + 3, lines);
+    EXPECT_TRUE(kernel);
+    EXPECT_TRUE(cellsEvaluated);
+}
+
+#if defined(LIFE_INSTRUMENTATION)
+TEST(LifeSimulator_GetProfile, RecordsEachGeneration)
+{
+    const std::uint64_t generations = 20;
+    LifeSimulator sim(1024, 1024);
+    sim.fillSoup(SoupGenerator(1));
+    sim.update();
+    sim.resetProfile();
+
+    sim.advance(generations);
+
+    const UpdateProfile& profile = sim.getProfile();
+    EXPECT_EQ(generations, profile.getGenerations());
+    EXPECT_GT(profile.getPhase(UpdatePhase::Kernel).total, 0u);
+    EXPECT_GT(profile.getPhase(UpdatePhase::Tiles).total, 0u);
+    EXPECT_GT(profile.getCellsEvaluated().total, 0u);
+    EXPECT_EQ(0, profile.getAllocations().total);
+}
+#endif
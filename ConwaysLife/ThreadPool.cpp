@@ -0,0 +1,135 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threadCount) :
+    queues(threadCount ? threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1))
+{
+    // The calling thread is thread 0, so only the rest need starting
+    for (std::size_t thread = 1; thread < queues.size(); ++thread)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::getThreadCount() const
+{
+    return queues.size();
+}
+
+void ThreadPool::run(std::size_t taskCount, TaskBody body)
+{
+    // Deal out contiguous ranges, so neighboring tasks start on the same thread
+    std::size_t threadCount = queues.size();
+    for (std::size_t thread = 0; thread < threadCount; ++thread)
+    {
+        std::lock_guard<std::mutex> lock(queues[thread].mutex);
+        queues[thread].begin = taskCount * thread / threadCount;
+        queues[thread].end = taskCount * (thread + 1) / threadCount;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->body = body;
+        busyWorkers = workers.size();
+        ++round;
+    }
+    wakeWorkers.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    workersDone.wait(lock, [this]() { return busyWorkers == 0; });
+    this->body = { nullptr, nullptr };
+}
+
+void ThreadPool::workerLoop(std::size_t thread)
+{
+    std::uint64_t lastRound = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [this, lastRound]() { return stopping || round != lastRound; });
+            if (stopping)
+            {
+                return;
+            }
+            lastRound = round;
+        }
+
+        runTasks(thread);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0)
+        {
+            workersDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runTasks(std::size_t thread)
+{
+    std::size_t task;
+    while (popTask(thread, task) || (stealTasks(thread) && popTask(thread, task)))
+    {
+        body.call(body.body, task, thread);
+    }
+}
+
+bool ThreadPool::popTask(std::size_t thread, std::size_t& task)
+{
+    TaskQueue& queue = queues[thread];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.begin == queue.end)
+    {
+        return false;
+    }
+
+    task = queue.begin++;
+    return true;
+}
+
+bool ThreadPool::stealTasks(std::size_t thread)
+{
+    std::size_t threadCount = queues.size();
+    for (std::size_t offset = 1; offset < threadCount; ++offset)
+    {
+        // Take the back half of the victim's remaining range
+        TaskQueue& victim = queues[(thread + offset) % threadCount];
+        std::size_t begin;
+        std::size_t end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin == victim.end)
+            {
+                continue;
+            }
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        TaskQueue& queue = queues[thread];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.begin = begin;
+        queue.end = end;
+        return true;
+    }
+
+    return false;
+}
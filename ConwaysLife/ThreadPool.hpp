@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run indexed tasks in parallel. Each
+// parallelFor() call deals the task range out across per-thread queues;
+// a thread that drains its own queue steals the back half of another's, so
+// uneven tasks still balance out. Threads only meet when the call returns.
+class ThreadPool
+{
+  public:
+    // threadCount includes the thread calling parallelFor(); 0 uses one per hardware thread
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t getThreadCount() const;
+
+    // Runs body(task, thread) for every task in [0, taskCount), where thread
+    // is in [0, getThreadCount()), and returns once all tasks have finished
+    template <typename Body>
+    void parallelFor(std::size_t taskCount, const Body& body)
+    {
+        run(taskCount, { &callBody<Body>, &body });
+    }
+
+  private:
+    // Non-owning reference to the caller's task function, so handing one to
+    // the workers never allocates
+    struct TaskBody
+    {
+        void (*call)(const void* body, std::size_t task, std::size_t thread);
+        const void* body;
+    };
+
+    template <typename Body>
+    static void callBody(const void* body, std::size_t task, std::size_t thread)
+    {
+        (*static_cast<const Body*>(body))(task, thread);
+    }
+
+    // Remaining tasks [begin, end) of one thread, on its own cache line
+    struct alignas(64) TaskQueue
+    {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<TaskQueue> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    std::uint64_t round = 0;
+    std::size_t busyWorkers = 0;
+    bool stopping = false;
+    TaskBody body = { nullptr, nullptr };
+
+    void run(std::size_t taskCount, TaskBody body);
+    void workerLoop(std::size_t thread);
+    void runTasks(std::size_t thread);
+    bool popTask(std::size_t thread, std::size_t& task);
+    bool stealTasks(std::size_t thread);
+};
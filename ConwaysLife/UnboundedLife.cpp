@@ -0,0 +1,475 @@
+#include "UnboundedLife.hpp"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+    const std::size_t TILES_PER_CHUNK = 16;
+    const std::size_t INITIAL_TABLE_SIZE = 64;
+    // How often chunks the pattern has moved away from go back to the heap
+    const std::uint64_t TRIM_INTERVAL = 1024;
+
+    const std::uint8_t STEP_CHANGED = 1;
+    const std::uint8_t STEP_EMPTY = 2;
+
+    std::size_t hashTile(std::int64_t tileX, std::int64_t tileY)
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(tileX) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<std::uint64_t>(tileY) * 0xC2B2AE3D27D4EB4Full;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+}
+
+UnboundedLife::UnboundedLife(std::uint32_t sizeX, std::uint32_t sizeY) :
+    sizeX(sizeX),
+    sizeY(sizeY),
+    bitRule({ rule.getBirthMask(), rule.getSurvivalMask() }),
+    spanKernel(selectSpanKernel(bitRule)),
+    pool((sizeof(Tile) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t), TILES_PER_CHUNK),
+    table(INITIAL_TABLE_SIZE, nullptr)
+{
+}
+
+void UnboundedLife::insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY)
+{
+    if (!sizeX || !sizeY)
+    {
+        return;
+    }
+
+    startX = std::min(startX, sizeX - 1);
+    startY = std::min(startY, sizeY - 1);
+    std::uint32_t endX = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(startX) + pattern.getSizeX(), sizeX));
+    std::uint32_t endY = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(startY) + pattern.getSizeY(), sizeY));
+    const std::size_t TILE_CELLS = TILE_WORDS * CELLS_PER_WORD;
+
+    std::vector<std::uint64_t> row(wordsForCells(pattern.getSizeX()));
+    for (auto y = startY; y < endY; ++y)
+    {
+        pattern.getRow(y - startY, row.data());
+        for (std::uint32_t x = startX; x < endX;)
+        {
+            std::int64_t tileX = x / TILE_CELLS;
+            std::size_t bit = x % TILE_CELLS;
+            std::size_t length = std::min<std::size_t>(TILE_CELLS - bit, endX - x);
+
+            // Dead cells overwrite an existing tile, but only live ones make a new tile
+            std::uint64_t span[TILE_WORDS] = {};
+            copyBits(span, bit, row.data(), x - startX, length);
+            Tile* tile = findTile(tileX, y / TILE_ROWS);
+            if (!tile && std::any_of(span, span + TILE_WORDS, [](std::uint64_t word) { return word != 0; }))
+            {
+                tile = addTile(tileX, y / TILE_ROWS);
+            }
+            if (tile)
+            {
+                copyBits(tile->getRow(y % TILE_ROWS), bit, span, bit, length);
+                wake(tile);
+            }
+            x += static_cast<std::uint32_t>(length);
+        }
+    }
+}
+
+void UnboundedLife::update()
+{
+    // Tiles that births next to an awake tile may reach are added first, so
+    // they are stepped along with it
+    std::size_t tileCount = tiles.size();
+    for (std::size_t i = 0; i < tileCount; ++i)
+    {
+        if (tiles[i]->awake)
+        {
+            growAround(*tiles[i]);
+        }
+    }
+
+    // Every halo is filled before any tile changes, so each tile can then be
+    // stepped in place from its own words
+    stepped.clear();
+    for (Tile* tile : tiles)
+    {
+        if (tile->awake)
+        {
+            stepped.push_back(tile);
+            fillHalo(*tile);
+        }
+    }
+
+    stepResults.resize(stepped.size());
+    for (std::size_t i = 0; i < stepped.size(); ++i)
+    {
+        stepResults[i] = stepTile(*stepped[i]);
+        stepped[i]->awake = false;
+    }
+
+    // Changes wake their neighborhood for the next generation; empty tiles
+    // are freed only after that, so the neighbors of one that died out wake too
+    for (std::size_t i = 0; i < stepped.size(); ++i)
+    {
+        if (stepResults[i] & STEP_CHANGED)
+        {
+            wake(stepped[i]);
+        }
+    }
+    for (std::size_t i = 0; i < stepped.size(); ++i)
+    {
+        if (stepResults[i] & STEP_EMPTY)
+        {
+            removeTile(stepped[i]);
+        }
+    }
+
+    ++generation;
+    if (generation % TRIM_INTERVAL == 0 && pool.getFreeCount() > pool.getUsedCount())
+    {
+        pool.trim();
+    }
+}
+
+void UnboundedLife::advance(std::uint64_t generations)
+{
+    step(generations, StepControl());
+}
+
+std::uint64_t UnboundedLife::step(std::uint64_t generations, const StepControl& control)
+{
+    std::uint64_t done = 0;
+    while (done < generations && !control.isCancelled())
+    {
+        std::uint64_t chunkEnd = done + control.getChunk(done, generations);
+        while (done < chunkEnd && !control.isCancelled())
+        {
+            UnboundedLife::update();
+            ++done;
+        }
+        control.report(done);
+    }
+    return done;
+}
+
+std::uint64_t UnboundedLife::getGeneration() const
+{
+    return generation;
+}
+
+std::uint32_t UnboundedLife::getSizeX() const
+{
+    return sizeX;
+}
+
+std::uint32_t UnboundedLife::getSizeY() const
+{
+    return sizeY;
+}
+
+bool UnboundedLife::getCell(std::uint32_t x, std::uint32_t y) const
+{
+    const Tile* tile = findTile(x / (TILE_WORDS * CELLS_PER_WORD), y / TILE_ROWS);
+    if (!tile)
+    {
+        return false;
+    }
+
+    std::size_t bit = x % (TILE_WORDS * CELLS_PER_WORD);
+    return (tile->getRow(y % TILE_ROWS)[bit / CELLS_PER_WORD] >> (bit % CELLS_PER_WORD)) & 1;
+}
+
+void UnboundedLife::getRow(std::uint32_t y, std::uint64_t* words) const
+{
+    // The window starts on a tile boundary, so its words are the tiles' words
+    std::size_t wordCount = wordsForCells(sizeX);
+    for (std::size_t word = 0; word < wordCount; word += TILE_WORDS)
+    {
+        std::size_t count = std::min(TILE_WORDS, wordCount - word);
+        const Tile* tile = findTile(word / TILE_WORDS, y / TILE_ROWS);
+        if (tile)
+        {
+            const std::uint64_t* row = tile->getRow(y % TILE_ROWS);
+            std::copy(row, row + count, words + word);
+        }
+        else
+        {
+            std::fill(words + word, words + word + count, 0);
+        }
+    }
+    if (wordCount)
+    {
+        words[wordCount - 1] &= lastWordMask(sizeX);
+    }
+}
+
+std::uint64_t UnboundedLife::getPopulation() const
+{
+    std::uint64_t population = 0;
+    for (const Tile* tile : tiles)
+    {
+        for (std::size_t y = 0; y < TILE_ROWS; ++y)
+        {
+            const std::uint64_t* row = tile->getRow(y);
+            for (std::size_t word = 0; word < TILE_WORDS; ++word)
+            {
+                population += countSetBits(row[word]);
+            }
+        }
+    }
+    return population;
+}
+
+std::size_t UnboundedLife::getTileCount() const
+{
+    return tiles.size();
+}
+
+void UnboundedLife::setRule(const LifeRule& rule)
+{
+    if (rule.getRadius() != 1 || rule.getStateCount() != 2 || rule.isBorn(0))
+    {
+        throw std::invalid_argument("UnboundedLife cannot run rule " + rule.toString());
+    }
+
+    this->rule = rule;
+    bitRule = { rule.getBirthMask(), rule.getSurvivalMask() };
+    spanKernel = selectSpanKernel(bitRule);
+
+    // Still lifes under the old rule need not be under the new one
+    for (Tile* tile : tiles)
+    {
+        tile->awake = true;
+    }
+}
+
+const LifeRule& UnboundedLife::getRule() const
+{
+    return rule;
+}
+
+std::size_t UnboundedLife::getMemoryUsage() const
+{
+    return pool.getMemoryUsage() + (tiles.capacity() + table.capacity() + stepped.capacity()) * sizeof(Tile*) + stepResults.capacity();
+}
+
+UnboundedLife::Tile* UnboundedLife::findTile(std::int64_t tileX, std::int64_t tileY) const
+{
+    std::size_t mask = table.size() - 1;
+    for (std::size_t slot = hashTile(tileX, tileY) & mask; table[slot]; slot = (slot + 1) & mask)
+    {
+        if (table[slot]->tileX == tileX && table[slot]->tileY == tileY)
+        {
+            return table[slot];
+        }
+    }
+    return nullptr;
+}
+
+UnboundedLife::Tile* UnboundedLife::addTile(std::int64_t tileX, std::int64_t tileY)
+{
+    // Keep the table at most half full
+    if ((tiles.size() + 1) * 2 > table.size())
+    {
+        rebuildTable(table.size() * 2);
+    }
+
+    // Value-initialized, so every cell and the halo start out clear
+    Tile* tile = new (pool.allocate()) Tile();
+    tile->tileX = tileX;
+    tile->tileY = tileY;
+    tile->index = tiles.size();
+    tile->awake = true;
+    tiles.push_back(tile);
+
+    std::size_t mask = table.size() - 1;
+    std::size_t slot = hashTile(tileX, tileY) & mask;
+    while (table[slot])
+    {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = tile;
+    return tile;
+}
+
+void UnboundedLife::removeTile(Tile* tile)
+{
+    std::size_t mask = table.size() - 1;
+    std::size_t slot = hashTile(tile->tileX, tile->tileY) & mask;
+    while (table[slot] != tile)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    // Shift back any later tile of the probe run that would no longer be
+    // found past the hole, so no tombstones are needed
+    std::size_t hole = slot;
+    for (std::size_t next = (hole + 1) & mask; table[next]; next = (next + 1) & mask)
+    {
+        std::size_t home = hashTile(table[next]->tileX, table[next]->tileY) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = nullptr;
+
+    tiles[tile->index] = tiles.back();
+    tiles[tile->index]->index = tile->index;
+    tiles.pop_back();
+    pool.release(reinterpret_cast<std::uint64_t*>(tile));
+}
+
+void UnboundedLife::rebuildTable(std::size_t capacity)
+{
+    std::vector<Tile*>(capacity, nullptr).swap(table);
+
+    std::size_t mask = capacity - 1;
+    for (Tile* tile : tiles)
+    {
+        std::size_t slot = hashTile(tile->tileX, tile->tileY) & mask;
+        while (table[slot])
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = tile;
+    }
+}
+
+void UnboundedLife::wake(Tile* tile)
+{
+    for (std::int64_t dy = -1; dy <= 1; ++dy)
+    {
+        for (std::int64_t dx = -1; dx <= 1; ++dx)
+        {
+            if (Tile* neighbor = findTile(tile->tileX + dx, tile->tileY + dy))
+            {
+                neighbor->awake = true;
+            }
+        }
+    }
+}
+
+bool UnboundedLife::reaches(const Tile& tile, std::int64_t dx, std::int64_t dy) const
+{
+    // The row or column of cells along that side, or the cell in that corner
+    std::size_t beginY = dy > 0 ? TILE_ROWS - 1 : 0;
+    std::size_t endY = dy < 0 ? 1 : TILE_ROWS;
+    std::size_t beginWord = dx > 0 ? TILE_WORDS - 1 : 0;
+    std::size_t endWord = dx < 0 ? 1 : TILE_WORDS;
+    std::uint64_t mask = dx < 0 ? 1 : dx > 0 ? std::uint64_t(1) << (CELLS_PER_WORD - 1) : ~std::uint64_t(0);
+
+    for (std::size_t y = beginY; y < endY; ++y)
+    {
+        const std::uint64_t* row = tile.getRow(y);
+        for (std::size_t word = beginWord; word < endWord; ++word)
+        {
+            if (row[word] & mask)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void UnboundedLife::growAround(const Tile& tile)
+{
+    for (std::int64_t dy = -1; dy <= 1; ++dy)
+    {
+        for (std::int64_t dx = -1; dx <= 1; ++dx)
+        {
+            std::int64_t tileX = tile.tileX + dx;
+            std::int64_t tileY = tile.tileY + dy;
+            if ((!dx && !dy) || findTile(tileX, tileY))
+            {
+                continue;
+            }
+
+            // Births there may need cells of a sleeping tile on its far side
+            // as well, so every tile next to it is asked
+            bool reached = false;
+            for (std::int64_t ny = -1; ny <= 1 && !reached; ++ny)
+            {
+                for (std::int64_t nx = -1; nx <= 1 && !reached; ++nx)
+                {
+                    const Tile* neighbor = (nx || ny) ? findTile(tileX + nx, tileY + ny) : nullptr;
+                    reached = neighbor && reaches(*neighbor, -nx, -ny);
+                }
+            }
+            if (reached)
+            {
+                addTile(tileX, tileY);
+            }
+        }
+    }
+}
+
+void UnboundedLife::fillHalo(Tile& tile) const
+{
+    const Tile* neighbors[3][3];
+    for (std::int64_t dy = -1; dy <= 1; ++dy)
+    {
+        for (std::int64_t dx = -1; dx <= 1; ++dx)
+        {
+            neighbors[dy + 1][dx + 1] = findTile(tile.tileX + dx, tile.tileY + dy);
+        }
+    }
+
+    // Rows above and below, corners included
+    const std::size_t LAST_ROW = TILE_ROWS - 1;
+    const std::size_t LAST_WORD = TILE_WORDS - 1;
+    for (std::int64_t dy : { -1, 1 })
+    {
+        std::uint64_t* halo = tile.getRow(dy < 0 ? -1 : std::int64_t(TILE_ROWS));
+        std::size_t sourceY = dy < 0 ? LAST_ROW : 0;
+        const Tile* west = neighbors[dy + 1][0];
+        const Tile* middle = neighbors[dy + 1][1];
+        const Tile* east = neighbors[dy + 1][2];
+        halo[-1] = west ? west->getRow(sourceY)[LAST_WORD] : 0;
+        for (std::size_t word = 0; word < TILE_WORDS; ++word)
+        {
+            halo[word] = middle ? middle->getRow(sourceY)[word] : 0;
+        }
+        halo[TILE_WORDS] = east ? east->getRow(sourceY)[0] : 0;
+    }
+
+    // Words either side of each row
+    const Tile* west = neighbors[1][0];
+    const Tile* east = neighbors[1][2];
+    for (std::size_t y = 0; y < TILE_ROWS; ++y)
+    {
+        std::uint64_t* row = tile.getRow(y);
+        row[-1] = west ? west->getRow(y)[LAST_WORD] : 0;
+        row[TILE_WORDS] = east ? east->getRow(y)[0] : 0;
+    }
+}
+
+std::uint8_t UnboundedLife::stepTile(Tile& tile) const
+{
+    // A tile row ends on a word boundary with no bits to mask, so the kernel
+    // is given a row wider than the span to keep it off its masked last word
+    const std::size_t UNMASKED_SIZE_X = (TILE_WORDS + 1) * CELLS_PER_WORD;
+
+    std::uint64_t next[TILE_ROWS * TILE_WORDS];
+    bool changed = false;
+    for (std::size_t y = 0; y < TILE_ROWS; ++y)
+    {
+        changed = spanKernel(bitRule, tile.getRow(std::int64_t(y) - 1), tile.getRow(y), tile.getRow(y + 1), next + y * TILE_WORDS, UNMASKED_SIZE_X, 0, TILE_WORDS, nullptr, 0) || changed;
+    }
+    // Tiles grown for births that never came are empty without changing
+    std::uint64_t live = 0;
+    for (std::size_t i = 0; i < TILE_ROWS * TILE_WORDS; ++i)
+    {
+        live |= next[i];
+    }
+    if (changed)
+    {
+        for (std::size_t y = 0; y < TILE_ROWS; ++y)
+        {
+            std::copy(next + y * TILE_WORDS, next + (y + 1) * TILE_WORDS, tile.getRow(y));
+        }
+    }
+    return static_cast<std::uint8_t>((changed ? STEP_CHANGED : 0) | (live ? 0 : STEP_EMPTY));
+}
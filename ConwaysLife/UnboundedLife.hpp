@@ -0,0 +1,102 @@
+#pragma once
+
+#include "BlockPool.hpp"
+#include "LifeEngine.hpp"
+#include "LifeKernel.hpp"
+#include "LifeRule.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Life on an unbounded plane, held as a hash map of bit-packed tiles of
+// TILE_WORDS * 64 by TILE_ROWS cells. A tile is allocated when live cells
+// come within reach of it and freed once it empties, so memory follows the
+// live area rather than its bounding box; tiles come from a pool, so the
+// churn along a pattern's edges costs no heap traffic. As in LifeSimulator's
+// sparse mode, only tiles next to a change are stepped.
+// Like HashLife, the sizeX by sizeY window only addresses cells for
+// insertPattern() and getCell(), and nothing wraps. insertPattern() clamps
+// the start to the window and clips the pattern at it.
+class UnboundedLife : public LifeEngine
+{
+  public:
+    UnboundedLife(std::uint32_t sizeX, std::uint32_t sizeY);
+
+    UnboundedLife(const UnboundedLife&) = delete;
+    UnboundedLife& operator=(const UnboundedLife&) = delete;
+    UnboundedLife(UnboundedLife&&) = default;
+    UnboundedLife& operator=(UnboundedLife&&) = default;
+
+    void insertPattern(const Pattern& pattern, std::uint32_t startX, std::uint32_t startY) override;
+    void update() override;
+    void advance(std::uint64_t generations) override;
+    std::uint64_t step(std::uint64_t generations, const StepControl& control) override;
+    std::uint64_t getGeneration() const override;
+
+    std::uint32_t getSizeX() const override;
+    std::uint32_t getSizeY() const override;
+    bool getCell(std::uint32_t x, std::uint32_t y) const override;
+    void getRow(std::uint32_t y, std::uint64_t* words) const override;
+
+    // Live cells anywhere on the plane, counted tile by tile
+    std::uint64_t getPopulation() const;
+    std::size_t getTileCount() const;
+
+    // Two-state radius 1 rules only, and none with B0, which would fill the
+    // unbounded plane; throws std::invalid_argument for any other
+    void setRule(const LifeRule& rule);
+    const LifeRule& getRule() const;
+
+    std::size_t getMemoryUsage() const;
+
+  private:
+    static constexpr std::size_t TILE_WORDS = 4;
+    static constexpr std::size_t TILE_ROWS = 64;
+    // Each row is padded by a word on each side and the tile by a row above
+    // and below, as in LifeBoard; the padding holds copies of the neighbors'
+    // cells while the tile is stepped
+    static constexpr std::size_t TILE_STRIDE = TILE_WORDS + 2;
+
+    struct Tile
+    {
+        std::int64_t tileX;
+        std::int64_t tileY;
+        // Position in tiles
+        std::size_t index;
+        // Stepped in the next update()
+        bool awake;
+        std::uint64_t cells[(TILE_ROWS + 2) * TILE_STRIDE];
+
+        // Word 0 of row y, y from -1 to TILE_ROWS
+        std::uint64_t* getRow(std::int64_t y) { return cells + (y + 1) * TILE_STRIDE + 1; }
+        const std::uint64_t* getRow(std::int64_t y) const { return cells + (y + 1) * TILE_STRIDE + 1; }
+    };
+
+    std::uint32_t sizeX;
+    std::uint32_t sizeY;
+    std::uint64_t generation = 0;
+    LifeRule rule;
+    BitRule bitRule;
+    SpanKernel spanKernel;
+
+    BlockPool pool;
+    std::vector<Tile*> tiles;
+    // Open-addressing hash table of tiles, keyed by their position
+    std::vector<Tile*> table;
+    // Tiles stepped in this update(), and whether each one changed or emptied
+    std::vector<Tile*> stepped;
+    std::vector<std::uint8_t> stepResults;
+
+    Tile* findTile(std::int64_t tileX, std::int64_t tileY) const;
+    Tile* addTile(std::int64_t tileX, std::int64_t tileY);
+    void removeTile(Tile* tile);
+    void rebuildTable(std::size_t capacity);
+    // Wakes the tile and its neighbors
+    void wake(Tile* tile);
+    // True if the tile has live cells next to the tile dx, dy tiles away
+    bool reaches(const Tile& tile, std::int64_t dx, std::int64_t dy) const;
+    void growAround(const Tile& tile);
+    void fillHalo(Tile& tile) const;
+    // Steps the tile in place from its cells and halo. Returns whether it changed and whether it is now empty.
+    std::uint8_t stepTile(Tile& tile) const;
+};
@@ -0,0 +1,155 @@
+#include "UpdateProfile.hpp"
+
+#if defined(LIFE_INSTRUMENTATION)
+    #include "AllocationCounter.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    const char* const PHASE_NAMES[] = { "prepare", "tiles", "kernel", "survey", "halo", "activity", "cycles", "largerThanLife" };
+
+    void addSample(UpdateProfile::Series& series, std::uint64_t sample)
+    {
+        series.total += sample;
+        series.max = std::max(series.max, sample);
+    }
+
+    double getMean(const UpdateProfile::Series& series, std::uint64_t generations)
+    {
+        return generations ? double(series.total) / double(generations) : 0.0;
+    }
+}
+
+void UpdateProfile::startGeneration()
+{
+    startTime = now();
+    lapTime = startTime;
+#if defined(LIFE_INSTRUMENTATION)
+    startAllocations = getAllocationCount();
+#endif
+    phaseTimes.fill(0);
+    evaluated = 0;
+    changed = 0;
+}
+
+void UpdateProfile::lap(UpdatePhase phase)
+{
+    std::uint64_t time = now();
+    phaseTimes[static_cast<std::size_t>(phase)] += time - lapTime;
+    lapTime = time;
+}
+
+void UpdateProfile::addTime(UpdatePhase phase, std::uint64_t nanoseconds)
+{
+    phaseTimes[static_cast<std::size_t>(phase)] += nanoseconds;
+}
+
+void UpdateProfile::addCells(std::uint64_t evaluatedCells, std::uint64_t changedCells)
+{
+    evaluated += evaluatedCells;
+    changed += changedCells;
+}
+
+void UpdateProfile::endGeneration()
+{
+    ++generations;
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        addSample(phases[phase], phaseTimes[phase]);
+    }
+    addSample(updateTime, now() - startTime);
+    addSample(cellsEvaluated, evaluated);
+    addSample(cellsChanged, changed);
+#if defined(LIFE_INSTRUMENTATION)
+    addSample(allocations, getAllocationCount() - startAllocations);
+#endif
+}
+
+void UpdateProfile::reset()
+{
+    *this = UpdateProfile();
+}
+
+std::uint64_t UpdateProfile::getGenerations() const
+{
+    return generations;
+}
+
+const UpdateProfile::Series& UpdateProfile::getPhase(UpdatePhase phase) const
+{
+    return phases[static_cast<std::size_t>(phase)];
+}
+
+const UpdateProfile::Series& UpdateProfile::getUpdateTime() const
+{
+    return updateTime;
+}
+
+const UpdateProfile::Series& UpdateProfile::getCellsEvaluated() const
+{
+    return cellsEvaluated;
+}
+
+const UpdateProfile::Series& UpdateProfile::getCellsChanged() const
+{
+    return cellsChanged;
+}
+
+const UpdateProfile::Series& UpdateProfile::getAllocations() const
+{
+    return allocations;
+}
+
+void UpdateProfile::writeJson(std::ostream& out) const
+{
+    auto writeSeries = [&](const char* name, const Series& series) {
+        out << "\"" << name << "\": {\"total\": " << series.total << ", \"max\": " << series.max << ", \"mean\": " << getMean(series, generations) << "}";
+    };
+
+    out << "{\n  \"unit\": \"ns\",\n  \"generations\": " << generations << ",\n  ";
+    writeSeries("update", updateTime);
+    out << ",\n  ";
+    writeSeries("cellsEvaluated", cellsEvaluated);
+    out << ",\n  ";
+    writeSeries("cellsChanged", cellsChanged);
+    out << ",\n  ";
+    writeSeries("allocations", allocations);
+    out << ",\n  \"phases\": {";
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        out << (phase ? "," : "") << "\n    ";
+        writeSeries(PHASE_NAMES[phase], phases[phase]);
+    }
+    out << "\n  }\n}\n";
+}
+
+void UpdateProfile::writeCsv(std::ostream& out) const
+{
+    auto writeSeries = [&](const char* name, const char* unit, const Series& series) {
+        out << name << "," << unit << "," << series.total << "," << series.max << "," << getMean(series, generations) << "\n";
+    };
+
+    out << "name,unit,total,max,mean\n";
+    out << "generations,generations," << generations << ",1,1\n";
+    writeSeries("update", "ns", updateTime);
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        writeSeries(PHASE_NAMES[phase], "ns", phases[phase]);
+    }
+    writeSeries("cellsEvaluated", "cells", cellsEvaluated);
+    writeSeries("cellsChanged", "cells", cellsChanged);
+    writeSeries("allocations", "allocations", allocations);
+}
+
+const char* UpdateProfile::getPhaseName(UpdatePhase phase)
+{
+    return PHASE_NAMES[static_cast<std::size_t>(phase)];
+}
+
+std::uint64_t UpdateProfile::now()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
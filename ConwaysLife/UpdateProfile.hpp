@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+// Parts of LifeSimulator::update() that UpdateProfile times. Kernel and
+// Survey are the work of single tiles inside Tiles or LargerThanLife,
+// summed over every thread; the rest are wall time on the calling thread.
+enum class UpdatePhase
+{
+    // Detaching the next board, hashing a board changed from outside, and
+    // refreshing its halo
+    Prepare,
+    Tiles,
+    // The rule applied to each row of a tile, ages included
+    Kernel,
+    // Census and hash of each tile that changed
+    Survey,
+    Halo,
+    // Queueing the neighborhoods of changed tiles in sparse mode
+    Activity,
+    Cycles,
+    LargerThanLife,
+    Count
+};
+
+// Totals of the generations a LifeSimulator stepped, for finding where an
+// update() spends its time: per phase, the cells evaluated and changed, and
+// the allocations made. It holds no more than fixed arrays, so recording
+// never allocates.
+//
+// The simulator only keeps one when built with LIFE_INSTRUMENTATION defined
+// (the CMake option of that name), which also links in the allocation
+// counter; without it allocations read 0. Otherwise the LIFE_INSTRUMENT and
+// LIFE_LAP_PHASE hooks in its hot path expand to nothing.
+class UpdateProfile
+{
+  public:
+    // A quantity summed over the generations, and its largest value in one
+    struct Series
+    {
+        std::uint64_t total = 0;
+        std::uint64_t max = 0;
+    };
+
+    // Starts the clock and the allocation count of a generation
+    void startGeneration();
+    // Adds the time since the last lap, or the start, to the phase
+    void lap(UpdatePhase phase);
+    void addTime(UpdatePhase phase, std::uint64_t nanoseconds);
+    void addCells(std::uint64_t evaluatedCells, std::uint64_t changedCells);
+    void endGeneration();
+    // Forgets every generation recorded so far
+    void reset();
+
+    std::uint64_t getGenerations() const;
+    const Series& getPhase(UpdatePhase phase) const;
+    // Wall time of the whole update()
+    const Series& getUpdateTime() const;
+    const Series& getCellsEvaluated() const;
+    const Series& getCellsChanged() const;
+    const Series& getAllocations() const;
+
+    // One object with the counters and a list of phases, times in nanoseconds
+    void writeJson(std::ostream& out) const;
+    // A header, then a line per phase and counter: name, unit, total, max, mean
+    void writeCsv(std::ostream& out) const;
+
+    static const char* getPhaseName(UpdatePhase phase);
+    // Nanoseconds on a steady clock
+    static std::uint64_t now();
+
+  private:
+    static constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(UpdatePhase::Count);
+
+    std::uint64_t generations = 0;
+    std::array<Series, PHASE_COUNT> phases;
+    Series updateTime;
+    Series cellsEvaluated;
+    Series cellsChanged;
+    Series allocations;
+
+    // The generation being recorded
+    std::uint64_t startTime = 0;
+    std::uint64_t lapTime = 0;
+    std::uint64_t startAllocations = 0;
+    std::array<std::uint64_t, PHASE_COUNT> phaseTimes = {};
+    std::uint64_t evaluated = 0;
+    std::uint64_t changed = 0;
+};
+
+#if defined(LIFE_INSTRUMENTATION)
+    #define LIFE_INSTRUMENT(statement) statement
+    #define LIFE_LAP_PHASE(profile, phase) (profile).lap(phase)
+#else
+    #define LIFE_INSTRUMENT(statement)
+    #define LIFE_LAP_PHASE(profile, phase)
+#endif
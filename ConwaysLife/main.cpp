@@ -1,43 +1,677 @@
+#include "CheckpointWriter.hpp"
+#include "FramePipeline.hpp"
+#include "LifeBatch.hpp"
 #include "LifeSimulator.hpp"
+#include "LifeSnapshot.hpp"
+#include "ObjectCensus.hpp"
 #include "PatternAcorn.hpp"
 #include "PatternBlinker.hpp"
 #include "PatternBlock.hpp"
+#include "PatternFile.hpp"
 #include "PatternGlider.hpp"
 #include "PatternGosperGliderGun.hpp"
+#include "PatternSoup.hpp"
 #include "RendererConsole.hpp"
+#include "RendererDownsampled.hpp"
+#include "UnboundedLife.hpp"
 #include "rlutil.h"
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
-const std::uint16_t N_FRAMES = 1000;
+const std::uint16_t N_GENERATIONS = 1000;
+// Pace of the interactive view; the simulation and the terminal keep their own
+const double GENERATIONS_PER_SECOND = 100.0;
+const double FRAMES_PER_SECOND = 30.0;
+// Board used by --headless unless --size says otherwise
+const std::uint32_t HEADLESS_SIZE = 1024;
+// Boards used by --soups unless --size says otherwise
+const std::uint32_t SOUP_SIZE = 16;
+// Most common objects listed by --census
+const std::size_t CENSUS_LINES = 20;
+// Generations a headless run goes between looks at its progress
+const std::uint64_t PROGRESS_INTERVAL = 256;
+// Longest --cycle-window, whose hashes then take about 100 MB
+const std::uint64_t MAX_CYCLE_WINDOW = std::uint64_t(1) << 20;
 
-int main()
+// Set by Ctrl+C during a headless run, which then ends at the next generation
+CancellationToken interruption;
+
+void interrupt(int)
+{
+    interruption.cancel();
+}
+
+void insertPatterns(LifeEngine& engine);
+void runInteractive(LifeEngine& engine, std::unique_ptr<Renderer> renderer, std::uint64_t generations, CheckpointWriter* checkpoints, std::uint64_t checkpointEvery);
+void showProgress(std::uint64_t done, std::uint64_t generations, std::chrono::steady_clock::time_point& shown);
+void runHeadless(LifeSimulator& sim, std::uint64_t generations, CheckpointWriter* checkpoints, std::uint64_t checkpointEvery);
+void runHeadless(UnboundedLife& plane, std::uint64_t generations);
+void printCensus(const Pattern& board, bool wrap, std::size_t threadCount);
+bool writeProfile(const LifeSimulator& sim, const std::string& path);
+int runSoups(std::size_t soupCount, std::uint32_t sizeX, std::uint32_t sizeY, const SoupGenerator& firstSoup, const LifeRule& rule, std::uint64_t generations,
+             std::size_t threadCount);
+
+int main(int argc, char* argv[])
 {
-    auto sizeX = static_cast<std::uint8_t>(rlutil::tcols());
-    auto sizeY = static_cast<std::uint8_t>(rlutil::trows());
+    LifeRule rule;
+    bool ruleGiven = false;
+    std::string patternPath;
+    std::uint64_t headlessGenerations = 0;
+    std::uint32_t sizeX = 0;
+    std::uint32_t sizeY = 0;
+    std::size_t threadCount = 1;
+    bool threadsGiven = false;
+    std::string view;
+    std::uint32_t zoom = 0;
+    std::string loadPath;
+    std::string savePath;
+    std::uint64_t checkpointEvery = 0;
+    bool compress = false;
+    std::uint64_t cycleWindow = 0;
+    bool unbounded = false;
+    std::size_t soupCount = 0;
+    unsigned long long soupSeed = 0;
+    bool soupGiven = false;
+    double density = 0.5;
+    bool census = false;
+    std::string profilePath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        unsigned long long generationsArg = 0;
+        if (arg == "--rule" && i + 1 < argc)
+        {
+            try
+            {
+                rule = LifeRule::parse(argv[++i]);
+                ruleGiven = true;
+            }
+            catch (const std::invalid_argument& error)
+            {
+                std::cerr << error.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--pattern" && i + 1 < argc)
+        {
+            patternPath = argv[++i];
+        }
+        else if (arg == "--headless" && i + 1 < argc && std::sscanf(argv[i + 1], "%llu", &generationsArg) == 1 && generationsArg)
+        {
+            headlessGenerations = generationsArg;
+            ++i;
+        }
+        else if (arg == "--size" && i + 1 < argc && std::sscanf(argv[i + 1], "%ux%u", &sizeX, &sizeY) == 2 && sizeX && sizeY)
+        {
+            ++i;
+        }
+        else if (arg == "--threads" && i + 1 < argc && std::sscanf(argv[i + 1], "%zu", &threadCount) == 1)
+        {
+            threadsGiven = true;
+            ++i;
+        }
+        else if (arg == "--view" && i + 1 < argc && (std::string(argv[i + 1]) == "text" || std::string(argv[i + 1]) == "braille" || std::string(argv[i + 1]) == "blocks"))
+        {
+            view = argv[++i];
+        }
+        else if (arg == "--zoom" && i + 1 < argc && std::sscanf(argv[i + 1], "%u", &zoom) == 1)
+        {
+            ++i;
+        }
+        else if (arg == "--load" && i + 1 < argc)
+        {
+            loadPath = argv[++i];
+        }
+        else if (arg == "--save" && i + 1 < argc)
+        {
+            savePath = argv[++i];
+        }
+        else if (arg == "--checkpoint-every" && i + 1 < argc && std::sscanf(argv[i + 1], "%llu", &generationsArg) == 1)
+        {
+            checkpointEvery = generationsArg;
+            ++i;
+        }
+        else if (arg == "--compress")
+        {
+            compress = true;
+        }
+        else if (arg == "--cycle-window" && i + 1 < argc && std::sscanf(argv[i + 1], "%llu", &generationsArg) == 1)
+        {
+            cycleWindow = generationsArg;
+            ++i;
+        }
+        else if (arg == "--unbounded")
+        {
+            unbounded = true;
+        }
+        else if (arg == "--census")
+        {
+            census = true;
+        }
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            profilePath = argv[++i];
+        }
+        else if (arg == "--soup" && i + 1 < argc && std::sscanf(argv[i + 1], "%llu", &soupSeed) == 1)
+        {
+            soupGiven = true;
+            ++i;
+        }
+        else if (arg == "--density" && i + 1 < argc && std::sscanf(argv[i + 1], "%lf", &density) == 1 && density >= 0 && density <= 1)
+        {
+            ++i;
+        }
+        else if (arg == "--soups" && i + 1 < argc && std::sscanf(argv[i + 1], "%zu", &soupCount) == 1 && soupCount)
+        {
+            ++i;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--rule B3/S23] [--pattern file.rle|file.mc] [--size 80x24] [--threads 1] [--view text|braille|blocks] [--zoom 0]"
+                      << " [--headless generations] [--load file.snap] [--save file.snap] [--checkpoint-every generations] [--compress]"
+                      << " [--cycle-window generations] [--unbounded] [--soup seed] [--density 0.5] [--soups count] [--census] [--profile file.json|file.csv]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    if (soupCount)
+    {
+        return runSoups(soupCount, sizeX ? sizeX : SOUP_SIZE, sizeX ? sizeY : SOUP_SIZE, SoupGenerator(soupSeed, density), rule,
+                        headlessGenerations ? headlessGenerations : N_GENERATIONS, threadCount);
+    }
+
+    auto columns = static_cast<std::uint32_t>(rlutil::tcols());
+    auto rows = static_cast<std::uint32_t>(rlutil::trows());
+    if (!sizeX)
+    {
+        sizeX = headlessGenerations ? HEADLESS_SIZE : columns;
+        sizeY = headlessGenerations ? HEADLESS_SIZE : rows;
+    }
+
+    if (unbounded && (!loadPath.empty() || !savePath.empty() || cycleWindow))
+    {
+        std::cerr << "--unbounded runs without snapshots or cycle detection" << std::endl;
+        return 1;
+    }
+    if (unbounded && threadsGiven)
+    {
+        std::cerr << "--unbounded steps the plane on one thread" << std::endl;
+        return 1;
+    }
+    if (cycleWindow > MAX_CYCLE_WINDOW)
+    {
+        std::cerr << "--cycle-window looks back at most " << MAX_CYCLE_WINDOW << " generations" << std::endl;
+        return 1;
+    }
+    if (checkpointEvery && savePath.empty())
+    {
+        std::cerr << "--checkpoint-every needs a --save file to write to" << std::endl;
+        return 1;
+    }
+
+#if !defined(LIFE_INSTRUMENTATION)
+    if (!profilePath.empty())
+    {
+        std::cerr << "--profile needs a build with LIFE_INSTRUMENTATION on" << std::endl;
+        return 1;
+    }
+#endif
+    if (!profilePath.empty() && (unbounded || !headlessGenerations))
+    {
+        std::cerr << "--profile only times headless runs of the torus" << std::endl;
+        return 1;
+    }
+
+    // A loaded snapshot brings its own size and rule, and patterns only go in
+    // on request. On an unbounded plane the size is only the window drawn.
+    LifeSimulator sim(0, 0);
+    std::unique_ptr<UnboundedLife> plane;
+    if (unbounded)
+    {
+        plane = std::make_unique<UnboundedLife>(sizeX, sizeY);
+        try
+        {
+            plane->setRule(rule);
+        }
+        catch (const std::invalid_argument& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+    else if (loadPath.empty())
+    {
+        try
+        {
+            sim = LifeSimulator(sizeX, sizeY, rule);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        try
+        {
+            sim = LifeSnapshot::load(loadPath);
+            if (ruleGiven)
+            {
+                sim.setRule(rule);
+            }
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        sizeX = sim.getSizeX();
+        sizeY = sim.getSizeY();
+    }
+    if (!plane)
+    {
+        sim.setThreadCount(threadCount);
+        try
+        {
+            sim.setCycleWindow(cycleWindow);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    LifeEngine& engine = plane ? static_cast<LifeEngine&>(*plane) : sim;
+    auto setRule = [&sim, &plane](const LifeRule& rule) {
+        if (plane)
+        {
+            plane->setRule(rule);
+        }
+        else
+        {
+            sim.setRule(rule);
+        }
+    };
+
+    if (patternPath.empty())
+    {
+        if (loadPath.empty() && soupGiven)
+        {
+            // Drawn straight into the simulator's board, a tile per thread
+            if (plane)
+            {
+                plane->insertPattern(PatternSoup(sizeX, sizeY, soupSeed, density), 0, 0);
+            }
+            else
+            {
+                sim.fillSoup(SoupGenerator(soupSeed, density));
+            }
+        }
+        else if (loadPath.empty())
+        {
+            insertPatterns(engine);
+        }
+    }
+    else
+    {
+        // Centered, and under the file's rule unless one was given
+        try
+        {
+            PatternFile pattern(patternPath);
+            if (!ruleGiven && !pattern.getRuleNotation().empty())
+            {
+                setRule(LifeRule::parse(pattern.getRuleNotation()));
+            }
+            engine.insertPattern(pattern, sizeX > pattern.getSizeX() ? (sizeX - pattern.getSizeX()) / 2 : 0,
+                                 sizeY > pattern.getSizeY() ? (sizeY - pattern.getSizeY()) / 2 : 0);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Periodic checkpoints go to the --save file from a thread of their own
+    std::unique_ptr<CheckpointWriter> checkpoints;
+    if (checkpointEvery)
+    {
+        checkpoints = std::make_unique<CheckpointWriter>(savePath, compress);
+    }
+
+    if (headlessGenerations && plane)
+    {
+        runHeadless(*plane, headlessGenerations);
+        if (census)
+        {
+            printCensus(*plane, false, threadCount);
+        }
+    }
+    else if (headlessGenerations)
+    {
+        runHeadless(sim, headlessGenerations, checkpoints.get(), checkpointEvery);
+        if (!profilePath.empty() && !writeProfile(sim, profilePath))
+        {
+            return 1;
+        }
+        if (census)
+        {
+            printCensus(sim, true, threadCount);
+        }
+    }
+    else
+    {
+        // Plain text while the board fits the terminal, Braille dots once it does not
+        if (view.empty())
+        {
+            view = (sizeX <= columns && sizeY <= rows && !zoom) ? "text" : "braille";
+        }
+
+        std::unique_ptr<Renderer> renderer;
+        if (view == "text")
+        {
+            renderer = std::make_unique<RendererConsole>();
+        }
+        else
+        {
+            auto downsampled = std::make_unique<RendererDownsampled>(columns, rows, view == "braille" ? RendererDownsampled::Glyphs::Braille : RendererDownsampled::Glyphs::HalfBlock);
+            downsampled->setViewport(0, 0, zoom);
+            renderer = std::move(downsampled);
+        }
+        runInteractive(engine, std::move(renderer), N_GENERATIONS, checkpoints.get(), checkpointEvery);
+    }
+
+    if (checkpoints)
+    {
+        checkpoints->flush();
+        std::string error = checkpoints->getLastError();
+        checkpoints.reset();
+        if (!error.empty())
+        {
+            std::cerr << "Checkpoint failed: " << error << std::endl;
+        }
+    }
+    if (!savePath.empty())
+    {
+        try
+        {
+            LifeSnapshot(sim).save(savePath, compress);
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void insertPatterns(LifeEngine& engine)
+{
+    std::uint32_t sizeX = engine.getSizeX();
+    std::uint32_t sizeY = engine.getSizeY();
 
-    LifeSimulator sim(sizeX, sizeY);
     PatternAcorn acorn;
     PatternBlinker blinker;
     PatternBlock block;
     PatternGlider glider;
     PatternGosperGliderGun gun;
-    sim.insertPattern(acorn, 5, 9);
-    sim.insertPattern(gun, sizeX / 4, sizeY / 2);
-    sim.insertPattern(blinker, 2, 2);
-    sim.insertPattern(blinker, 2, sizeY - 2);
-    sim.insertPattern(blinker, sizeX - 4, 2);
-    sim.insertPattern(blinker, sizeX - 4, sizeY - 2);
-    sim.insertPattern(block, sizeX - 8, sizeY - 6);
-    sim.insertPattern(glider, 10, 10);
-    RendererConsole renderer;
+    engine.insertPattern(acorn, 5, 9);
+    engine.insertPattern(gun, sizeX / 4, sizeY / 2);
+    engine.insertPattern(blinker, 2, 2);
+    engine.insertPattern(blinker, 2, sizeY - 2);
+    engine.insertPattern(blinker, sizeX - 4, 2);
+    engine.insertPattern(blinker, sizeX - 4, sizeY - 2);
+    engine.insertPattern(block, sizeX - 8, sizeY - 6);
+    engine.insertPattern(glider, 10, 10);
+}
+
+// The simulation thread captures each generation into the pipeline and
+// steps on at its own pace; this thread renders the newest frame at the
+// frame rate, so a slow terminal only costs skipped frames
+void runInteractive(LifeEngine& engine, std::unique_ptr<Renderer> renderer, std::uint64_t generations, CheckpointWriter* checkpoints, std::uint64_t checkpointEvery)
+{
+    FramePipeline pipeline;
+    std::thread simulation([&engine, &pipeline, generations, checkpoints, checkpointEvery]() {
+        const auto generationTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / GENERATIONS_PER_SECOND));
+        auto nextGeneration = std::chrono::steady_clock::now();
+        for (std::uint64_t generation = 0; generation <= generations; ++generation)
+        {
+            pipeline.beginWrite().capture(engine);
+            pipeline.publish();
+            if (generation == generations)
+            {
+                break;
+            }
+
+            engine.update();
+            // Only a LifeSimulator is ever given checkpoints to take
+            if (checkpoints && engine.getGeneration() % checkpointEvery == 0)
+            {
+                checkpoints->submit(LifeSnapshot(dynamic_cast<const LifeSimulator&>(engine)));
+            }
+            nextGeneration += generationTime;
+            std::this_thread::sleep_until(nextGeneration);
+        }
+        pipeline.close();
+    });
+
+    const auto frameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / FRAMES_PER_SECOND));
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (const LifeFrame* frame = pipeline.acquire())
+    {
+        renderer->render(*frame);
+
+        // After a slow frame, carry on from now rather than catch up in a burst
+        nextFrame = std::max(nextFrame + frameTime, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(nextFrame);
+    }
+    renderer.reset();
+    simulation.join();
+
+    std::cout << pipeline.getPublishedCount() << " generations, " << pipeline.getDroppedCount() << " not drawn" << std::endl;
+}
+
+// Rewrites the progress line on stderr, at most once a second so that runs
+// over sooner show none. shown is when it was last written, or the start.
+void showProgress(std::uint64_t done, std::uint64_t generations, std::chrono::steady_clock::time_point& shown)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - shown >= std::chrono::seconds(1))
+    {
+        std::cerr << "\rGeneration " << done << " of " << generations << std::flush;
+        shown = now;
+    }
+}
+
+// Steps as fast as the simulator goes, with nothing drawn, stopping early
+// once the board settles into a cycle if cycle detection is on, or on Ctrl+C
+void runHeadless(LifeSimulator& sim, std::uint64_t generations, CheckpointWriter* checkpoints, std::uint64_t checkpointEvery)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto shown = start;
+    bool cycled = false;
+
+    // The cycle check and checkpoints look at every generation; otherwise
+    // the simulator runs on by itself between looks
+    StepControl control;
+    control.cancellation = &interruption;
+    control.progressInterval = checkpoints || sim.getCycleWindow() ? 1 : PROGRESS_INTERVAL;
+    control.progress = [&](std::uint64_t done) {
+        // On generations of the board, as in runInteractive(); the last one
+        // is saved once the run is over
+        if (checkpoints && sim.getGeneration() % checkpointEvery == 0 && done != generations)
+        {
+            checkpoints->submit(LifeSnapshot(sim));
+        }
+        if (sim.getCyclePeriod())
+        {
+            cycled = true;
+            interruption.cancel();
+        }
+        showProgress(done, generations, shown);
+    };
+
+    std::signal(SIGINT, interrupt);
+    std::uint64_t done = sim.step(generations, control);
+    std::signal(SIGINT, SIG_DFL);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (shown != start)
+    {
+        std::cerr << std::endl;
+    }
 
-    for (std::uint16_t frameCount = 0; frameCount < N_FRAMES; ++frameCount)
+    if (cycled)
+    {
+        std::cout << "Generation " << sim.getRepeatGeneration() << " repeats generation " << sim.getRepeatGeneration() - sim.getCyclePeriod()
+                  << ": period " << sim.getCyclePeriod() << std::endl;
+    }
+    else if (interruption.isCancelled())
     {
-        renderer.render(sim);
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        sim.update();
+        std::cout << "Interrupted" << std::endl;
     }
+    interruption.reset();
+    generations = done;
+
+    double cells = static_cast<double>(sim.getSizeX()) * sim.getSizeY() * static_cast<double>(generations);
+    std::cout << generations << " generations of " << sim.getSizeX() << "x" << sim.getSizeY() << " on " << sim.getThreadCount() << " thread(s) in "
+              << seconds << " s: " << generations / seconds << " generations/s, " << cells / seconds << " cells/s" << std::endl;
+}
+
+// Steps as fast as the plane goes, with nothing drawn, stopping early on Ctrl+C
+void runHeadless(UnboundedLife& plane, std::uint64_t generations)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto shown = start;
+
+    StepControl control;
+    control.cancellation = &interruption;
+    control.progressInterval = PROGRESS_INTERVAL;
+    control.progress = [&](std::uint64_t done) { showProgress(done, generations, shown); };
 
+    std::signal(SIGINT, interrupt);
+    generations = plane.step(generations, control);
+    std::signal(SIGINT, SIG_DFL);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (shown != start)
+    {
+        std::cerr << std::endl;
+    }
+    if (interruption.isCancelled())
+    {
+        std::cout << "Interrupted" << std::endl;
+    }
+    interruption.reset();
+
+    std::cout << generations << " generations on an unbounded plane in " << seconds << " s: " << generations / seconds << " generations/s, "
+              << plane.getPopulation() << " live cells in " << plane.getTileCount() << " tiles, " << plane.getMemoryUsage() << " bytes" << std::endl;
+}
+
+// Lists the objects on the board, most common first
+void printCensus(const Pattern& board, bool wrap, std::size_t threadCount)
+{
+    ObjectCensus census;
+    census.setThreadCount(threadCount);
+    auto start = std::chrono::steady_clock::now();
+    census.take(board, wrap);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << census.getObjects().size() << " objects of " << census.getTallies().size() << " forms in " << seconds << " s" << std::endl;
+    for (std::size_t i = 0; i < std::min(census.getTallies().size(), CENSUS_LINES); ++i)
+    {
+        const ObjectCensus::Tally& tally = census.getTallies()[i];
+        char form[17];
+        std::snprintf(form, sizeof(form), "%016llx", static_cast<unsigned long long>(tally.form));
+        std::cout << tally.count << " x " << (tally.name ? tally.name : "unnamed") << " (" << tally.population << " cells, form " << form << ")" << std::endl;
+    }
+}
+
+// Writes the update profile to path, CSV for a .csv file and JSON for anything else
+bool writeProfile(const LifeSimulator& sim, const std::string& path)
+{
+#if defined(LIFE_INSTRUMENTATION)
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (csv)
+    {
+        sim.getProfile().writeCsv(out);
+    }
+    else
+    {
+        sim.getProfile().writeJson(out);
+    }
+    std::cout << "Profile of " << sim.getProfile().getGenerations() << " generations written to " << path << std::endl;
+    return true;
+#else
+    (void)sim;
+    (void)path;
+    return false;
+#endif
+}
+
+// Runs random soups side by side until they settle or the generations run
+// out, and tells how many settled into cycles of each period. Soup i has the
+// seed of the first soup plus i.
+int runSoups(std::size_t soupCount, std::uint32_t sizeX, std::uint32_t sizeY, const SoupGenerator& firstSoup, const LifeRule& rule, std::uint64_t generations,
+             std::size_t threadCount)
+{
+    try
+    {
+        LifeBatch batch(soupCount, sizeX, sizeY, rule);
+        batch.setThreadCount(threadCount);
+        for (std::size_t soup = 0; soup < soupCount; ++soup)
+        {
+            batch.insertPattern(soup, PatternSoup(sizeX, sizeY, firstSoup.getSeed() + soup, firstSoup.getDensity()), 0, 0);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        batch.advance(generations);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::map<std::uint64_t, std::size_t> periods;
+        std::size_t extinct = 0;
+        double boardGenerations = 0;
+        for (const LifeBatch::Result& result : batch.getResults())
+        {
+            ++periods[result.period];
+            extinct += result.period && !result.population;
+            boardGenerations += static_cast<double>(result.generation);
+        }
+
+        std::cout << soupCount << " soups of " << sizeX << "x" << sizeY << " on " << batch.getThreadCount() << " thread(s) in " << seconds << " s: "
+                  << boardGenerations / seconds << " board generations/s" << std::endl;
+        for (const auto& period : periods)
+        {
+            if (period.first)
+            {
+                std::cout << "period " << period.first << ": " << period.second << std::endl;
+            }
+        }
+        std::cout << "died out: " << extinct << ", still running after " << generations << " generations: " << periods[0] << std::endl;
+    }
+    catch (const std::invalid_argument& error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
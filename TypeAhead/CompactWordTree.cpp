@@ -0,0 +1,167 @@
+#include "CompactWordTree.hpp"
+
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+CompactWordTree::CompactWordTree(const WordTree& wordTree)
+{
+    // Edge 0 is a placeholder, so no node's edges begin at NO_CHILDREN
+    m_edges.push_back(0);
+    std::map<std::vector<std::uint32_t>, std::uint32_t> stored;
+    m_root = compact(wordTree, 0, stored);
+    m_edges.shrink_to_fit();
+    m_size = wordTree.m_size;
+}
+
+std::uint32_t CompactWordTree::compact(const WordTree& wordTree, std::uint32_t node, std::map<std::vector<std::uint32_t>, std::uint32_t>& stored)
+{
+    // Children first, so every edge knows where its target's edges begin
+    std::vector<std::uint32_t> edges;
+    for (std::uint32_t i = 0; i < 26; ++i)
+    {
+        std::uint32_t child = wordTree.getChild(node, i);
+        if (child != WordTree::NO_CHILD)
+        {
+            std::uint32_t target = compact(wordTree, child, stored);
+            edges.push_back(i | (wordTree.m_nodes[child].endOfWord ? END_OF_WORD : 0) | (target << TARGET_SHIFT));
+        }
+    }
+    if (edges.empty())
+    {
+        return NO_CHILDREN;
+    }
+    edges.back() |= LAST_EDGE;
+
+    auto found = stored.find(edges);
+    if (found != stored.end())
+    {
+        return found->second;
+    }
+
+    if (m_edges.size() + edges.size() > (std::size_t(1) << (32 - TARGET_SHIFT)))
+    {
+        throw std::length_error("Too many edges for a CompactWordTree");
+    }
+    auto begin = static_cast<std::uint32_t>(m_edges.size());
+    m_edges.insert(m_edges.end(), edges.begin(), edges.end());
+    stored.emplace(std::move(edges), begin);
+    return begin;
+}
+
+std::uint32_t CompactWordTree::findEdge(std::uint32_t node, char letter) const
+{
+    if (node == NO_CHILDREN)
+    {
+        return NO_CHILDREN;
+    }
+
+    auto index = static_cast<std::uint32_t>(letter - 'a');
+    for (std::uint32_t edge = node;; ++edge)
+    {
+        std::uint32_t edgeLetter = m_edges[edge] & LETTER_MASK;
+        if (edgeLetter == index)
+        {
+            return edge;
+        }
+        // Sorted by letter, so the letter is not further on
+        if (edgeLetter > index || (m_edges[edge] & LAST_EDGE))
+        {
+            return NO_CHILDREN;
+        }
+    }
+}
+
+bool CompactWordTree::find(std::string word) const
+{
+    // Return false on empty string
+    if (!word.length())
+    {
+        return false;
+    }
+
+    std::uint32_t node = m_root;
+    std::uint32_t edge = NO_CHILDREN;
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        edge = findEdge(node, word[i]);
+        if (edge == NO_CHILDREN)
+        {
+            return false;
+        }
+        node = m_edges[edge] >> TARGET_SHIFT;
+    }
+
+    return (m_edges[edge] & END_OF_WORD) != 0;
+}
+
+std::vector<std::string> CompactWordTree::predict(std::string partial, std::uint8_t howMany) const
+{
+    std::vector<std::string> predictions;
+
+    // No prediction for empty string
+    if (!partial.length())
+    {
+        return predictions;
+    }
+
+    // Find partial node
+    std::uint32_t node = m_root;
+    for (size_t i = 0; i < partial.length(); ++i)
+    {
+        std::uint32_t edge = findEdge(node, partial[i]);
+
+        // Partial is not in tree, exit
+        if (edge == NO_CHILDREN)
+        {
+            return predictions;
+        }
+        node = m_edges[edge] >> TARGET_SHIFT;
+    }
+
+    // BFS for predictions, visiting nodes in the same order as WordTree::predict()
+    std::queue<std::pair<std::uint32_t, std::string>> q;
+    q.emplace(node, partial);
+    while (predictions.size() < howMany && q.size())
+    {
+        auto currNodeWithString = q.front();
+        q.pop();
+
+        node = currNodeWithString.first;
+        const auto& currPartial = currNodeWithString.second;
+        if (node == NO_CHILDREN)
+        {
+            continue;
+        }
+        for (std::uint32_t edge = node;; ++edge)
+        {
+            auto newPartial = currPartial + static_cast<char>('a' + (m_edges[edge] & LETTER_MASK));
+
+            // Add prediction
+            if (m_edges[edge] & END_OF_WORD)
+            {
+                predictions.push_back(newPartial);
+            }
+
+            // Add node to queue
+            q.emplace(m_edges[edge] >> TARGET_SHIFT, newPartial);
+
+            if (q.size() == howMany || (m_edges[edge] & LAST_EDGE))
+            {
+                break;
+            }
+        }
+    }
+
+    return predictions;
+}
+
+std::size_t CompactWordTree::size() const
+{
+    return m_size;
+}
+
+std::size_t CompactWordTree::memoryUsage() const
+{
+    return sizeof(*this) + m_edges.capacity() * sizeof(std::uint32_t);
+}
@@ -0,0 +1,52 @@
+/*
+ * CompactWordTree is an immutable copy of a WordTree, minimized to a
+ * directed acyclic word graph (DAWG) and stored in one flat array of edges
+ */
+
+#pragma once
+
+#include "WordTree.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class CompactWordTree
+{
+  private:
+    // An edge packs the letter it reads, whether the word read so far ends
+    // there, whether it is the last edge of its node, and where the edges of
+    // the node it leads to begin. A node's edges are contiguous and sorted by
+    // letter. Nodes with the same edges are stored once, so words share their
+    // suffixes as well as their prefixes.
+    static constexpr std::uint32_t LETTER_MASK = 0x1F;
+    static constexpr std::uint32_t END_OF_WORD = 1 << 5;
+    static constexpr std::uint32_t LAST_EDGE = 1 << 6;
+    static constexpr std::uint32_t TARGET_SHIFT = 7;
+    // Target of edges into a node with no children; edge 0 is never read
+    static constexpr std::uint32_t NO_CHILDREN = 0;
+
+    std::vector<std::uint32_t> m_edges;
+    std::uint32_t m_root;
+    std::size_t m_size;
+
+    // Returns where the node's edges begin, storing them if no node with the
+    // same edges is stored yet
+    std::uint32_t compact(const WordTree& wordTree, std::uint32_t node, std::map<std::vector<std::uint32_t>, std::uint32_t>& stored);
+    // Returns the edge from node that reads letter, or NO_CHILDREN if none does
+    std::uint32_t findEdge(std::uint32_t node, char letter) const;
+
+  public:
+    explicit CompactWordTree(const WordTree& wordTree);
+
+    // Returns true if word is in tree
+    bool find(std::string word) const;
+    // Returns vector of howMany predictions given partial input, the same
+    // ones WordTree::predict() gives
+    std::vector<std::string> predict(std::string partial, std::uint8_t howMany) const;
+    // Returns number of words in tree
+    std::size_t size() const;
+    // Returns bytes held by the tree
+    std::size_t memoryUsage() const;
+};
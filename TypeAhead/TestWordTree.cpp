@@ -1,3 +1,4 @@
+#include "CompactWordTree.hpp"
 #include "WordTree.hpp"
 
 #include "gtest/gtest.h"
@@ -205,3 +206,112 @@ TEST(WordTree_Predict, DoesLimitPredicitionCount)
 
     ASSERT_EQ(5, wordTree.predict("a", 10).size());
 }
+
+TEST(WordTree_Predict, KeepsChildrenInLetterOrder)
+{
+    WordTree wordTree;
+
+    // Two nodes gaining children in turn, last letter first, so their
+    // child lists keep moving to larger slots and reusing each other's
+    for (char letter = 'z'; letter >= 'a'; --letter)
+    {
+        wordTree.add(std::string("a") + letter);
+        wordTree.add(std::string("b") + letter);
+    }
+
+    ASSERT_EQ(52, wordTree.size());
+    for (std::string first : { "a", "b" })
+    {
+        const auto predictions = wordTree.predict(first, 26);
+
+        ASSERT_EQ(26, predictions.size());
+        for (std::size_t i = 0; i < predictions.size(); ++i)
+        {
+            EXPECT_EQ(first + static_cast<char>('a' + i), predictions[i]);
+            EXPECT_TRUE(wordTree.find(predictions[i]));
+        }
+    }
+    ASSERT_FALSE(wordTree.find("c"));
+    ASSERT_FALSE(wordTree.find("a"));
+}
+
+TEST(CompactWordTree_Find, FindsSameWordsAsWordTree)
+{
+    WordTree wordTree;
+
+    wordTree.add("bounce");
+    wordTree.add("bound");
+    wordTree.add("boundaries");
+    wordTree.add("boundary");
+    wordTree.add("pounce");
+    wordTree.add("pound");
+    wordTree.add("zoo");
+
+    CompactWordTree compact(wordTree);
+
+    ASSERT_EQ(compact.size(), 7);
+    for (auto word : { "bounce", "bound", "boundaries", "boundary", "pounce", "pound", "zoo", "", "b", "boun", "boundar", "pounds", "zo", "zoos", "apple" })
+    {
+        EXPECT_EQ(wordTree.find(word), compact.find(word)) << word;
+    }
+}
+
+TEST(CompactWordTree_Find, CanFindWithNoWordsInTree)
+{
+    WordTree wordTree;
+    CompactWordTree compact(wordTree);
+
+    ASSERT_EQ(compact.size(), 0);
+    ASSERT_FALSE(compact.find("hello"));
+    ASSERT_FALSE(compact.find(""));
+    ASSERT_EQ(0, compact.predict("hello", 1).size());
+}
+
+TEST(CompactWordTree_Predict, PredictsSameAsWordTree)
+{
+    WordTree wordTree;
+
+    wordTree.add("zoo");
+    wordTree.add("acknowledges");
+    wordTree.add("acknowledging");
+    wordTree.add("acorn");
+    wordTree.add("acorns");
+    wordTree.add("acoustic");
+    wordTree.add("bounce");
+    wordTree.add("bound");
+    wordTree.add("boundaries");
+    wordTree.add("boundary");
+    wordTree.add("pounce");
+    wordTree.add("zebras");
+
+    CompactWordTree compact(wordTree);
+
+    for (auto partial : { "", "a", "ac", "aco", "acorn", "b", "bound", "p", "z", "x", "zoo" })
+    {
+        for (std::uint8_t howMany = 0; howMany < 12; ++howMany)
+        {
+            EXPECT_EQ(wordTree.predict(partial, howMany), compact.predict(partial, howMany)) << partial << " " << int(howMany);
+        }
+    }
+}
+
+TEST(CompactWordTree_Predict, SharesSuffixes)
+{
+    WordTree prefixes;
+    WordTree suffixes;
+
+    // A trie would store the second pair's common suffix twice; the graph
+    // stores it once, as it does the first pair's common prefix
+    prefixes.add("abcdefgh");
+    prefixes.add("abcdefgi");
+    suffixes.add("abcdefgh");
+    suffixes.add("bbcdefgh");
+
+    CompactWordTree compactPrefixes(prefixes);
+    CompactWordTree compactSuffixes(suffixes);
+
+    ASSERT_EQ(compactPrefixes.memoryUsage(), compactSuffixes.memoryUsage());
+    ASSERT_TRUE(compactSuffixes.find("bbcdefgh"));
+    ASSERT_FALSE(compactSuffixes.find("bbcdefgi"));
+    ASSERT_EQ(std::vector<std::string>{ "bbcdefgh" }, compactSuffixes.predict("bb", 5));
+}
@@ -1,44 +1,62 @@
 ﻿#include "WordTree.hpp"
 #include <queue>
 
+namespace
+{
+    // Sums the bits in pairs, then nibbles, then bytes, and the bytes with a
+    // multiply; compilers emit a popcount instruction for it where there is one
+    std::uint32_t countSetBits(std::uint32_t bits)
+    {
+        bits -= (bits >> 1) & 0x55555555;
+        bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+        return (bits * 0x01010101) >> 24;
+    }
+
+    // Log2 of the room a child list of count children has
+    std::size_t calcRoomClass(std::uint32_t count)
+    {
+        std::size_t roomClass = 0;
+        while ((std::uint32_t(1) << roomClass) < count)
+        {
+            ++roomClass;
+        }
+        return roomClass;
+    }
+}
+
 WordTree::WordTree()
 {
-    m_root = std::make_shared<TreeNode>();
+    m_nodes.emplace_back();
     m_size = 0;
 }
 
 void WordTree::add(std::string word)
 {
-    // Exit if word already inserted
-    if (find(word))
+    // Nothing to mark for an empty string
+    if (!word.length())
     {
         return;
     }
 
-    // Traverse
-    auto currNode = m_root;
+    // Traverse, making new nodes if necessary
+    std::uint32_t currNode = 0;
     for (size_t i = 0; i < word.length(); ++i)
     {
         size_t currIndex = calcLetterIndex(word[i]);
+        std::uint32_t child = getChild(currNode, currIndex);
+        currNode = child != NO_CHILD ? child : addChild(currNode, currIndex);
+    }
 
-        // Make new node if necessary
-        if (!currNode->children[currIndex])
-        {
-            currNode->children[currIndex] = std::make_shared<TreeNode>();
-        }
-
-        currNode = currNode->children[currIndex];
-
-        // Mark the last node as endOfWord
-        if (i == word.length() - 1)
-        {
-            currNode->endOfWord = true;
-            m_size++;
-        }
+    // Mark the last node as endOfWord, unless already inserted
+    if (!m_nodes[currNode].endOfWord)
+    {
+        m_nodes[currNode].endOfWord = true;
+        m_size++;
     }
 }
 
-bool WordTree::find(std::string word)
+bool WordTree::find(std::string word) const
 {
     // Return false on empty string
     if (!word.length())
@@ -46,29 +64,21 @@ bool WordTree::find(std::string word)
         return false;
     }
 
-    auto currNode = m_root;
+    std::uint32_t currNode = 0;
     for (size_t i = 0; i < word.length(); ++i)
     {
-        size_t currIndex = calcLetterIndex(word[i]);
-        currNode = currNode->children[currIndex];
+        currNode = getChild(currNode, calcLetterIndex(word[i]));
 
-        if (!currNode)
+        if (currNode == NO_CHILD)
         {
             return false;
         }
     }
 
-    if (currNode->endOfWord)
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return m_nodes[currNode].endOfWord;
 }
 
-std::vector<std::string> WordTree::predict(std::string partial, std::uint8_t howMany)
+std::vector<std::string> WordTree::predict(std::string partial, std::uint8_t howMany) const
 {
     std::vector<std::string> predictions;
 
@@ -79,14 +89,13 @@ std::vector<std::string> WordTree::predict(std::string partial, std::uint8_t how
     }
 
     // Find partial node
-    auto currNode = m_root;
+    std::uint32_t currNode = 0;
     for (size_t i = 0; i < partial.length(); ++i)
     {
-        size_t currIndex = calcLetterIndex(partial[i]);
-        currNode = currNode->children[currIndex];
+        currNode = getChild(currNode, calcLetterIndex(partial[i]));
 
         // Partial is not in tree, exit
-        if (!currNode)
+        if (currNode == NO_CHILD)
         {
             return predictions;
         }
@@ -100,27 +109,30 @@ std::vector<std::string> WordTree::predict(std::string partial, std::uint8_t how
         NodeWithString currNodeWithString = q.front();
         q.pop();
 
-        currNode = currNodeWithString.first;
-        auto currPartial = currNodeWithString.second;
-        for (size_t i = 0; i < currNode->children.size(); ++i)
+        const TreeNode& node = m_nodes[currNodeWithString.first];
+        const auto& currPartial = currNodeWithString.second;
+        std::uint32_t letters = node.letters;
+        for (std::uint32_t child = node.firstChild; letters; ++child)
         {
-            if (currNode->children[i])
-            {
-                auto newPartial = currPartial + indexToLetter(i);
+            // Lowest letter left, which is the next child in the list
+            std::uint32_t letter = countSetBits((letters & (0 - letters)) - 1);
+            letters &= letters - 1;
 
-                // Add prediction
-                if (currNode->children[i]->endOfWord)
-                {
-                    predictions.push_back(newPartial);
-                }
+            auto newPartial = currPartial + indexToLetter(letter);
+            std::uint32_t childNode = m_childLists[child];
+
+            // Add prediction
+            if (m_nodes[childNode].endOfWord)
+            {
+                predictions.push_back(newPartial);
+            }
 
-                // Add node to queue
-                q.emplace(currNode->children[i], newPartial);
+            // Add node to queue
+            q.emplace(childNode, newPartial);
 
-                if (q.size() == howMany)
-                {
-                    break;
-                }
+            if (q.size() == howMany)
+            {
+                break;
             }
         }
     }
@@ -128,17 +140,95 @@ std::vector<std::string> WordTree::predict(std::string partial, std::uint8_t how
     return predictions;
 }
 
-std::size_t WordTree::size()
+std::size_t WordTree::size() const
 {
     return m_size;
 }
 
-std::size_t WordTree::calcLetterIndex(char c)
+std::size_t WordTree::memoryUsage() const
+{
+    std::size_t bytes = sizeof(*this) + m_nodes.capacity() * sizeof(TreeNode) + m_childLists.capacity() * sizeof(std::uint32_t);
+    for (const auto& freeList : m_freeLists)
+    {
+        bytes += sizeof(freeList) + freeList.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+std::size_t WordTree::calcLetterIndex(char c) const
 {
     return static_cast<std::size_t>(c - 'a');
 }
 
-char WordTree::indexToLetter(std::size_t i)
+char WordTree::indexToLetter(std::size_t i) const
 {
     return static_cast<char>(i) + 'a';
+}
+
+std::uint32_t WordTree::getChild(std::uint32_t node, std::size_t index) const
+{
+    std::uint32_t letters = m_nodes[node].letters;
+    std::uint32_t bit = std::uint32_t(1) << index;
+    if (!(letters & bit))
+    {
+        return NO_CHILD;
+    }
+
+    // The child's place in the list is the number of letters before it
+    return m_childLists[m_nodes[node].firstChild + countSetBits(letters & (bit - 1))];
+}
+
+std::uint32_t WordTree::addChild(std::uint32_t node, std::size_t index)
+{
+    auto child = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    std::uint32_t letters = m_nodes[node].letters;
+    std::uint32_t bit = std::uint32_t(1) << index;
+    std::uint32_t count = countSetBits(letters);
+    std::uint32_t first = m_nodes[node].firstChild;
+
+    // A full list moves to a slot with twice the room, reusing a freed one if there is one
+    if (!count || count == (std::uint32_t(1) << calcRoomClass(count)))
+    {
+        std::size_t roomClass = count ? calcRoomClass(count) + 1 : 0;
+        if (m_freeLists.size() <= roomClass)
+        {
+            m_freeLists.resize(roomClass + 1);
+        }
+
+        std::uint32_t moved;
+        if (m_freeLists[roomClass].empty())
+        {
+            moved = static_cast<std::uint32_t>(m_childLists.size());
+            m_childLists.resize(m_childLists.size() + (std::size_t(1) << roomClass));
+        }
+        else
+        {
+            moved = m_freeLists[roomClass].back();
+            m_freeLists[roomClass].pop_back();
+        }
+
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            m_childLists[moved + i] = m_childLists[first + i];
+        }
+        if (count)
+        {
+            m_freeLists[roomClass - 1].push_back(first);
+        }
+        first = moved;
+        m_nodes[node].firstChild = first;
+    }
+
+    // Shift the children of later letters up to make room in letter order
+    std::uint32_t place = countSetBits(letters & (bit - 1));
+    for (std::uint32_t i = count; i > place; --i)
+    {
+        m_childLists[first + i] = m_childLists[first + i - 1];
+    }
+    m_childLists[first + place] = child;
+    m_nodes[node].letters = letters | bit;
+
+    return child;
 }
\ No newline at end of file
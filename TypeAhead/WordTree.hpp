@@ -5,9 +5,7 @@
 
 #pragma once
 
-#include <array>
 #include <cstdint>
-#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,17 +13,35 @@
 class WordTree
 {
   private:
+    // Reads the nodes to build its compact copy
+    friend class CompactWordTree;
+
+    // Nodes live in one array and refer to each other by index. A node's
+    // children are listed in letter order in m_childLists, from
+    // firstChild, one for each bit set in letters; child lists are given room
+    // for a power of two children and move to a larger slot when full.
     struct TreeNode
     {
+        std::uint32_t letters = 0;
+        std::uint32_t firstChild = 0;
         bool endOfWord = false;
-        std::array<std::shared_ptr<TreeNode>, 26> children;
     };
 
-    std::shared_ptr<TreeNode> m_root;
+    // The root is node 0, which is never a child, so 0 also means no child
+    static constexpr std::uint32_t NO_CHILD = 0;
+
+    std::vector<TreeNode> m_nodes;
+    std::vector<std::uint32_t> m_childLists;
+    // Free lists of child-list slots, indexed by log2 of slot capacity; each
+    // holds the start in m_childLists of slots left behind by moved lists
+    std::vector<std::vector<std::uint32_t>> m_freeLists;
     std::size_t m_size;
 
-    std::size_t calcLetterIndex(char c);
-    char indexToLetter(std::size_t i);
+    std::size_t calcLetterIndex(char c) const;
+    char indexToLetter(std::size_t i) const;
+    // Returns the node's child for the letter at index, or NO_CHILD
+    std::uint32_t getChild(std::uint32_t node, std::size_t index) const;
+    std::uint32_t addChild(std::uint32_t node, std::size_t index);
 
   public:
     WordTree();
@@ -33,11 +49,13 @@ class WordTree
     // Add word to tree
     void add(std::string word);
     // Returns true if word is in tree
-    bool find(std::string word);
+    bool find(std::string word) const;
     // Returns vector of howMany predictions given partial input
-    std::vector<std::string> predict(std::string partial, std::uint8_t howMany);
+    std::vector<std::string> predict(std::string partial, std::uint8_t howMany) const;
     // Returns number of words in tree
-    std::size_t size();
+    std::size_t size() const;
+    // Returns bytes held by the tree
+    std::size_t memoryUsage() const;
 
-    using NodeWithString = std::pair<std::shared_ptr<TreeNode>, std::string>;
+    using NodeWithString = std::pair<std::uint32_t, std::string>;
 };
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "CompactWordTree.hpp"
 #include "WordTree.hpp"
 #include "rlutil.h"
 
@@ -15,7 +16,11 @@ void displayPredictions(const std::string query, const std::vector<std::string>&
 
 int main()
 {
+    // Predictions come from a compact copy of the dictionary, once built
+    // the tree it was built from is freed
     auto wordTree = readDictionary("dictionary.txt");
+    CompactWordTree dictionary(*wordTree);
+    wordTree.reset();
 
     std::string query = "";
 
@@ -25,7 +30,7 @@ int main()
         updateQuery(query);
 
         std::uint8_t howMany = static_cast<std::uint8_t>(rlutil::trows()) - RESERVED_ROWS;
-        auto predictions = wordTree->predict(query, howMany);
+        auto predictions = dictionary.predict(query, howMany);
 
         displayPredictions(query, predictions);
     }